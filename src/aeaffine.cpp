@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeaffine.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aeAffineTransformT<T>::aeAffineTransformT() {
+    static const T identity[12] = {
+        T(1), T(0), T(0), T(0),
+        T(0), T(1), T(0), T(0),
+        T(0), T(0), T(1), T(0)
+    };
+    std::copy(identity, identity + 12, mMatrix);
+    updateFlags();
+}
+
+template <typename T>
+aeAffineTransformT<T>::aeAffineTransformT(T a, T b, T c, T d, T e, T f) {
+    const T matrix[12] = {
+        a,    b,    T(0), c,
+        d,    e,    T(0), f,
+        T(0), T(0), T(1), T(0)
+    };
+    std::copy(matrix, matrix + 12, mMatrix);
+    updateFlags();
+}
+
+template <typename T>
+aeAffineTransformT<T>::aeAffineTransformT(const T (&matrix)[12]) {
+    std::copy(matrix, matrix + 12, mMatrix);
+    updateFlags();
+}
+
+template <typename T>
+aeAffineTransformT<T>::aeAffineTransformT(
+    const aeAffineTransformT<T> &other
+): mIs2D(other.mIs2D), mInverse(std::atomic_load(&other.mInverse)) {
+    std::copy(other.mMatrix, other.mMatrix + 12, mMatrix);
+}
+
+template <typename T>
+aeAffineTransformT<T> &aeAffineTransformT<T>::operator = (const aeAffineTransformT<T> &other) {
+    if (this != &other) {
+        std::copy(other.mMatrix, other.mMatrix + 12, mMatrix);
+        mIs2D = other.mIs2D;
+        std::atomic_store(&mInverse, std::atomic_load(&other.mInverse));
+    }
+    return *this;
+}
+
+template <typename T>
+void aeAffineTransformT<T>::updateFlags() {
+    const T *a = mMatrix;
+    mIs2D = (a[2] == T(0) && a[6] == T(0) &&
+             a[8] == T(0) && a[9] == T(0) && a[10] == T(1) && a[11] == T(0));
+}
+
+template <typename T>
+aeAffineTransformT<T> aeAffineTransformT<T>::translation(T dx, T dy, T dz) {
+    const T matrix[12] = {
+        T(1), T(0), T(0), dx,
+        T(0), T(1), T(0), dy,
+        T(0), T(0), T(1), dz
+    };
+    return aeAffineTransformT<T>(matrix);
+}
+
+template <typename T>
+aeAffineTransformT<T> aeAffineTransformT<T>::scaling(T sx, T sy, T sz) {
+    const T matrix[12] = {
+        sx,   T(0), T(0), T(0),
+        T(0), sy,   T(0), T(0),
+        T(0), T(0), sz,   T(0)
+    };
+    return aeAffineTransformT<T>(matrix);
+}
+
+template <typename T>
+aeAffineTransformT<T> aeAffineTransformT<T>::rotation(double radians) {
+    T c = T(std::cos(radians)), s = T(std::sin(radians));
+    return aeAffineTransformT<T>(c, -s, T(0), s, c, T(0));
+}
+
+template <typename T>
+aeAffineTransformT<T> aeAffineTransformT<T>::then(const aeAffineTransformT<T> &next) const {
+    // next * this, treating both as 4x4 matrices with a bottom row of 0 0 0 1
+    const T *a = next.mMatrix, *b = mMatrix;
+    T matrix[12];
+
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            matrix[r * 4 + c] = a[r * 4 + 0] * b[0 * 4 + c] +
+                                a[r * 4 + 1] * b[1 * 4 + c] +
+                                a[r * 4 + 2] * b[2 * 4 + c] +
+                                ((c == 3) ? a[r * 4 + 3] : T(0));
+        }
+    }
+
+    return aeAffineTransformT<T>(matrix);
+}
+
+template <typename T>
+double aeAffineTransformT<T>::determinant() const {
+    const T *a = mMatrix;
+    return double(a[0]) * (double(a[5]) * a[10] - double(a[6]) * a[9]) -
+           double(a[1]) * (double(a[4]) * a[10] - double(a[6]) * a[8]) +
+           double(a[2]) * (double(a[4]) * a[9] - double(a[5]) * a[8]);
+}
+
+template <typename T>
+const aeAffineTransformT<T> &aeAffineTransformT<T>::inverse() const {
+    // Racing threads may each compute the inverse; whichever is stored
+    // first is kept, and the results are identical anyway.
+    std::shared_ptr< const aeAffineTransformT<T> > cached = std::atomic_load(&mInverse);
+    if (cached) {
+        return *cached;
+    }
+
+    double det = determinant();
+
+    if (det == 0.0 || !std::isfinite(det)) {
+        throw aeArgumentError("aeAffineTransform: matrix is singular");
+    }
+
+    const T *a = mMatrix;
+    double m[9] = {
+        (double(a[5]) * a[10] - double(a[6]) * a[9]) / det,
+        (double(a[2]) * a[9] - double(a[1]) * a[10]) / det,
+        (double(a[1]) * a[6] - double(a[2]) * a[5]) / det,
+        (double(a[6]) * a[8] - double(a[4]) * a[10]) / det,
+        (double(a[0]) * a[10] - double(a[2]) * a[8]) / det,
+        (double(a[2]) * a[4] - double(a[0]) * a[6]) / det,
+        (double(a[4]) * a[9] - double(a[5]) * a[8]) / det,
+        (double(a[1]) * a[8] - double(a[0]) * a[9]) / det,
+        (double(a[0]) * a[5] - double(a[1]) * a[4]) / det
+    };
+
+    // The translation is undone by the inverse linear part: t' = -M^-1 t
+    T matrix[12];
+
+    for (int r = 0; r < 3; ++r) {
+        matrix[r * 4 + 0] = T(m[r * 3 + 0]);
+        matrix[r * 4 + 1] = T(m[r * 3 + 1]);
+        matrix[r * 4 + 2] = T(m[r * 3 + 2]);
+        matrix[r * 4 + 3] = T(-(m[r * 3 + 0] * a[3] + m[r * 3 + 1] * a[7] + m[r * 3 + 2] * a[11]));
+    }
+
+    std::shared_ptr< const aeAffineTransformT<T> > computed =
+        std::make_shared< aeAffineTransformT<T> >(matrix);
+    std::shared_ptr< const aeAffineTransformT<T> > expected;
+    if (!std::atomic_compare_exchange_strong(&mInverse, &expected, computed)) {
+        return *expected;
+    }
+    return *computed;
+}
+
+template <typename T>
+void aeAffineTransformT<T>::apply(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const {
+    const T a00 = mMatrix[0], a01 = mMatrix[1], a02 = mMatrix[2], a03 = mMatrix[3];
+    const T a10 = mMatrix[4], a11 = mMatrix[5], a12 = mMatrix[6], a13 = mMatrix[7];
+    const T a20 = mMatrix[8], a21 = mMatrix[9], a22 = mMatrix[10], a23 = mMatrix[11];
+
+    if (mIs2D) {
+        for (std::size_t i = 0; i < count; ++i) {
+            T x = in[i].x, y = in[i].y;
+            out[i].x = a00 * x + a01 * y + a03;
+            out[i].y = a10 * x + a11 * y + a13;
+            out[i].z = in[i].z;
+            out[i].m = in[i].m;
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            T x = in[i].x, y = in[i].y, z = in[i].z;
+            out[i].x = a00 * x + a01 * y + a02 * z + a03;
+            out[i].y = a10 * x + a11 * y + a12 * z + a13;
+            out[i].z = a20 * x + a21 * y + a22 * z + a23;
+            out[i].m = in[i].m;
+        }
+    }
+}
+
+template <typename T>
+void aeAffineTransformT<T>::apply(
+    const T *in,
+    T *out,
+    std::size_t count,
+    unsigned int stride,
+    bool hasZ
+) const {
+    if (stride < 2 || (hasZ && stride < 3)) {
+        throw aeArgumentError("aeAffineTransform: stride too small");
+    }
+
+    const T a00 = mMatrix[0], a01 = mMatrix[1], a02 = mMatrix[2], a03 = mMatrix[3];
+    const T a10 = mMatrix[4], a11 = mMatrix[5], a12 = mMatrix[6], a13 = mMatrix[7];
+    const T a20 = mMatrix[8], a21 = mMatrix[9], a22 = mMatrix[10], a23 = mMatrix[11];
+
+    if (in != out) {
+        // Copy the values not written below (M, or Z for 2D transforms)
+        std::copy(in, in + count * stride, out);
+    }
+
+    if (hasZ && !mIs2D) {
+        for (std::size_t i = 0; i < count * stride; i += stride) {
+            T x = in[i], y = in[i + 1], z = in[i + 2];
+            out[i] = a00 * x + a01 * y + a02 * z + a03;
+            out[i + 1] = a10 * x + a11 * y + a12 * z + a13;
+            out[i + 2] = a20 * x + a21 * y + a22 * z + a23;
+        }
+    } else if (stride == 2) {
+        // Fixed stride so the compiler can vectorize the common xy case
+        for (std::size_t i = 0; i < count * 2; i += 2) {
+            T x = in[i], y = in[i + 1];
+            out[i] = a00 * x + a01 * y + a03;
+            out[i + 1] = a10 * x + a11 * y + a13;
+        }
+    } else {
+        for (std::size_t i = 0; i < count * stride; i += stride) {
+            T x = in[i], y = in[i + 1];
+            out[i] = a00 * x + a01 * y + a03;
+            out[i + 1] = a10 * x + a11 * y + a13;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template class aeAffineTransformT<double>;
+template class aeAffineTransformT<float>;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
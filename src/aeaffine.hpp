@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEAFFINE_HPP_INCLUDE_GUARD
+#define AEAFFINE_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeom.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note An affine transform of x, y and z, stored as the top three rows of a
+//  4x4 matrix:
+//
+//      | x' |   | a00 a01 a02 a03 |   | x |
+//      | y' | = | a10 a11 a12 a13 | * | y |
+//      | z' |   | a20 a21 a22 a23 |   | z |
+//                                     | 1 |
+//
+//  Transforms that leave z alone are flagged as two-dimensional and skip it
+//  entirely.  M values are never changed.  The batch apply() functions work
+//  on contiguous buffers, in place or not, with the coefficients held in
+//  locals so that the loops vectorize.
+
+template <typename T>
+class aeAffineTransformT {
+public:
+    /**
+     * Identity transform.
+     */
+    aeAffineTransformT();
+
+    /**
+     * Two-dimensional transform: x' = a x + b y + c, y' = d x + e y + f.
+     */
+    aeAffineTransformT(T a, T b, T c, T d, T e, T f);
+
+    /**
+     * Three-dimensional transform from the twelve coefficients in row order.
+     */
+    explicit aeAffineTransformT(const T (&matrix)[12]);
+
+    aeAffineTransformT(const aeAffineTransformT<T> &other);
+
+    aeAffineTransformT<T> &operator = (const aeAffineTransformT<T> &other);
+
+    static aeAffineTransformT<T> translation(T dx, T dy, T dz = T());
+    static aeAffineTransformT<T> scaling(T sx, T sy, T sz = T(1));
+    static aeAffineTransformT<T> rotation(double radians);
+
+    /**
+     * Coefficient at the given row (0-2) and column (0-3).
+     */
+    T operator () (unsigned int row, unsigned int col) const {
+        return mMatrix[row * 4 + col];
+    }
+
+    bool is2D() const { return mIs2D; }
+
+    /**
+     * Returns the transform applying this one, then the other.
+     */
+    aeAffineTransformT<T> then(const aeAffineTransformT<T> &next) const;
+
+    /**
+     * Composition: (a * b) applies b first, then a.
+     */
+    aeAffineTransformT<T> operator * (const aeAffineTransformT<T> &rhs) const {
+        return rhs.then(*this);
+    }
+
+    aeAffineTransformT<T> &operator *= (const aeAffineTransformT<T> &rhs) {
+        return *this = *this * rhs;
+    }
+
+    /**
+     * Returns the inverse transform.  Throws aeArgumentError if the matrix
+     * is singular.  The inverse is computed once and cached; this is safe
+     * to call from several threads on a shared transform.
+     */
+    const aeAffineTransformT<T> &inverse() const;
+
+    double determinant() const;
+
+    aePointT<T> apply(const aePointT<T> &p) const {
+        const T *a = mMatrix;
+        if (mIs2D) {
+            return aePointT<T>(
+                a[0] * p.x + a[1] * p.y + a[3],
+                a[4] * p.x + a[5] * p.y + a[7],
+                p.z, p.m
+            );
+        }
+        return aePointT<T>(
+            a[0] * p.x + a[1] * p.y + a[2] * p.z + a[3],
+            a[4] * p.x + a[5] * p.y + a[6] * p.z + a[7],
+            a[8] * p.x + a[9] * p.y + a[10] * p.z + a[11],
+            p.m
+        );
+    }
+
+    aePointT<T> operator () (const aePointT<T> &p) const {
+        return apply(p);
+    }
+
+    /**
+     * Transforms count points; in and out may be the same buffer.
+     */
+    void apply(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const;
+
+    /**
+     * Transforms count points stored as interleaved coordinates, stride
+     * values apart (2 for xy, 3 for xyz or xym, 4 for xyzm).  Z is taken to be
+     * the third value when hasZ is set, and zero otherwise.  In and out may be
+     * the same buffer.
+     */
+    void apply(
+        const T *in,
+        T *out,
+        std::size_t count,
+        unsigned int stride,
+        bool hasZ
+    ) const;
+
+    void apply(std::vector< aePointT<T> > &points) const {
+        apply(points.data(), points.data(), points.size());
+    }
+
+    void apply(aeGeometryT<T> &geometry) const {
+        apply(geometry.points());
+    }
+
+private:
+    void updateFlags();
+
+    T mMatrix[12];
+    bool mIs2D;
+    mutable std::shared_ptr< const aeAffineTransformT<T> > mInverse;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aeAffineTransformT<double> aeAffineTransform;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEAFFINE_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
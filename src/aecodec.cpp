@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aecodec.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    inline uint64_t zigzag(int64_t v) {
+        return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+    }
+
+    inline int64_t unzigzag(uint64_t u) {
+        return int64_t(u >> 1) ^ -int64_t(u & 1);
+    }
+
+    inline void put(uint64_t u, std::vector<uint8_t> &buffer) {
+        while (u >= 0x80) {
+            buffer.push_back(uint8_t(u) | 0x80);
+            u >>= 7;
+        }
+        buffer.push_back(uint8_t(u));
+    }
+
+    // Reads one unsigned varint; the caller checks that data < end
+    inline uint64_t get(const uint8_t *&data, const uint8_t *end) {
+        uint64_t u = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            if (data == end) {
+                throw aeStreamError("truncated varint");
+            }
+            uint8_t b = *data++;
+            u |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) {
+                return u;
+            }
+        }
+        throw aeStreamError("malformed varint");
+    }
+
+    uint64_t readVarint(aeInputStream &stream) {
+        uint64_t u = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            uint8_t b;
+            stream.read(b);
+            u |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) {
+                return u;
+            }
+        }
+        throw aeStreamError("malformed varint");
+    }
+
+    unsigned int dimensions(int type) {
+        return 2 + ((type & aeGeometry::HasZ) ? 1 : 0) + ((type & aeGeometry::HasM) ? 1 : 0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void aeEncodeVarints(const int64_t *values, std::size_t count, std::vector<uint8_t> &buffer) {
+    for (std::size_t i = 0; i < count; ++i) {
+        put(zigzag(values[i]), buffer);
+    }
+}
+
+std::size_t aeDecodeVarints(const uint8_t *data, std::size_t size, int64_t *values, std::size_t count) {
+    const uint8_t *p = data, *end = data + size;
+    std::size_t i = 0;
+
+    while (i < count) {
+        // Fast path: eight single-byte varints in a row can be decoded at
+        // once, testing all of their continuation bits with one mask
+        if (count - i >= 8 && end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            if (!(word & UINT64_C(0x8080808080808080))) {
+                for (int k = 0; k < 8; ++k) {
+                    values[i + k] = unzigzag(p[k]);
+                }
+                p += 8;
+                i += 8;
+                continue;
+            }
+        }
+
+        values[i++] = unzigzag(get(p, end));
+    }
+
+    return p - data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aeGeometryCodecT<T>::aeGeometryCodecT(double precision):
+    mPrecision(precision), mScale(1.0 / precision) {
+    if (!(precision > 0.0) || !std::isfinite(mScale)) {
+        throw aeArgumentError("aeGeometryCodec: precision must be positive");
+    }
+}
+
+template <typename T>
+void aeGeometryCodecT<T>::encode(const aeGeometryT<T> &geometry, std::vector<uint8_t> &buffer) const {
+    const std::vector< aePointT<T> > &points = geometry.points();
+    const typename aeGeometryT<T>::Parts &parts = geometry.parts();
+    const typename aeGeometryT<T>::PartTypes &partTypes = geometry.partTypes();
+
+    bool hasZ = geometry.hasZ(), hasM = geometry.hasM();
+    unsigned int dims = dimensions(geometry.type());
+
+    std::vector<uint8_t> body;
+    body.reserve(8 + parts.size() + partTypes.size() + points.size() * dims * 2);
+
+    put(uint64_t(geometry.type()), body);
+
+    put(parts.size(), body);
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        put(parts[i] - (i > 0 ? parts[i - 1] : 0), body);
+    }
+
+    put(partTypes.size(), body);
+    for (std::size_t i = 0; i < partTypes.size(); ++i) {
+        put(uint64_t(partTypes[i]), body);
+    }
+
+    put(points.size(), body);
+
+    const double limit = double(std::numeric_limits<int64_t>::max() / 4);
+    int64_t last[4] = { 0, 0, 0, 0 };
+
+    for (const aePointT<T> &p : points) {
+        T c[4];
+        unsigned int n = 0;
+        c[n++] = p.x;
+        c[n++] = p.y;
+        if (hasZ) { c[n++] = p.z; }
+        if (hasM) { c[n++] = p.m; }
+
+        for (unsigned int k = 0; k < dims; ++k) {
+            double v = std::round(double(c[k]) * mScale);
+            if (!(std::abs(v) < limit)) {
+                throw aeArgumentError("aeGeometryCodec: coordinate out of range");
+            }
+            int64_t q = int64_t(v);
+            put(zigzag(q - last[k]), body);
+            last[k] = q;
+        }
+    }
+
+    put(body.size(), buffer);
+    buffer.insert(buffer.end(), body.begin(), body.end());
+}
+
+template <typename T>
+void aeGeometryCodecT<T>::encode(const aeGeometryT<T> &geometry, aeOutputStream &stream) const {
+    std::vector<uint8_t> buffer;
+    encode(geometry, buffer);
+
+    if (stream.write(buffer.data(), buffer.size()) < int64_t(buffer.size())) {
+        throw aeStreamError("incomplete write");
+    }
+}
+
+template <typename T>
+std::size_t aeGeometryCodecT<T>::decode(
+    const uint8_t *data,
+    std::size_t size,
+    aeGeometryT<T> &geometry
+) const {
+    typedef aeGeometryT<T> G;
+
+    const uint8_t *p = data, *end = data + size;
+
+    uint64_t length = get(p, end);
+    if (length > uint64_t(end - p)) {
+        throw aeStreamError("truncated geometry");
+    }
+    end = p + length;
+
+    uint64_t type = get(p, end);
+    if ((type & ~uint64_t(G::HasZ | G::HasM)) > uint64_t(G::Triangle)) {
+        throw aeStreamError("unknown geometry type");
+    }
+
+    G result = G(typename G::Type(type));
+
+    // Every count is bounded by the bytes left, since each entry takes at
+    // least one byte; this rejects corrupt counts before allocating
+    uint64_t nParts = get(p, end);
+    if (nParts > uint64_t(end - p)) {
+        throw aeStreamError("corrupt geometry");
+    }
+    // Offsets are stored as non-negative deltas, so they only need checking
+    // for overflow here and against the point count below
+    result.parts().resize(nParts);
+    for (uint64_t i = 0, offset = 0; i < nParts; ++i) {
+        uint64_t delta = get(p, end);
+        if (delta > std::numeric_limits<unsigned int>::max() - offset) {
+            throw aeStreamError("corrupt geometry");
+        }
+        offset += delta;
+        result.parts()[i] = (unsigned int)(offset);
+    }
+
+    uint64_t nTypes = get(p, end);
+    if (nTypes > uint64_t(end - p)) {
+        throw aeStreamError("corrupt geometry");
+    }
+    result.partTypes().resize(nTypes);
+    for (uint64_t i = 0; i < nTypes; ++i) {
+        uint64_t partType = get(p, end);
+        if (partType != uint64_t(G::LineString) && partType != uint64_t(G::CircularString)) {
+            throw aeStreamError("corrupt geometry");
+        }
+        result.partTypes()[i] = typename G::Type(partType);
+    }
+
+    unsigned int dims = dimensions(int(type));
+    bool hasZ = (type & G::HasZ) != 0, hasM = (type & G::HasM) != 0;
+
+    uint64_t nPoints = get(p, end);
+    if (nPoints > uint64_t(end - p) / dims ||
+        (nParts > 0 && result.parts().back() > nPoints)) {
+        throw aeStreamError("corrupt geometry");
+    }
+
+    std::vector<int64_t> deltas(nPoints * dims);
+    p += aeDecodeVarints(p, end - p, deltas.data(), deltas.size());
+
+    typename G::Points &points = result.points();
+    points.resize(nPoints);
+
+    // The encoder keeps every coordinate below this in magnitude, so no
+    // valid delta can take the running value past it
+    const int64_t limit = std::numeric_limits<int64_t>::max() / 4;
+
+    int64_t last[4] = { 0, 0, 0, 0 };
+    const int64_t *d = deltas.data();
+
+    for (uint64_t i = 0; i < nPoints; ++i) {
+        double c[4];
+        for (unsigned int k = 0; k < dims; ++k) {
+            int64_t delta = *d++;
+            if (delta > 2 * limit || delta < -2 * limit) {
+                throw aeStreamError("corrupt geometry");
+            }
+            last[k] += delta;
+            if (last[k] >= limit || last[k] <= -limit) {
+                throw aeStreamError("corrupt geometry");
+            }
+            c[k] = double(last[k]) * mPrecision;
+        }
+
+        aePointT<T> &q = points[i];
+        unsigned int n = 0;
+        q.x = aeCoordTraitsT<T>::fromReal(c[n++]);
+        q.y = aeCoordTraitsT<T>::fromReal(c[n++]);
+        if (hasZ) { q.z = aeCoordTraitsT<T>::fromReal(c[n++]); }
+        if (hasM) { q.m = aeCoordTraitsT<T>::fromReal(c[n++]); }
+    }
+
+    if (p != end) {
+        throw aeStreamError("corrupt geometry");
+    }
+
+    geometry = result;
+    return end - data;
+}
+
+template <typename T>
+aeGeometryT<T> aeGeometryCodecT<T>::decode(aeInputStream &stream) const {
+    uint64_t length = readVarint(stream);
+
+    int64_t remaining = stream.length() - stream.tell();
+    if (remaining >= 0 && length > uint64_t(remaining)) {
+        throw aeStreamError("truncated geometry");
+    }
+
+    // Re-encode the length so the record can be decoded from one buffer
+    std::vector<uint8_t> buffer;
+    put(length, buffer);
+
+    std::size_t header = buffer.size();
+    buffer.resize(header + length);
+
+    if (stream.read(buffer.data() + header, length) < int64_t(length)) {
+        throw aeStreamError("incomplete read");
+    }
+
+    aeGeometryT<T> geometry(aeGeometryT<T>::Geometry);
+    decode(buffer.data(), buffer.size(), geometry);
+    return geometry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template class aeGeometryCodecT<double>;
+template class aeGeometryCodecT<float>;
+template class aeGeometryCodecT<int32_t>;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
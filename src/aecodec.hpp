@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AECODEC_HPP_INCLUDE_GUARD
+#define AECODEC_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeom.hpp"
+#include "aestream.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Compact binary encoding of geometries.  Coordinates are rounded to a
+//  fixed precision, each stored as the difference from the same coordinate
+//  of the previous point, zigzag-mapped so small negative differences stay
+//  small, and written as LEB128 varints (7 bits per byte, high bit set on
+//  all but the last byte).  Smooth data at a sensible precision typically
+//  needs one or two bytes per coordinate.
+//
+//  A record is the byte length of its body followed by the body: the type,
+//  the part offsets, the part types, the point count and the coordinates,
+//  x and y plus z and m when the type has them.  The precision is not
+//  stored; data must be decoded with the precision it was encoded with.
+
+/**
+ * Appends values to a buffer as zigzag varints.
+ */
+void aeEncodeVarints(const int64_t *values, std::size_t count, std::vector<uint8_t> &buffer);
+
+/**
+ * Decodes count zigzag varints from a buffer, returning the number of bytes
+ * consumed.  Throws aeStreamError if the buffer ends early or a value is
+ * malformed.
+ */
+std::size_t aeDecodeVarints(const uint8_t *data, std::size_t size, int64_t *values, std::size_t count);
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class aeGeometryCodecT {
+public:
+    /**
+     * Creates a codec storing coordinates to the given precision, in
+     * coordinate units (e.g. 1e-7 degrees, or 0.001 metres).
+     */
+    explicit aeGeometryCodecT(double precision = 1e-7);
+
+    double precision() const { return mPrecision; }
+
+    void encode(const aeGeometryT<T> &geometry, std::vector<uint8_t> &buffer) const;
+    void encode(const aeGeometryT<T> &geometry, aeOutputStream &stream) const;
+
+    /**
+     * Decodes one record from a buffer, returning the number of bytes used.
+     */
+    std::size_t decode(const uint8_t *data, std::size_t size, aeGeometryT<T> &geometry) const;
+    aeGeometryT<T> decode(aeInputStream &stream) const;
+
+private:
+    double mPrecision;
+    double mScale;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aeGeometryCodecT<double> aeGeometryCodec;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AECODEC_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AECOORD_HPP_INCLUDE_GUARD
+#define AECOORD_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeconst.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 aeInt128;
+#define AE_HAS_INT128 1
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Describes how a coordinate type behaves in computation.  Real is the
+//  type of derived measures (area, centroid), and Wide is the accumulator for
+//  sums of coordinate products.  Floating-point coordinates use themselves for
+//  both; 32-bit integer coordinates accumulate in 128-bit integers, so area
+//  and centroid sums are exact, and report derived measures as double.
+
+template <typename T, bool Integer = std::numeric_limits<T>::is_integer>
+struct aeCoordTraitsT {
+    typedef T Real;
+    typedef T Wide;
+
+    /**
+     * Initial bounds of an empty extent.
+     */
+    static T emptyMin() { return T(aeNaN); }
+    static T emptyMax() { return T(aeNaN); }
+
+    /**
+     * Converts a computed value back to a coordinate.
+     */
+    static T fromReal(double r) { return T(r); }
+};
+
+template <typename T>
+struct aeCoordTraitsT<T, true> {
+    typedef double Real;
+#if defined(AE_HAS_INT128)
+    typedef aeInt128 Wide;
+#else
+    typedef long double Wide;
+#endif
+
+    static T emptyMin() { return std::numeric_limits<T>::max(); }
+    static T emptyMax() { return std::numeric_limits<T>::lowest(); }
+
+    static T fromReal(double r) {
+        if (!(r > double(std::numeric_limits<T>::lowest()))) {
+            return std::numeric_limits<T>::lowest();
+        }
+        if (!(r < double(std::numeric_limits<T>::max()))) {
+            return std::numeric_limits<T>::max();
+        }
+        return T(std::llround(r));
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Interpolates between two points, rounding to the nearest representable
+ * coordinate.
+ */
+template <typename T>
+aePointT<T> aeLerp(const aePointT<T> &a, const aePointT<T> &b, double t) {
+    typedef aeCoordTraitsT<T> Traits;
+    return aePointT<T>(
+        Traits::fromReal(double(a.x) + (double(b.x) - double(a.x)) * t),
+        Traits::fromReal(double(a.y) + (double(b.y) - double(a.y)) * t),
+        Traits::fromReal(double(a.z) + (double(b.z) - double(a.z)) * t),
+        Traits::fromReal(double(a.m) + (double(b.m) - double(a.m)) * t)
+    );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AECOORD_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aedatum.hpp"
+#include "aeconst.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+static constexpr double degsToRads = aePi / 180.0;
+static constexpr double radsToDegs = 180.0 / aePi;
+static constexpr double secsToRads = aePi / (180.0 * 3600.0);
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeDatum::aeDatum(
+    const std::string &name,
+    double a,
+    double f,
+    double dx, double dy, double dz,
+    double rx, double ry, double rz,
+    double ds
+): mName(name), mA(a), mF(f) {
+    if (!(a > 0.0) || !(f >= 0.0 && f < 1.0)) {
+        throw aeArgumentError("aeDatum: invalid ellipsoid");
+    }
+
+    mB = a * (1.0 - f);
+    mE2 = f * (2.0 - f);
+    mEp2B = mE2 / (1.0 - mE2) * mB;
+
+    // position vector convention: X' = T + (1 + s) R X
+    double s = 1.0 + ds * 1e-6;
+    rx *= secsToRads;
+    ry *= secsToRads;
+    rz *= secsToRads;
+
+    const double matrix[12] = {
+        s,       -s * rz,  s * ry, dx,
+        s * rz,   s,      -s * rx, dy,
+       -s * ry,   s * rx,  s,      dz
+    };
+    mToWGS84 = aeAffineTransform(matrix);
+}
+
+aeDatum::aeDatum(
+    const std::string &name,
+    double a,
+    double f,
+    const std::shared_ptr<const aeGridShift> &grid
+): aeDatum(name, a, f) {
+    if (!grid) {
+        throw aeArgumentError("aeDatum: null grid shift");
+    }
+    mGrid = grid;
+}
+
+const aeDatum &aeDatum::wgs84() {
+    static const aeDatum datum("WGS 84", 6378137.0, 1.0 / 298.257223563);
+    return datum;
+}
+
+const aeDatum &aeDatum::etrs89() {
+    static const aeDatum datum("ETRS89", 6378137.0, 1.0 / 298.257222101);
+    return datum;
+}
+
+const aeDatum &aeDatum::nad83() {
+    static const aeDatum datum("NAD83", 6378137.0, 1.0 / 298.257222101);
+    return datum;
+}
+
+const aeDatum &aeDatum::nad27() {
+    static const aeDatum datum("NAD27", 6378206.4, 1.0 / 294.978698214,
+        -8.0, 160.0, 176.0);
+    return datum;
+}
+
+const aeDatum &aeDatum::ed50() {
+    static const aeDatum datum("ED50", 6378388.0, 1.0 / 297.0,
+        -87.0, -98.0, -121.0);
+    return datum;
+}
+
+const aeDatum &aeDatum::osgb36() {
+    static const aeDatum datum("OSGB 1936", 6377563.396, 1.0 / 299.3249646,
+        446.448, -125.157, 542.06, 0.15, 0.247, 0.842, -20.489);
+    return datum;
+}
+
+bool aeDatum::isWGS84() const {
+    const aeDatum &w = wgs84();
+    if (mGrid) {
+        return false;
+    }
+    for (unsigned int r = 0; r < 3; ++r) {
+        for (unsigned int c = 0; c < 4; ++c) {
+            if (mToWGS84(r, c) != ((r == c) ? 1.0 : 0.0)) {
+                return false;
+            }
+        }
+    }
+    return mA == w.mA && mF == w.mF;
+}
+
+void aeDatum::toGeocentric(double lon, double lat, double h, double &x, double &y, double &z) const {
+    double sl = std::sin(degsToRads * lon), cl = std::cos(degsToRads * lon);
+    double sp = std::sin(degsToRads * lat), cp = std::cos(degsToRads * lat);
+    double n = mA / std::sqrt(1.0 - mE2 * sp * sp);
+    x = (n + h) * cp * cl;
+    y = (n + h) * cp * sl;
+    z = (n * (1.0 - mE2) + h) * sp;
+}
+
+/*
+ * Bowring's method; two iterations are accurate to well under a micrometre
+ * for points within a few hundred kilometres of the surface.
+ */
+void aeDatum::fromGeocentric(double x, double y, double z, double &lon, double &lat, double &h) const {
+    double p = std::hypot(x, y);
+    double beta = std::atan2(z, (1.0 - mF) * p);
+    double phi = 0.0;
+
+    for (int i = 0; i < 2; ++i) {
+        double sb = std::sin(beta), cb = std::cos(beta);
+        phi = std::atan2(z + mEp2B * sb * sb * sb, p - mE2 * mA * cb * cb * cb);
+        beta = std::atan2((1.0 - mF) * std::sin(phi), std::cos(phi));
+    }
+
+    double sp = std::sin(phi), cp = std::cos(phi);
+    lon = radsToDegs * std::atan2(y, x);
+    lat = radsToDegs * phi;
+    h = p * cp + z * sp - mA * std::sqrt(1.0 - mE2 * sp * sp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeDatumShift::aeDatumShift(
+    const aeDatum &source,
+    const aeDatum &target
+): mSource(source.grid() ? aeDatum::wgs84() : source),
+   mTarget(target.grid() ? aeDatum::wgs84() : target),
+   mSourceGrid(source.grid()),
+   mTargetGrid(target.grid()) {
+    if (mSourceGrid && mSourceGrid == mTargetGrid &&
+        source.semiMajorAxis() == target.semiMajorAxis() &&
+        source.flattening() == target.flattening()) {
+        mSourceGrid.reset();
+        mTargetGrid.reset();
+    }
+
+    aeAffineTransform m = mSource.toWGS84().then(mTarget.toWGS84().inverse());
+
+    mHelmertIdentity = (mSource.semiMajorAxis() == mTarget.semiMajorAxis() &&
+                        mSource.flattening() == mTarget.flattening());
+
+    for (unsigned int r = 0; r < 3; ++r) {
+        for (unsigned int c = 0; c < 4; ++c) {
+            mMatrix[r * 4 + c] = m(r, c);
+            mHelmertIdentity = mHelmertIdentity && (m(r, c) == ((r == c) ? 1.0 : 0.0));
+        }
+    }
+
+    mIdentity = mHelmertIdentity && !mSourceGrid && !mTargetGrid;
+}
+
+void aeDatumShift::apply(double &lon, double &lat, double &h) const {
+    if (mIdentity) {
+        return;
+    }
+
+    if (mSourceGrid) {
+        mSourceGrid->apply(lon, lat);
+    }
+
+    if (!mHelmertIdentity) {
+        const double *a = mMatrix;
+        double x, y, z;
+        mSource.toGeocentric(lon, lat, h, x, y, z);
+        mTarget.fromGeocentric(
+            a[0] * x + a[1] * y + a[2] * z + a[3],
+            a[4] * x + a[5] * y + a[6] * z + a[7],
+            a[8] * x + a[9] * y + a[10] * z + a[11],
+            lon, lat, h
+        );
+    }
+
+    if (mTargetGrid) {
+        mTargetGrid->inverse(lon, lat);
+    }
+}
+
+template <typename T>
+void aeDatumShift::apply(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const {
+    if (mIdentity) {
+        if (in != out) {
+            std::copy(in, in + count, out);
+        }
+        return;
+    }
+
+    if (mSourceGrid) {
+        mSourceGrid->apply(in, out, count);
+        in = out;
+    }
+
+    if (mHelmertIdentity) {
+        if (in != out) {
+            std::copy(in, in + count, out);
+        }
+        if (mTargetGrid) {
+            mTargetGrid->inverse(out, out, count);
+        }
+        return;
+    }
+
+    const aeDatum &source = mSource, &target = mTarget;
+    const double a00 = mMatrix[0], a01 = mMatrix[1], a02 = mMatrix[2],  a03 = mMatrix[3];
+    const double a10 = mMatrix[4], a11 = mMatrix[5], a12 = mMatrix[6],  a13 = mMatrix[7];
+    const double a20 = mMatrix[8], a21 = mMatrix[9], a22 = mMatrix[10], a23 = mMatrix[11];
+
+    for (std::size_t i = 0; i < count; ++i) {
+        double x, y, z, lon, lat, h;
+        T m = in[i].m;
+        source.toGeocentric(in[i].x, in[i].y, in[i].z, x, y, z);
+        target.fromGeocentric(
+            a00 * x + a01 * y + a02 * z + a03,
+            a10 * x + a11 * y + a12 * z + a13,
+            a20 * x + a21 * y + a22 * z + a23,
+            lon, lat, h
+        );
+        out[i] = aePointT<T>(lon, lat, h, m);
+    }
+
+    if (mTargetGrid) {
+        mTargetGrid->inverse(out, out, count);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template void aeDatumShift::apply<double>(const aePointT<double> *, aePointT<double> *, std::size_t) const;
+template void aeDatumShift::apply<float>(const aePointT<float> *, aePointT<float> *, std::size_t) const;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
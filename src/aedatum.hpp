@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEDATUM_HPP_INCLUDE_GUARD
+#define AEDATUM_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeaffine.hpp"
+#include "aegrid.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A geodetic datum: an ellipsoid plus the seven-parameter Helmert
+//  transformation taking its geocentric (ECEF) coordinates to WGS 84, in the
+//  position vector convention used by EPSG and by PROJ's +towgs84 (translations
+//  in metres, rotations in arc-seconds, scale in parts per million).
+//
+//  A datum may instead be tied to WGS 84 by an NTv2 grid shift, which takes
+//  its geodetic coordinates to those of the grid's target datum.  The target
+//  is taken to be WGS 84, as ETRS89, NAD83 and GDA94 are to within a metre.
+//
+//  Geodetic coordinates are (longitude, latitude) in degrees with ellipsoidal
+//  height in metres; geocentric coordinates are in metres.
+
+class aeDatum {
+public:
+    aeDatum(
+        const std::string &name,
+        double a,
+        double f,
+        double dx = 0.0, double dy = 0.0, double dz = 0.0,
+        double rx = 0.0, double ry = 0.0, double rz = 0.0,
+        double ds = 0.0
+    );
+
+    aeDatum(
+        const std::string &name,
+        double a,
+        double f,
+        const std::shared_ptr<const aeGridShift> &grid
+    );
+
+    static const aeDatum &wgs84();
+    static const aeDatum &etrs89();
+    static const aeDatum &nad83();
+    static const aeDatum &nad27();
+    static const aeDatum &ed50();
+    static const aeDatum &osgb36();
+
+    const std::string &name() const { return mName; }
+    double semiMajorAxis() const { return mA; }
+    double flattening() const { return mF; }
+
+    /**
+     * True if the datum has no shift to WGS 84 and the same ellipsoid.
+     */
+    bool isWGS84() const;
+
+    /**
+     * Affine form of the Helmert transformation to WGS 84.
+     */
+    const aeAffineTransform &toWGS84() const { return mToWGS84; }
+
+    /**
+     * Grid shift to WGS 84, or null if the datum uses a Helmert
+     * transformation.
+     */
+    const std::shared_ptr<const aeGridShift> &grid() const { return mGrid; }
+
+    void toGeocentric(double lon, double lat, double h, double &x, double &y, double &z) const;
+    void fromGeocentric(double x, double y, double z, double &lon, double &lat, double &h) const;
+
+private:
+    std::string mName;
+    double mA;          // semi-major axis
+    double mF;          // flattening
+    double mB;          // semi-minor axis
+    double mE2;         // first eccentricity squared
+    double mEp2B;       // second eccentricity squared times b
+    aeAffineTransform mToWGS84;
+    std::shared_ptr<const aeGridShift> mGrid;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A vertical datum, given by the height of its zero surface above the
+//  ellipsoid: either a constant or a geoid grid.  Heights relative to it are
+//  ellipsoidal heights minus that offset.
+
+class aeVerticalDatum {
+public:
+    aeVerticalDatum(const std::string &name, double offset = 0.0):
+        mName(name), mOffset(offset) {}
+
+    /**
+     * A datum following a geoid grid; the constant offset is used outside
+     * the grid.
+     */
+    aeVerticalDatum(
+        const std::string &name,
+        const std::shared_ptr<const aeGeoidGrid> &grid,
+        double offset = 0.0
+    ): mName(name), mOffset(offset), mGrid(grid) {}
+
+    const std::string &name() const { return mName; }
+
+    /**
+     * Height of the datum surface above the ellipsoid at a location.
+     */
+    double offset(double lon, double lat) const {
+        if (mGrid) {
+            double h = mGrid->height(lon, lat);
+            return std::isnan(h) ? mOffset : h;
+        }
+        return mOffset;
+    }
+
+private:
+    std::string mName;
+    double mOffset;
+    std::shared_ptr<const aeGeoidGrid> mGrid;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A compiled shift between two datums.  The two Helmert transformations
+//  are composed (source to WGS 84, then WGS 84 to target) into one affine
+//  matrix when the shift is built, so converting a point costs a geodetic to
+//  geocentric conversion, one matrix product and the conversion back.  Z
+//  values are taken as ellipsoidal heights and are updated; M values are
+//  unchanged.
+//
+//  A datum with a grid shift is taken to WGS 84 by its grid instead of by a
+//  Helmert transformation, and back by the grid's inverse; points outside
+//  the grid are not shifted by it.  Two datums on the same grid and
+//  ellipsoid need no shift at all.
+
+class aeDatumShift {
+public:
+    aeDatumShift(const aeDatum &source, const aeDatum &target);
+
+    /**
+     * True if the shift leaves coordinates unchanged.
+     */
+    bool isIdentity() const { return mIdentity; }
+
+    void apply(double &lon, double &lat, double &h) const;
+
+    template <typename T>
+    aePointT<T> apply(const aePointT<T> &p) const {
+        double lon = p.x, lat = p.y, h = p.z;
+        apply(lon, lat, h);
+        return aePointT<T>(lon, lat, h, p.m);
+    }
+
+    /**
+     * Shifts count points; in and out may be the same buffer.
+     */
+    template <typename T>
+    void apply(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const;
+
+private:
+    aeDatum mSource;            // WGS 84 if the source has a grid
+    aeDatum mTarget;            // WGS 84 if the target has a grid
+    std::shared_ptr<const aeGridShift> mSourceGrid;
+    std::shared_ptr<const aeGridShift> mTargetGrid;
+    double mMatrix[12];
+    bool mHelmertIdentity;
+    bool mIdentity;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEDATUM_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
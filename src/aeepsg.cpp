@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeepsg.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct GeographicEntry {
+    int32_t code;
+    const char *name;
+    const char *datumName;
+    int32_t datumCode;
+    const char *spheroidName;
+    int32_t spheroidCode;
+    double inverseFlattening;
+    const aeDatum &(*datum)();
+};
+
+static const GeographicEntry geographic[] = {
+    { 4326, "WGS 84", "WGS_1984", 6326, "WGS 84", 7030,
+      298.257223563, &aeDatum::wgs84 },
+    { 4258, "ETRS89", "European_Terrestrial_Reference_System_1989", 6258,
+      "GRS 1980", 7019, 298.257222101, &aeDatum::etrs89 },
+    { 4269, "NAD83", "North_American_Datum_1983", 6269, "GRS 1980", 7019,
+      298.257222101, &aeDatum::nad83 },
+    { 4267, "NAD27", "North_American_Datum_1927", 6267, "Clarke 1866", 7008,
+      294.978698213898, &aeDatum::nad27 },
+    { 4230, "ED50", "European_Datum_1950", 6230, "International 1924", 7022,
+      297.0, &aeDatum::ed50 },
+    { 4277, "OSGB 1936", "OSGB_1936", 6277, "Airy 1830", 7001,
+      299.3249646, &aeDatum::osgb36 }
+};
+
+struct ProjectedEntry {
+    int32_t code;
+    int32_t geographicCode;
+    const char *name;
+    aeEPSGDefinition::Method method;
+    double centralMeridian;
+    double latitudeOfOrigin;
+    double scaleFactor;
+    double falseEasting;
+    double falseNorthing;
+};
+
+static const ProjectedEntry projected[] = {
+    { 3857, 4326, "WGS 84 / Pseudo-Mercator", aeEPSGDefinition::WebMercator,
+      0.0, 0.0, 1.0, 0.0, 0.0 },
+    { 27700, 4277, "OSGB 1936 / British National Grid",
+      aeEPSGDefinition::TransverseMercator,
+      -2.0, 49.0, 0.9996012717, 400000.0, -100000.0 }
+};
+
+/*
+ * Runs of UTM zones numbered consecutively from the first code.
+ */
+struct UTMFamily {
+    int32_t first;
+    int32_t last;
+    int32_t geographicCode;
+    const char *prefix;
+    int firstZone;
+    bool north;
+};
+
+static const UTMFamily families[] = {
+    { 32601, 32660, 4326, "WGS 84", 1, true },
+    { 32701, 32760, 4326, "WGS 84", 1, false },
+    { 25828, 25838, 4258, "ETRS89", 28, true },
+    { 23028, 23038, 4230, "ED50", 28, true },
+    { 26901, 26923, 4269, "NAD83", 1, true },
+    { 26701, 26722, 4267, "NAD27", 1, true }
+};
+
+const GeographicEntry *findGeographic(int32_t code) {
+    switch (code) {
+        case 4326: return &geographic[0];
+        case 4258: return &geographic[1];
+        case 4269: return &geographic[2];
+        case 4267: return &geographic[3];
+        case 4230: return &geographic[4];
+        case 4277: return &geographic[5];
+        default:   return nullptr;
+    }
+}
+
+const ProjectedEntry *findProjected(int32_t code) {
+    switch (code) {
+        case 3857:  return &projected[0];
+        case 27700: return &projected[1];
+        default:    return nullptr;
+    }
+}
+
+/*
+ * Families are keyed by the code with the zone digits removed.
+ */
+const UTMFamily *findFamily(int32_t code) {
+    const UTMFamily *family;
+
+    switch (code / 100) {
+        case 326: family = &families[0]; break;
+        case 327: family = &families[1]; break;
+        case 258: family = &families[2]; break;
+        case 230: family = &families[3]; break;
+        case 269: family = &families[4]; break;
+        case 267: family = &families[5]; break;
+        default:  return nullptr;
+    }
+
+    return (code >= family->first && code <= family->last) ? family : nullptr;
+}
+
+void writeGeographic(std::ostringstream &s, const GeographicEntry &g) {
+    s << "GEOGCS[\"" << g.name << "\","
+      << "DATUM[\"" << g.datumName << "\","
+      << "SPHEROID[\"" << g.spheroidName << "\","
+      << g.datum().semiMajorAxis() << "," << g.inverseFlattening << ","
+      << "AUTHORITY[\"EPSG\",\"" << g.spheroidCode << "\"]],"
+      << "AUTHORITY[\"EPSG\",\"" << g.datumCode << "\"]],"
+      << "PRIMEM[\"Greenwich\",0,AUTHORITY[\"EPSG\",\"8901\"]],"
+      << "UNIT[\"degree\",0.0174532925199433,AUTHORITY[\"EPSG\",\"9122\"]],"
+      << "AUTHORITY[\"EPSG\",\"" << g.code << "\"]]";
+}
+
+void writeParameter(std::ostringstream &s, const char *name, double value) {
+    s << "PARAMETER[\"" << name << "\"," << value << "],";
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string aeEPSGDefinition::name() const {
+    if (zone == 0) {
+        return baseName;
+    }
+    std::ostringstream s;
+    s << baseName << " / UTM zone " << zone << (north ? "N" : "S");
+    return s.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool aeEPSG::lookup(int32_t code, aeEPSGDefinition &definition) {
+    if (const GeographicEntry *g = findGeographic(code)) {
+        definition.code = code;
+        definition.geographicCode = code;
+        definition.baseName = g->name;
+        definition.zone = 0;
+        definition.north = true;
+        definition.method = aeEPSGDefinition::Geographic;
+        definition.datum = &g->datum();
+        definition.centralMeridian = 0.0;
+        definition.latitudeOfOrigin = 0.0;
+        definition.scaleFactor = 1.0;
+        definition.falseEasting = 0.0;
+        definition.falseNorthing = 0.0;
+        return true;
+    }
+
+    if (const ProjectedEntry *p = findProjected(code)) {
+        definition.code = code;
+        definition.geographicCode = p->geographicCode;
+        definition.baseName = p->name;
+        definition.zone = 0;
+        definition.north = true;
+        definition.method = p->method;
+        definition.datum = &findGeographic(p->geographicCode)->datum();
+        definition.centralMeridian = p->centralMeridian;
+        definition.latitudeOfOrigin = p->latitudeOfOrigin;
+        definition.scaleFactor = p->scaleFactor;
+        definition.falseEasting = p->falseEasting;
+        definition.falseNorthing = p->falseNorthing;
+        return true;
+    }
+
+    if (const UTMFamily *f = findFamily(code)) {
+        int zone = f->firstZone + (code - f->first);
+
+        definition.code = code;
+        definition.geographicCode = f->geographicCode;
+        definition.baseName = f->prefix;
+        definition.zone = zone;
+        definition.north = f->north;
+        definition.method = aeEPSGDefinition::TransverseMercator;
+        definition.datum = &findGeographic(f->geographicCode)->datum();
+        definition.centralMeridian = 6.0 * zone - 183.0;
+        definition.latitudeOfOrigin = 0.0;
+        definition.scaleFactor = 0.9996;
+        definition.falseEasting = 500000.0;
+        definition.falseNorthing = f->north ? 0.0 : 10000000.0;
+        return true;
+    }
+
+    return false;
+}
+
+std::string aeEPSG::toWKT(int32_t code) {
+    aeEPSGDefinition definition;
+    if (!lookup(code, definition)) {
+        return std::string();
+    }
+
+    std::ostringstream s;
+    s.precision(15);
+
+    const GeographicEntry &g = *findGeographic(definition.geographicCode);
+
+    if (definition.method == aeEPSGDefinition::Geographic) {
+        writeGeographic(s, g);
+        return s.str();
+    }
+
+    s << "PROJCS[\"" << definition.name() << "\",";
+    writeGeographic(s, g);
+    s << ",";
+
+    if (definition.method == aeEPSGDefinition::WebMercator) {
+        s << "PROJECTION[\"Mercator_1SP\"],";
+        writeParameter(s, "central_meridian", definition.centralMeridian);
+        writeParameter(s, "scale_factor", definition.scaleFactor);
+    } else {
+        s << "PROJECTION[\"Transverse_Mercator\"],";
+        writeParameter(s, "latitude_of_origin", definition.latitudeOfOrigin);
+        writeParameter(s, "central_meridian", definition.centralMeridian);
+        writeParameter(s, "scale_factor", definition.scaleFactor);
+    }
+
+    writeParameter(s, "false_easting", definition.falseEasting);
+    writeParameter(s, "false_northing", definition.falseNorthing);
+
+    s << "UNIT[\"metre\",1,AUTHORITY[\"EPSG\",\"9001\"]],"
+      << "AXIS[\"Easting\",EAST],AXIS[\"Northing\",NORTH],";
+
+    if (definition.method == aeEPSGDefinition::WebMercator) {
+        s << "EXTENSION[\"PROJ4\",\"+proj=merc +a=6378137 +b=6378137 "
+          << "+lat_ts=0 +lon_0=0 +x_0=0 +y_0=0 +k=1 +units=m +nadgrids=@null "
+          << "+wktext +no_defs\"],";
+    }
+
+    s << "AUTHORITY[\"EPSG\",\"" << definition.code << "\"]]";
+    return s.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
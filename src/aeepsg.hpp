@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEEPSG_HPP_INCLUDE_GUARD
+#define AEEPSG_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aedatum.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note An embedded registry of common EPSG coordinate reference systems:
+//  geographic systems on the built-in datums, Web Mercator, the British
+//  National Grid and the UTM zones on WGS 84, ETRS89, ED50, NAD83 and NAD27.
+//  The tables are static data compiled into the library, so nothing is read
+//  or parsed at startup.  Single codes are resolved by a switch and zone
+//  families by arithmetic on the code, so a lookup takes constant time.
+
+struct aeEPSGDefinition {
+    enum Method {
+        Geographic,
+        WebMercator,
+        TransverseMercator
+    };
+
+    int32_t code;
+    int32_t geographicCode;
+
+    // the registered name, or for a UTM zone the name of its geographic
+    // system, which name() completes; lookups never allocate
+    const char *baseName;
+    int32_t zone;
+    bool north;
+
+    Method method;
+    const aeDatum *datum;
+
+    // projection parameters, in degrees and metres
+    double centralMeridian;
+    double latitudeOfOrigin;
+    double scaleFactor;
+    double falseEasting;
+    double falseNorthing;
+
+    /**
+     * The full name, such as "WGS 84 / UTM zone 31N".
+     */
+    std::string name() const;
+};
+
+class aeEPSG {
+public:
+    /**
+     * Looks up a code, returning false if it is not in the registry.
+     */
+    static bool lookup(int32_t code, aeEPSGDefinition &definition);
+
+    /**
+     * OGC WKT (version 1) for a code, or an empty string if it is not in the
+     * registry.
+     */
+    static std::string toWKT(int32_t code);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEEPSG_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -3,11 +3,89 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aeextent.hpp"
+#include "aeparallel.hpp"
+
+#include <cinttypes>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    // Points per thread below which splitting the work is not worthwhile
+    static const std::size_t ExtentGrain = 1 << 16;
+
+    template <typename T>
+    T lesser(const T &a, const T &b) { return (a < b) ? a : b; }
+
+    template <typename T>
+    T greater(const T &a, const T &b) { return (a > b) ? a : b; }
+
+    // Folds points into separate min/max accumulators for each coordinate,
+    // with no branches in the loop so that it vectorizes
+    template <typename T>
+    aeExtentT<T> scan(const aePointT<T> *points, std::size_t count) {
+        const T high = std::numeric_limits<T>::has_infinity ?
+            std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        const T low = std::numeric_limits<T>::has_infinity ?
+            -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+
+        T min[4] = { high, high, high, high };
+        T max[4] = { low, low, low, low };
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const aePointT<T> &p = points[i];
+            min[0] = lesser(p.x, min[0]); max[0] = greater(p.x, max[0]);
+            min[1] = lesser(p.y, min[1]); max[1] = greater(p.y, max[1]);
+            min[2] = lesser(p.z, min[2]); max[2] = greater(p.z, max[2]);
+            min[3] = lesser(p.m, min[3]); max[3] = greater(p.m, max[3]);
+        }
+
+        // Coordinates never seen are left empty, as by aeExtentT itself
+        aeExtentT<T> extent;
+        T *lo[4] = { &extent.min.x, &extent.min.y, &extent.min.z, &extent.min.m };
+        T *hi[4] = { &extent.max.x, &extent.max.y, &extent.max.z, &extent.max.m };
+
+        for (int k = 0; k < 4; ++k) {
+            if (min[k] <= max[k]) {
+                *lo[k] = min[k];
+                *hi[k] = max[k];
+            }
+        }
+
+        return extent;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aeExtentT<T> aeComputeExtent(
+    const aePointT<T> *points,
+    std::size_t count,
+    unsigned int threads
+) {
+    return aeParallelReduce< aeExtentT<T> >(count, ExtentGrain, threads,
+        [points](std::size_t begin, std::size_t end) {
+            return scan(points + begin, end - begin);
+        },
+        [](aeExtentT<T> &result, const aeExtentT<T> &partial) {
+            result |= partial;
+        }
+    );
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template class aeExtentT<double>;
 template class aeExtentT<float>;
+template class aeExtentT<int32_t>;
+
+template class aeExtent2T<double>;
+template class aeExtent2T<float>;
+template class aeExtent2T<int32_t>;
+
+template aeExtentT<double> aeComputeExtent(const aePointT<double> *, std::size_t, unsigned int);
+template aeExtentT<float> aeComputeExtent(const aePointT<float> *, std::size_t, unsigned int);
+template aeExtentT<int32_t> aeComputeExtent(const aePointT<int32_t> *, std::size_t, unsigned int);
 
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
@@ -7,12 +7,16 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "aecoord.hpp"
 #include "aepoint.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cmath>
+#include <cstddef>
+#include <limits>
 #include <utility>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -22,7 +26,8 @@ struct aeExtentT {
     aePointT<T> max;
 
     aeExtentT(
-    ): min(aeNaN, aeNaN, aeNaN, aeNaN), max(aeNaN, aeNaN, aeNaN, aeNaN) {
+    ): min(emptyMin(), emptyMin(), emptyMin(), emptyMin()),
+       max(emptyMax(), emptyMax(), emptyMax(), emptyMax()) {
     }
 
     aeExtentT(
@@ -84,7 +89,9 @@ struct aeExtentT {
     bool isEmpty() const {
         return (min.x == max.x && min.y == max.y) ||
                 std::isnan(min.x) || std::isnan(min.y) ||
-                std::isnan(max.x) || std::isnan(max.y);
+                std::isnan(max.x) || std::isnan(max.y) ||
+                (std::numeric_limits<T>::is_integer &&
+                 (min.x > max.x || min.y > max.y));
     }
 
     bool validate() {
@@ -95,11 +102,181 @@ struct aeExtentT {
         if (min.m > max.m) { std::swap(min.m, max.m); valid = false; }
         return valid;
     }
+
+private:
+    // Integer extents have no NaN, so an empty extent is inverted instead
+    static T emptyMin() { return aeCoordTraitsT<T>::emptyMin(); }
+    static T emptyMax() { return aeCoordTraitsT<T>::emptyMax(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A compact two-dimensional extent for bulk work such as indexing and
+//  clipping.  An empty extent is inverted (min at +infinity, max at
+//  -infinity, or the integer limits), so union and intersection are plain
+//  min/max operations with no special cases; a NaN coordinate is ignored.
+//  Extents that only touch intersect in a degenerate, non-empty extent.
+
+template <typename T>
+struct aeExtent2T {
+    typedef typename aeCoordTraitsT<T>::Real Real;
+
+    T xmin;
+    T ymin;
+    T xmax;
+    T ymax;
+
+    aeExtent2T(
+    ): xmin(high()), ymin(high()), xmax(low()), ymax(low()) {
+    }
+
+    aeExtent2T(
+        const T &xmin,
+        const T &ymin,
+        const T &xmax,
+        const T &ymax
+    ): xmin(xmin), ymin(ymin), xmax(xmax), ymax(ymax) {
+    }
+
+    aeExtent2T(
+        const aePointT<T> &a,
+        const aePointT<T> &b
+    ): xmin(lesser(a.x, b.x)), ymin(lesser(a.y, b.y)),
+       xmax(greater(a.x, b.x)), ymax(greater(a.y, b.y)) {
+    }
+
+    explicit aeExtent2T(
+        const aeExtentT<T> &e
+    ): xmin(lesser(e.min.x, high())), ymin(lesser(e.min.y, high())),
+       xmax(greater(e.max.x, low())), ymax(greater(e.max.y, low())) {
+    }
+
+    aeExtent2T<T> &operator |= (const aePointT<T> &rhs) {
+        xmin = lesser(rhs.x, xmin);
+        ymin = lesser(rhs.y, ymin);
+        xmax = greater(rhs.x, xmax);
+        ymax = greater(rhs.y, ymax);
+        return *this;
+    }
+
+    aeExtent2T<T> &operator |= (const aeExtent2T<T> &rhs) {
+        xmin = lesser(rhs.xmin, xmin);
+        ymin = lesser(rhs.ymin, ymin);
+        xmax = greater(rhs.xmax, xmax);
+        ymax = greater(rhs.ymax, ymax);
+        return *this;
+    }
+
+    aeExtent2T<T> &operator &= (const aeExtent2T<T> &rhs) {
+        xmin = greater(rhs.xmin, xmin);
+        ymin = greater(rhs.ymin, ymin);
+        xmax = lesser(rhs.xmax, xmax);
+        ymax = lesser(rhs.ymax, ymax);
+        return *this;
+    }
+
+    template <typename X>
+    aeExtent2T<T> operator | (const X &rhs) const {
+        aeExtent2T<T> result(*this);
+        result |= rhs;
+        return result;
+    }
+
+    template <typename X>
+    aeExtent2T<T> operator & (const X &rhs) const {
+        aeExtent2T<T> result(*this);
+        result &= rhs;
+        return result;
+    }
+
+    bool isEmpty() const {
+        return (xmin > xmax) | (ymin > ymax);
+    }
+
+    bool intersects(const aeExtent2T<T> &e) const {
+        return (xmin <= e.xmax) & (e.xmin <= xmax) &
+               (ymin <= e.ymax) & (e.ymin <= ymax);
+    }
+
+    bool contains(const aePointT<T> &p) const {
+        return (xmin <= p.x) & (p.x <= xmax) &
+               (ymin <= p.y) & (p.y <= ymax);
+    }
+
+    bool contains(const aeExtent2T<T> &e) const {
+        return (xmin <= e.xmin) & (e.xmax <= xmax) &
+               (ymin <= e.ymin) & (e.ymax <= ymax);
+    }
+
+    Real width() const {
+        return greater(Real(xmax) - Real(xmin), Real());
+    }
+
+    Real height() const {
+        return greater(Real(ymax) - Real(ymin), Real());
+    }
+
+    Real area() const {
+        return width() * height();
+    }
+
+    aeExtentT<T> toExtent() const {
+        aeExtentT<T> e;
+        if (!isEmpty()) {
+            e.min.x = xmin; e.min.y = ymin;
+            e.max.x = xmax; e.max.y = ymax;
+        }
+        return e;
+    }
+
+private:
+    // Written so the compiler emits min/max instructions rather than
+    // branches; the second operand (the accumulator) is returned if the
+    // first is NaN
+    template <typename U>
+    static U lesser(const U &a, const U &b) { return (a < b) ? a : b; }
+
+    template <typename U>
+    static U greater(const U &a, const U &b) { return (a > b) ? a : b; }
+
+    static T high() {
+        return std::numeric_limits<T>::has_infinity ?
+               std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    }
+
+    static T low() {
+        return std::numeric_limits<T>::has_infinity ?
+               -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Computes the extent of an array of points, splitting large arrays into
+ * chunks reduced on separate threads.  A thread count of zero uses the
+ * hardware concurrency; small inputs are always reduced on the calling
+ * thread.  NaN coordinates are ignored.
+ */
+template <typename T>
+aeExtentT<T> aeComputeExtent(
+    const aePointT<T> *points,
+    std::size_t count,
+    unsigned int threads = 0
+);
+
+template <typename T>
+aeExtentT<T> aeComputeExtent(
+    const std::vector< aePointT<T> > &points,
+    unsigned int threads = 0
+) {
+    return aeComputeExtent(points.data(), points.size(), threads);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 typedef aeExtentT<double> aeExtent;
+typedef aeExtent2T<double> aeExtent2;
 
 ////////////////////////////////////////////////////////////////////////////////
 
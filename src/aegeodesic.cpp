@@ -0,0 +1,1230 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeodesic.hpp"
+#include "aeconst.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+static constexpr double degsToRads = aePi / 180.0;
+static constexpr double radsToDegs = 180.0 / aePi;
+
+// order of the series in the third flattening
+static constexpr int order = 6;
+static constexpr int nC1 = order, nC1p = order, nC2 = order, nC3 = order, nC4 = order;
+
+static constexpr int maxit1 = 20;
+static constexpr int maxit2 = maxit1 + DBL_MANT_DIG + 10;
+
+static const double tiny = std::sqrt(DBL_MIN);
+static constexpr double tol0 = DBL_EPSILON;
+static constexpr double tol1 = 200.0 * tol0;
+static const double tol2 = std::sqrt(tol0);
+static constexpr double tolb = tol0;
+static const double xthresh = 1000.0 * tol2;
+
+enum LengthMask {
+    Distance = 1,
+    ReducedLength = 2,
+};
+
+inline double sq(double x) {
+    return x * x;
+}
+
+inline void norm(double &x, double &y) {
+    double r = std::hypot(x, y);
+    x /= r;
+    y /= r;
+}
+
+/*
+ * Error-free sum: returns u + v rounded, with the rounding error in t.
+ */
+inline double sumx(double u, double v, double &t) {
+    double s = u + v;
+    double up = s - v;
+    double vpp = s - up;
+    up -= u;
+    vpp -= v;
+    t = (s != 0.0) ? 0.0 - (up + vpp) : s;
+    return s;
+}
+
+inline double polyval(int n, const double *p, double x) {
+    double y = (n < 0) ? 0.0 : *p++;
+    while (--n >= 0) {
+        y = y * x + *p++;
+    }
+    return y;
+}
+
+/*
+ * Rounds small angles so that they underflow to zero together, keeping
+ * points very near the equator exactly symmetric.
+ */
+inline double angRound(double x) {
+    const double z = 1.0 / 16.0;
+    double y = std::fabs(x);
+    double w = z - y;
+    y = (w > 0.0) ? z - w : y;
+    return std::copysign(y, x);
+}
+
+inline double angNormalize(double x) {
+    double y = std::remainder(x, 360.0);
+    return (std::fabs(y) == 180.0) ? std::copysign(180.0, x) : y;
+}
+
+inline double latFix(double x) {
+    return (std::fabs(x) > 90.0) ? aeNaN : x;
+}
+
+/*
+ * y - x reduced to [-180, 180], with the rounding error in e.
+ */
+inline double angDiff(double x, double y, double &e) {
+    double t, d = sumx(std::remainder(-x, 360.0), std::remainder(y, 360.0), t);
+    d = sumx(std::remainder(d, 360.0), t, t);
+    if (d == 0.0 || std::fabs(d) == 180.0) {
+        d = std::copysign(d, (t == 0.0) ? y - x : -t);
+    }
+    e = t;
+    return d;
+}
+
+inline void quadrant(int q, double s, double c, double x, double &sinx, double &cosx) {
+    switch (unsigned(q) & 3u) {
+        case 0u:  sinx =  s; cosx =  c; break;
+        case 1u:  sinx =  c; cosx = -s; break;
+        case 2u:  sinx = -s; cosx = -c; break;
+        default:  sinx = -c; cosx =  s; break;
+    }
+    cosx += 0.0;
+    if (sinx == 0.0) {
+        sinx = std::copysign(sinx, x);
+    }
+}
+
+/*
+ * Sine and cosine of an angle in degrees, exact at multiples of 90.
+ */
+inline void sincosd(double x, double &sinx, double &cosx) {
+    int q = 0;
+    double r = std::remquo(x, 90.0, &q) * degsToRads;
+    quadrant(q, std::sin(r), std::cos(r), x, sinx, cosx);
+}
+
+/*
+ * Sine and cosine of x + t in degrees, for x in [-180, 180] and a small
+ * correction t.
+ */
+inline void sincosde(double x, double t, double &sinx, double &cosx) {
+    int q = 0;
+    double r = angRound(std::remquo(x, 90.0, &q) + t) * degsToRads;
+    quadrant(q, std::sin(r), std::cos(r), x, sinx, cosx);
+}
+
+inline double atan2d(double y, double x) {
+    int q = 0;
+    if (std::fabs(y) > std::fabs(x)) {
+        std::swap(x, y);
+        q = 2;
+    }
+    if (std::signbit(x)) {
+        x = -x;
+        ++q;
+    }
+    double ang = std::atan2(y, x) * radsToDegs;
+    switch (q) {
+        case 1:  ang = std::copysign(180.0, y) - ang; break;
+        case 2:  ang = 90.0 - ang; break;
+        case 3:  ang = -90.0 + ang; break;
+        default: break;
+    }
+    return ang;
+}
+
+/*
+ * Sums c[1] sin(2x) + ... + c[n] sin(2nx) (sinp), or c[0] cos(x) + ... +
+ * c[n-1] cos((2n-1)x), by Clenshaw's recurrence.
+ */
+double sinCosSeries(bool sinp, double sinx, double cosx, const double *c, int n) {
+    c += n + sinp;
+    double ar = 2.0 * (cosx - sinx) * (cosx + sinx);
+    double y0 = (n & 1) ? *--c : 0.0, y1 = 0.0;
+    n /= 2;
+    while (n--) {
+        y1 = ar * y0 - y1 + *--c;
+        y0 = ar * y1 - y0 + *--c;
+    }
+    return sinp ? 2.0 * sinx * cosx * y0 : cosx * (y0 - y1);
+}
+
+/*
+ * Positive root k of k^4 + 2 k^3 - (x^2 + y^2 - 1) k^2 - 2 y^2 k - y^2 = 0.
+ */
+double astroid(double x, double y) {
+    double p = sq(x), q = sq(y);
+    double r = (p + q - 1.0) / 6.0;
+
+    if (q == 0.0 && r <= 0.0) {
+        return 0.0;
+    }
+
+    double S = p * q / 4.0;
+    double r2 = sq(r), r3 = r * r2;
+    double disc = S * (S + 2.0 * r3);
+    double u = r;
+
+    if (disc >= 0.0) {
+        double T3 = S + r3;
+        T3 += (T3 < 0.0) ? -std::sqrt(disc) : std::sqrt(disc);
+        double T = std::cbrt(T3);
+        u += T + ((T != 0.0) ? r2 / T : 0.0);
+    } else {
+        double ang = std::atan2(std::sqrt(-disc), -(S + r3));
+        u += 2.0 * r * std::cos(ang / 3.0);
+    }
+
+    double v = std::sqrt(sq(u) + q);
+    double uv = (u < 0.0) ? q / (v - u) : u + v;
+    double w = (uv - q) / (2.0 * v);
+    return uv / (std::sqrt(uv + sq(w)) + w);
+}
+
+double A1m1f(double eps) {
+    static const double coeff[] = { 1, 4, 64, 0, 256 };
+    const int m = order / 2;
+    double t = polyval(m, coeff, sq(eps)) / coeff[m + 1];
+    return (t + eps) / (1.0 - eps);
+}
+
+double A2m1f(double eps) {
+    static const double coeff[] = { -11, -28, -192, 0, 256 };
+    const int m = order / 2;
+    double t = polyval(m, coeff, sq(eps)) / coeff[m + 1];
+    return (t - eps) / (1.0 + eps);
+}
+
+/*
+ * Fills c[1..order] from a table of even polynomials in eps.
+ */
+void evenSeries(const double *coeff, double eps, double *c) {
+    double eps2 = sq(eps), d = eps;
+    int o = 0;
+    for (int l = 1; l <= order; ++l) {
+        int m = (order - l) / 2;
+        c[l] = d * polyval(m, coeff + o, eps2) / coeff[o + m + 1];
+        o += m + 2;
+        d *= eps;
+    }
+}
+
+void C1f(double eps, double *c) {
+    static const double coeff[] = {
+        -1, 6, -16, 32,
+        -9, 64, -128, 2048,
+        9, -16, 768,
+        3, -5, 512,
+        -7, 1280,
+        -7, 2048,
+    };
+    evenSeries(coeff, eps, c);
+}
+
+void C1pf(double eps, double *c) {
+    static const double coeff[] = {
+        205, -432, 768, 1536,
+        4005, -4736, 3840, 12288,
+        -225, 116, 384,
+        -7173, 2695, 7680,
+        3467, 7680,
+        38081, 61440,
+    };
+    evenSeries(coeff, eps, c);
+}
+
+void C2f(double eps, double *c) {
+    static const double coeff[] = {
+        1, 2, 16, 32,
+        35, 64, 384, 2048,
+        15, 80, 768,
+        7, 35, 512,
+        63, 1280,
+        77, 2048,
+    };
+    evenSeries(coeff, eps, c);
+}
+
+/*
+ * Shewchuk's error-free accumulator, as used by GeographicLib for polygon
+ * areas: the running sum is held as the unevaluated pair s + t.
+ */
+class Accumulator {
+public:
+    Accumulator() : mS(0.0), mT(0.0) { }
+
+    void add(double y) {
+        double u;
+        y = sumx(y, mT, u);
+        mS = sumx(y, mS, mT);
+        if (mS == 0.0) {
+            mS = u;
+        } else {
+            mT += u;
+        }
+    }
+
+    double sum() const { return mS; }
+
+    void negate() {
+        mS = -mS;
+        mT = -mT;
+    }
+
+    void remainder(double y) {
+        mS = std::remainder(mS, y);
+        add(0.0);
+    }
+
+private:
+    double mS, mT;
+};
+
+/*
+ * Counts crossings of the prime meridian by the edge from lon1 to lon2.
+ */
+int transit(double lon1, double lon2) {
+    double e, lon12 = angDiff(lon1, lon2, e);
+    lon1 = angNormalize(lon1);
+    lon2 = angNormalize(lon2);
+    if (lon12 > 0.0 && ((lon1 < 0.0 && lon2 >= 0.0) || (lon1 > 0.0 && lon2 == 0.0))) {
+        return 1;
+    }
+    if (lon12 < 0.0 && lon1 >= 0.0 && lon2 < 0.0) {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Reduces the summed area of a ring to (-area0/2, area0/2], positive for
+ * counter-clockwise rings.
+ */
+double reduceArea(Accumulator &area, double area0, int crossings) {
+    area.remainder(area0);
+    if (crossings & 1) {
+        area.add((area.sum() < 0.0 ? 1.0 : -1.0) * area0 / 2.0);
+    }
+    area.negate();
+    if (area.sum() > area0 / 2.0) {
+        area.add(-area0);
+    } else if (area.sum() <= -area0 / 2.0) {
+        area.add(area0);
+    }
+    return 0.0 + area.sum();
+}
+
+bool isAreal(int type) {
+    switch (type) {
+        case aeGeometry::Polygon:
+        case aeGeometry::MultiPolygon:
+        case aeGeometry::CurvePolygon:
+        case aeGeometry::MultiSurface:
+        case aeGeometry::Surface:
+        case aeGeometry::PolyhedralSurface:
+        case aeGeometry::TIN:
+        case aeGeometry::Triangle:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// arcs are linearized to about a centimetre before measuring
+static constexpr double curveTolerance = 1e-7;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * A point with its latitude reduced to the auxiliary sphere: sbet and cbet
+ * are the sine and cosine of the reduced latitude and dn = sqrt(1 + ep2
+ * sbet^2).  These are all the inverse solution needs from a point apart
+ * from its longitude.
+ */
+struct aeGeodesic::Vertex {
+    double lon, lat;
+    double sbet, cbet, dn;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeGeodesic::aeGeodesic(double a, double f):
+    mA(a), mF(f), mF1(1.0 - f), mE2(f * (2.0 - f)),
+    mEp2(mE2 / sq(mF1)), mN(f / (2.0 - f)), mB(a * mF1)
+{
+    if (!(std::isfinite(mA) && mA > 0.0)) {
+        throw aeArgumentError("semi-major axis must be positive");
+    }
+
+    if (!(std::isfinite(mB) && mB > 0.0)) {
+        throw aeArgumentError("semi-minor axis must be positive");
+    }
+
+    double e = std::sqrt(std::fabs(mE2));
+    mC2 = (sq(mA) + sq(mB) * (
+        (mE2 == 0.0) ? 1.0 :
+        ((mE2 > 0.0) ? std::atanh(e) : std::atan(e)) / e)) / 2.0;
+
+    mEtol2 = 0.1 * tol2 / std::sqrt(
+        std::max(0.001, std::fabs(mF)) * std::min(1.0, 1.0 - mF / 2.0) / 2.0);
+
+    static const double A3coeff[] = {
+        -3, 128,
+        -2, -3, 64,
+        -1, -3, -1, 16,
+        3, -1, -2, 8,
+        1, -1, 2,
+        1, 1,
+    };
+
+    static const double C3coeff[] = {
+        3, 128,
+        2, 5, 128,
+        -1, 3, 3, 64,
+        -1, 0, 1, 8,
+        -1, 1, 4,
+        5, 256,
+        1, 3, 128,
+        -3, -2, 3, 64,
+        1, -3, 2, 32,
+        7, 512,
+        -10, 9, 384,
+        5, -9, 5, 192,
+        7, 512,
+        -14, 7, 512,
+        21, 2560,
+    };
+
+    static const double C4coeff[] = {
+        97, 15015,
+        1088, 156, 45045,
+        -224, -4784, 1573, 45045,
+        -10656, 14144, -4576, -858, 45045,
+        64, 624, -4576, 6864, -3003, 15015,
+        100, 208, 572, 3432, -12012, 30030, 45045,
+        1, 9009,
+        -2944, 468, 135135,
+        5792, 1040, -1287, 135135,
+        5952, -11648, 9152, -2574, 135135,
+        -64, -624, 4576, -6864, 3003, 135135,
+        8, 10725,
+        1856, -936, 225225,
+        -8448, 4992, -1144, 225225,
+        -1440, 4160, -4576, 1716, 225225,
+        -136, 63063,
+        1024, -208, 105105,
+        3584, -3328, 1144, 315315,
+        -128, 135135,
+        -2560, 832, 405405,
+        128, 99099,
+    };
+
+    int o = 0, k = 0;
+    for (int j = order - 1; j >= 0; --j) {
+        int m = std::min(order - j - 1, j);
+        mA3x[k++] = polyval(m, A3coeff + o, mN) / A3coeff[o + m + 1];
+        o += m + 2;
+    }
+
+    o = 0; k = 0;
+    for (int l = 1; l < nC3; ++l) {
+        for (int j = nC3 - 1; j >= l; --j) {
+            int m = std::min(nC3 - j - 1, j);
+            mC3x[k++] = polyval(m, C3coeff + o, mN) / C3coeff[o + m + 1];
+            o += m + 2;
+        }
+    }
+
+    o = 0; k = 0;
+    for (int l = 0; l < nC4; ++l) {
+        for (int j = nC4 - 1; j >= l; --j) {
+            int m = nC4 - j - 1;
+            mC4x[k++] = polyval(m, C4coeff + o, mN) / C4coeff[o + m + 1];
+            o += m + 2;
+        }
+    }
+}
+
+const aeGeodesic &aeGeodesic::wgs84() {
+    static const aeGeodesic geodesic(6378137.0, 1.0 / 298.257223563);
+    return geodesic;
+}
+
+double aeGeodesic::ellipsoidArea() const {
+    return 4.0 * aePi * mC2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double aeGeodesic::A3f(double eps) const {
+    return polyval(order - 1, mA3x, eps);
+}
+
+void aeGeodesic::C3f(double eps, double *c) const {
+    double mult = 1.0;
+    int o = 0;
+    for (int l = 1; l < nC3; ++l) {
+        int m = nC3 - l - 1;
+        mult *= eps;
+        c[l] = mult * polyval(m, mC3x + o, eps);
+        o += m + 1;
+    }
+}
+
+void aeGeodesic::C4f(double eps, double *c) const {
+    double mult = 1.0;
+    int o = 0;
+    for (int l = 0; l < nC4; ++l) {
+        int m = nC4 - l - 1;
+        c[l] = mult * polyval(m, mC4x + o, eps);
+        o += m + 1;
+        mult *= eps;
+    }
+}
+
+aeGeodesic::Vertex aeGeodesic::vertex(double lon, double lat) const {
+    Vertex v;
+    v.lon = lon;
+    v.lat = angRound(latFix(lat));
+    sincosd(v.lat, v.sbet, v.cbet);
+    v.sbet *= mF1;
+    norm(v.sbet, v.cbet);
+    v.cbet = std::max(tiny, v.cbet);
+    v.dn = std::sqrt(1.0 + mEp2 * sq(v.sbet));
+    return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void aeGeodesic::lengths(
+    double eps, double sig12,
+    double ssig1, double csig1, double dn1,
+    double ssig2, double csig2, double dn2,
+    unsigned int mask,
+    double &s12b, double &m12b, double &m0,
+    double *C1a, double *C2a
+) const {
+    double m0x = 0.0, J12 = 0.0, A1 = 0.0, A2 = 0.0;
+    const bool redlp = mask & ReducedLength;
+
+    A1 = A1m1f(eps);
+    C1f(eps, C1a);
+    if (redlp) {
+        A2 = A2m1f(eps);
+        C2f(eps, C2a);
+        m0x = A1 - A2;
+        A2 = 1.0 + A2;
+    }
+    A1 = 1.0 + A1;
+
+    if (mask & Distance) {
+        double B1 = sinCosSeries(true, ssig2, csig2, C1a, nC1) -
+                    sinCosSeries(true, ssig1, csig1, C1a, nC1);
+        s12b = A1 * (sig12 + B1);
+        if (redlp) {
+            double B2 = sinCosSeries(true, ssig2, csig2, C2a, nC2) -
+                        sinCosSeries(true, ssig1, csig1, C2a, nC2);
+            J12 = m0x * sig12 + (A1 * B1 - A2 * B2);
+        }
+    } else if (redlp) {
+        // assume here that C1a and C2a are not needed again
+        for (int l = 1; l <= nC2; ++l) {
+            C2a[l] = A1 * C1a[l] - A2 * C2a[l];
+        }
+        J12 = m0x * sig12 + (sinCosSeries(true, ssig2, csig2, C2a, nC2) -
+                             sinCosSeries(true, ssig1, csig1, C2a, nC2));
+    }
+
+    if (redlp) {
+        m0 = m0x;
+        // the reduced length, scaled by b
+        m12b = dn2 * (csig1 * ssig2) - dn1 * (ssig1 * csig2) - csig1 * csig2 * J12;
+    }
+}
+
+void aeGeodesic::inverseStart(
+    double sbet1, double cbet1, double dn1,
+    double sbet2, double cbet2, double dn2,
+    double lam12, double slam12, double clam12,
+    double &sig12, double &salp1, double &calp1,
+    double &salp2, double &calp2, double &dnm,
+    double *C1a, double *C2a
+) const {
+    sig12 = -1.0;
+    salp2 = calp2 = dnm = aeNaN;
+
+    // bet12 = bet2 - bet1 in [0, pi); bet12a = bet2 + bet1 in (-pi, 0]
+    double sbet12 = sbet2 * cbet1 - cbet2 * sbet1;
+    double cbet12 = cbet2 * cbet1 + sbet2 * sbet1;
+    volatile double sbet12a = sbet2 * cbet1;
+    sbet12a += cbet2 * sbet1;
+
+    const bool shortline = cbet12 >= 0.0 && sbet12 < 0.5 && cbet2 * lam12 < 0.5;
+    double somg12, comg12;
+
+    if (shortline) {
+        double sbetm2 = sq(sbet1 + sbet2);
+        sbetm2 /= sbetm2 + sq(cbet1 + cbet2);
+        dnm = std::sqrt(1.0 + mEp2 * sbetm2);
+        double omg12 = lam12 / (mF1 * dnm);
+        somg12 = std::sin(omg12);
+        comg12 = std::cos(omg12);
+    } else {
+        somg12 = slam12;
+        comg12 = clam12;
+    }
+
+    salp1 = cbet2 * somg12;
+    calp1 = (comg12 >= 0.0) ?
+        sbet12 + cbet2 * sbet1 * sq(somg12) / (1.0 + comg12) :
+        sbet12a - cbet2 * sbet1 * sq(somg12) / (1.0 - comg12);
+
+    double ssig12 = std::hypot(salp1, calp1);
+    double csig12 = sbet1 * sbet2 + cbet1 * cbet2 * comg12;
+
+    if (shortline && ssig12 < mEtol2) {
+        // really short lines
+        salp2 = cbet1 * somg12;
+        calp2 = sbet12 - cbet1 * sbet2 *
+            ((comg12 >= 0.0) ? sq(somg12) / (1.0 + comg12) : 1.0 - comg12);
+        norm(salp2, calp2);
+        sig12 = std::atan2(ssig12, csig12);
+    } else if (std::fabs(mN) > 0.1 || csig12 >= 0.0 ||
+               ssig12 >= 6.0 * std::fabs(mN) * aePi * sq(cbet1)) {
+        // the zeroth order spherical approximation is good enough
+    } else {
+        // scale lam12 and bet2 to x, y coordinates where the antipodal point
+        // is at the origin and the singular point at y = 0, x = -1
+        double x, y, lamscale, betscale;
+        double lam12x = std::atan2(-slam12, -clam12);
+
+        if (mF >= 0.0) {
+            // x = dlong, y = dlat
+            double k2 = sq(sbet1) * mEp2;
+            double eps = k2 / (2.0 * (1.0 + std::sqrt(1.0 + k2)) + k2);
+            lamscale = mF * cbet1 * A3f(eps) * aePi;
+            betscale = lamscale * cbet1;
+            x = lam12x / lamscale;
+            y = sbet12a / betscale;
+        } else {
+            // x = dlat, y = dlong
+            double cbet12a = cbet2 * cbet1 - sbet2 * sbet1;
+            double bet12a = std::atan2(sbet12a, cbet12a);
+            double dummy, m12b, m0;
+            lengths(mN, aePi + bet12a, sbet1, -cbet1, dn1, sbet2, cbet2, dn2,
+                    ReducedLength, dummy, m12b, m0, C1a, C2a);
+            x = -1.0 + m12b / (cbet1 * cbet2 * m0 * aePi);
+            betscale = (x < -0.01) ? sbet12a / x : -mF * sq(cbet1) * aePi;
+            lamscale = betscale / cbet1;
+            y = lam12x / lamscale;
+        }
+
+        if (y > -tol1 && x > -1.0 - xthresh) {
+            // strip near the cut
+            if (mF >= 0.0) {
+                salp1 = std::min(1.0, -x);
+                calp1 = -std::sqrt(1.0 - sq(salp1));
+            } else {
+                calp1 = std::max((x > -tol1) ? 0.0 : -1.0, x);
+                salp1 = std::sqrt(1.0 - sq(calp1));
+            }
+        } else {
+            // estimate omg12 by solving the astroid problem, and use the
+            // spherical formula to compute alp1 from it
+            double k = astroid(x, y);
+            double omg12a = lamscale * ((mF >= 0.0) ? -x * k / (1.0 + k) : -y * (1.0 + k) / k);
+            somg12 = std::sin(omg12a);
+            comg12 = -std::cos(omg12a);
+            salp1 = cbet2 * somg12;
+            calp1 = sbet12a - cbet2 * sbet1 * sq(somg12) / (1.0 - comg12);
+        }
+    }
+
+    // sanity check on the starting guess; backwards to let NaN through
+    if (!(salp1 <= 0.0)) {
+        norm(salp1, calp1);
+    } else {
+        salp1 = 1.0;
+        calp1 = 0.0;
+    }
+}
+
+double aeGeodesic::lambda12(
+    double sbet1, double cbet1, double dn1,
+    double sbet2, double cbet2, double dn2,
+    double salp1, double calp1,
+    double slam120, double clam120,
+    double &salp2, double &calp2, double &sig12,
+    double &ssig1, double &csig1, double &ssig2, double &csig2,
+    double &eps, double &domg12, bool diffp, double &dlam12,
+    double *C1a, double *C2a, double *C3a
+) const {
+    if (sbet1 == 0.0 && calp1 == 0.0) {
+        // break the degeneracy of an equatorial line
+        calp1 = -tiny;
+    }
+
+    double salp0 = salp1 * cbet1;
+    double calp0 = std::hypot(calp1, salp1 * sbet1);
+
+    ssig1 = sbet1;
+    double somg1 = salp0 * sbet1;
+    csig1 = calp1 * cbet1;
+    double comg1 = csig1;
+    norm(ssig1, csig1);
+
+    // enforce the symmetries when |bet2| = -bet1
+    salp2 = (cbet2 != cbet1) ? salp0 / cbet2 : salp1;
+    calp2 = (cbet2 != cbet1 || std::fabs(sbet2) != -sbet1) ?
+        std::sqrt(sq(calp1 * cbet1) +
+                  ((cbet1 < -sbet1) ?
+                   (cbet2 - cbet1) * (cbet1 + cbet2) :
+                   (sbet1 - sbet2) * (sbet1 + sbet2))) / cbet2 :
+        std::fabs(calp1);
+
+    ssig2 = sbet2;
+    double somg2 = salp0 * sbet2;
+    csig2 = calp2 * cbet2;
+    double comg2 = csig2;
+    norm(ssig2, csig2);
+
+    // sig12 = sig2 - sig1 and omg12 = omg2 - omg1, limited to [0, pi]
+    sig12 = std::atan2(std::max(0.0, csig1 * ssig2 - ssig1 * csig2) + 0.0,
+                       csig1 * csig2 + ssig1 * ssig2);
+    double somg12 = std::max(0.0, comg1 * somg2 - somg1 * comg2) + 0.0;
+    double comg12 = comg1 * comg2 + somg1 * somg2;
+
+    // eta = omg12 - lam120
+    double eta = std::atan2(somg12 * clam120 - comg12 * slam120,
+                            comg12 * clam120 + somg12 * slam120);
+
+    double k2 = sq(calp0) * mEp2;
+    eps = k2 / (2.0 * (1.0 + std::sqrt(1.0 + k2)) + k2);
+    C3f(eps, C3a);
+    double B312 = sinCosSeries(true, ssig2, csig2, C3a, nC3 - 1) -
+                  sinCosSeries(true, ssig1, csig1, C3a, nC3 - 1);
+    domg12 = -mF * A3f(eps) * salp0 * (sig12 + B312);
+    double lam12 = eta + domg12;
+
+    if (diffp) {
+        if (calp2 == 0.0) {
+            dlam12 = -2.0 * mF1 * dn1 / sbet1;
+        } else {
+            double dummy, m0;
+            lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
+                    ReducedLength, dummy, dlam12, m0, C1a, C2a);
+            dlam12 *= mF1 / (calp2 * cbet2);
+        }
+    } else {
+        dlam12 = aeNaN;
+    }
+
+    return lam12;
+}
+
+void aeGeodesic::inverse(
+    const Vertex &p1, const Vertex &p2, bool wantArea,
+    double &s12, double &salp1, double &calp1,
+    double &salp2, double &calp2, double &S12
+) const {
+    double C1a[nC1 + 1], C2a[nC2 + 1], C3a[nC3];
+
+    // longitude difference in [0, 180], with its rounding error
+    double lon12s, lon12 = angDiff(p1.lon, p2.lon, lon12s);
+    double lonsign = std::copysign(1.0, lon12);
+    lon12 *= lonsign;
+    lon12s *= lonsign;
+    double lam12 = lon12 * degsToRads;
+    double slam12, clam12;
+    sincosde(lon12, lon12s, slam12, clam12);
+    lon12s = (180.0 - lon12) - lon12s;
+
+    // put the point with the greater absolute latitude first (or a NaN one),
+    // then make its latitude negative; the reduced latitudes flip with them
+    const Vertex *v1 = &p1, *v2 = &p2;
+    double swapp = (std::fabs(p1.lat) < std::fabs(p2.lat) || std::isnan(p2.lat)) ? -1.0 : 1.0;
+    if (swapp < 0.0) {
+        lonsign = -lonsign;
+        std::swap(v1, v2);
+    }
+
+    double latsign = std::copysign(1.0, -v1->lat);
+    double lat1 = latsign * v1->lat;
+    double sbet1 = latsign * v1->sbet, cbet1 = v1->cbet, dn1 = v1->dn;
+    double sbet2 = latsign * v2->sbet, cbet2 = v2->cbet, dn2 = v2->dn;
+
+    // force bet2 = +/- bet1 exactly when the difference vanishes
+    if (cbet1 < -sbet1) {
+        if (cbet2 == cbet1) {
+            sbet2 = std::copysign(sbet1, sbet2);
+            dn2 = dn1;
+        }
+    } else if (std::fabs(sbet2) == -sbet1) {
+        cbet2 = cbet1;
+    }
+
+    double sig12 = 0.0, s12x = 0.0, m12x = 0.0, dummy;
+    double somg12 = 2.0, comg12 = 0.0, omg12 = 0.0;
+
+    bool meridian = lat1 == -90.0 || slam12 == 0.0;
+
+    if (meridian) {
+        // the end points are on a single full meridian, so the geodesic
+        // might lie on it
+        calp1 = clam12; salp1 = slam12;
+        calp2 = 1.0; salp2 = 0.0;
+
+        double ssig1 = sbet1, csig1 = calp1 * cbet1;
+        double ssig2 = sbet2, csig2 = calp2 * cbet2;
+
+        sig12 = std::atan2(std::max(0.0, csig1 * ssig2 - ssig1 * csig2) + 0.0,
+                           csig1 * csig2 + ssig1 * ssig2);
+
+        lengths(mN, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
+                Distance | ReducedLength, s12x, m12x, dummy, C1a, C2a);
+
+        // sig12 > pi/2 for a meridional geodesic that is not the shortest
+        // path; m12 < 0 for zero length geodesics too
+        if (sig12 < tol2 || m12x >= 0.0) {
+            if (sig12 < 3.0 * tiny || (sig12 < tol0 && (s12x < 0.0 || m12x < 0.0))) {
+                sig12 = m12x = s12x = 0.0;
+            }
+            s12x *= mB;
+        } else {
+            // prolate and too close to antipodal
+            meridian = false;
+        }
+    }
+
+    if (!meridian && sbet1 == 0.0 && (mF <= 0.0 || lon12s >= mF * 180.0)) {
+        // along the equator
+        calp1 = calp2 = 0.0;
+        salp1 = salp2 = 1.0;
+        s12x = mA * lam12;
+        sig12 = omg12 = lam12 / mF1;
+    } else if (!meridian) {
+        double dnm;
+        inverseStart(sbet1, cbet1, dn1, sbet2, cbet2, dn2, lam12, slam12, clam12,
+                     sig12, salp1, calp1, salp2, calp2, dnm, C1a, C2a);
+
+        if (sig12 >= 0.0) {
+            // short lines
+            s12x = sig12 * mB * dnm;
+            omg12 = lam12 / (mF1 * dnm);
+        } else {
+            // Newton's method on lambda12(alp1) - lam12 = 0, which has one
+            // root in (0, pi) with a positive derivative there; the root is
+            // kept bracketed and the iteration falls back to bisection when
+            // a step would leave the bracket
+            double ssig1 = 0.0, csig1 = 0.0, ssig2 = 0.0, csig2 = 0.0;
+            double eps = 0.0, domg12 = 0.0;
+            int numit = 0;
+            bool tripn = false, tripb = false;
+            double salp1a = tiny, calp1a = 1.0, salp1b = tiny, calp1b = -1.0;
+
+            for (;;) {
+                double dv;
+                double v = lambda12(sbet1, cbet1, dn1, sbet2, cbet2, dn2,
+                                    salp1, calp1, slam12, clam12,
+                                    salp2, calp2, sig12, ssig1, csig1, ssig2, csig2,
+                                    eps, domg12, numit < maxit1, dv, C1a, C2a, C3a);
+
+                // reversed test to allow escape with NaNs
+                if (tripb || !(std::fabs(v) >= (tripn ? 8.0 : 1.0) * tol0) || numit == maxit2) {
+                    break;
+                }
+
+                // update the bracket
+                if (v > 0.0 && (numit > maxit1 || calp1 / salp1 > calp1b / salp1b)) {
+                    salp1b = salp1; calp1b = calp1;
+                } else if (v < 0.0 && (numit > maxit1 || calp1 / salp1 < calp1a / salp1a)) {
+                    salp1a = salp1; calp1a = calp1;
+                }
+
+                ++numit;
+                if (numit < maxit1 && dv > 0.0) {
+                    double dalp1 = -v / dv;
+                    if (std::fabs(dalp1) < aePi) {
+                        double sdalp1 = std::sin(dalp1), cdalp1 = std::cos(dalp1);
+                        double nsalp1 = salp1 * cdalp1 + calp1 * sdalp1;
+                        if (nsalp1 > 0.0) {
+                            calp1 = calp1 * cdalp1 - salp1 * sdalp1;
+                            salp1 = nsalp1;
+                            norm(salp1, calp1);
+                            // the slope may vanish, losing quadratic
+                            // convergence, so test against epsilon
+                            tripn = std::fabs(v) <= 16.0 * tol0;
+                            continue;
+                        }
+                    }
+                }
+
+                // bisect the bracket
+                salp1 = (salp1a + salp1b) / 2.0;
+                calp1 = (calp1a + calp1b) / 2.0;
+                norm(salp1, calp1);
+                tripn = false;
+                tripb = (std::fabs(salp1a - salp1) + (calp1a - calp1) < tolb ||
+                         std::fabs(salp1 - salp1b) + (calp1 - calp1b) < tolb);
+            }
+
+            lengths(eps, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
+                    Distance, s12x, m12x, dummy, C1a, C2a);
+            s12x *= mB;
+
+            if (wantArea) {
+                // omg12 = lam12 - domg12
+                double sdomg12 = std::sin(domg12), cdomg12 = std::cos(domg12);
+                somg12 = slam12 * cdomg12 - clam12 * sdomg12;
+                comg12 = clam12 * cdomg12 + slam12 * sdomg12;
+            }
+        }
+    }
+
+    s12 = 0.0 + s12x;
+
+    if (wantArea) {
+        double salp0 = salp1 * cbet1;
+        double calp0 = std::hypot(calp1, salp1 * sbet1);
+
+        if (calp0 != 0.0 && salp0 != 0.0) {
+            double ssig1 = sbet1, csig1 = calp1 * cbet1;
+            double ssig2 = sbet2, csig2 = calp2 * cbet2;
+            double k2 = sq(calp0) * mEp2;
+            double eps = k2 / (2.0 * (1.0 + std::sqrt(1.0 + k2)) + k2);
+            double A4 = sq(mA) * calp0 * salp0 * mE2;
+            norm(ssig1, csig1);
+            norm(ssig2, csig2);
+
+            double C4a[nC4];
+            C4f(eps, C4a);
+            double B41 = sinCosSeries(false, ssig1, csig1, C4a, nC4);
+            double B42 = sinCosSeries(false, ssig2, csig2, C4a, nC4);
+            S12 = A4 * (B42 - B41);
+        } else {
+            // sig1 and sig2 are indeterminate on the equator
+            S12 = 0.0;
+        }
+
+        if (!meridian && somg12 == 2.0) {
+            somg12 = std::sin(omg12);
+            comg12 = std::cos(omg12);
+        }
+
+        double alp12;
+        if (!meridian && comg12 > -0.7071 && sbet2 - sbet1 < 1.75) {
+            // tan(Gamma/2) = tan(omg12/2) *
+            //     (tan(bet1/2) + tan(bet2/2)) / (1 + tan(bet1/2) tan(bet2/2))
+            double domg12 = 1.0 + comg12, dbet1 = 1.0 + cbet1, dbet2 = 1.0 + cbet2;
+            alp12 = 2.0 * std::atan2(somg12 * (sbet1 * dbet2 + sbet2 * dbet1),
+                                     domg12 * (sbet1 * sbet2 + dbet1 * dbet2));
+        } else {
+            // alp12 = alp2 - alp1
+            double salp12 = salp2 * calp1 - calp2 * salp1;
+            double calp12 = calp2 * calp1 + salp2 * salp1;
+            if (salp12 == 0.0 && calp12 < 0.0) {
+                salp12 = tiny * calp1;
+                calp12 = -1.0;
+            }
+            alp12 = std::atan2(salp12, calp12);
+        }
+
+        S12 += mC2 * alp12;
+        S12 *= swapp * lonsign * latsign;
+        S12 += 0.0;
+    }
+
+    // undo the swaps and reflections
+    if (swapp < 0.0) {
+        std::swap(salp1, salp2);
+        std::swap(calp1, calp2);
+    }
+
+    salp1 *= swapp * lonsign; calp1 *= swapp * latsign;
+    salp2 *= swapp * lonsign; calp2 *= swapp * latsign;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double aeGeodesic::inverse(double lon1, double lat1, double lon2, double lat2) const {
+    double s12, salp1, calp1, salp2, calp2, S12;
+    inverse(vertex(lon1, lat1), vertex(lon2, lat2), false, s12, salp1, calp1, salp2, calp2, S12);
+    return s12;
+}
+
+double aeGeodesic::inverse(
+    double lon1, double lat1,
+    double lon2, double lat2,
+    double &azi1, double &azi2
+) const {
+    double s12, salp1, calp1, salp2, calp2, S12;
+    inverse(vertex(lon1, lat1), vertex(lon2, lat2), false, s12, salp1, calp1, salp2, calp2, S12);
+    azi1 = atan2d(salp1, calp1);
+    azi2 = atan2d(salp2, calp2);
+    return s12;
+}
+
+void aeGeodesic::direct(
+    double lon1, double lat1,
+    double azi1, double s12,
+    double &lon2, double &lat2, double &azi2
+) const {
+    double C1a[nC1 + 1], C1pa[nC1p + 1], C3a[nC3];
+
+    double salp1, calp1;
+    sincosd(angRound(azi1), salp1, calp1);
+
+    double sbet1, cbet1;
+    sincosd(angRound(latFix(lat1)), sbet1, cbet1);
+    sbet1 *= mF1;
+    norm(sbet1, cbet1);
+    cbet1 = std::max(tiny, cbet1);
+
+    // the great circle on the auxiliary sphere: alp0 is the azimuth at the
+    // equator crossing, sig and omg the arc and longitude from it
+    double salp0 = salp1 * cbet1;
+    double calp0 = std::hypot(calp1, salp1 * sbet1);
+    double ssig1 = sbet1, somg1 = salp0 * sbet1;
+    double csig1 = (sbet1 != 0.0 || calp1 != 0.0) ? cbet1 * calp1 : 1.0;
+    double comg1 = csig1;
+    norm(ssig1, csig1);
+
+    double k2 = sq(calp0) * mEp2;
+    double eps = k2 / (2.0 * (1.0 + std::sqrt(1.0 + k2)) + k2);
+
+    double A1m1 = A1m1f(eps);
+    C1f(eps, C1a);
+    double B11 = sinCosSeries(true, ssig1, csig1, C1a, nC1);
+    double s = std::sin(B11), c = std::cos(B11);
+    double stau1 = ssig1 * c + csig1 * s;
+    double ctau1 = csig1 * c - ssig1 * s;
+
+    C1pf(eps, C1pa);
+
+    C3f(eps, C3a);
+    double A3c = -mF * salp0 * A3f(eps);
+    double B31 = sinCosSeries(true, ssig1, csig1, C3a, nC3 - 1);
+
+    // distance to arc length by reverting the series
+    double tau12 = s12 / (mB * (1.0 + A1m1));
+    if (!std::isfinite(tau12)) {
+        tau12 = aeNaN;
+    }
+    s = std::sin(tau12);
+    c = std::cos(tau12);
+    double B12 = -sinCosSeries(true, stau1 * c + ctau1 * s, ctau1 * c - stau1 * s, C1pa, nC1p);
+    double sig12 = tau12 - (B12 - B11);
+    double ssig12 = std::sin(sig12), csig12 = std::cos(sig12);
+
+    if (std::fabs(mF) > 0.01) {
+        // the reverted series is too inaccurate; take one Newton step
+        double ssig2 = ssig1 * csig12 + csig1 * ssig12;
+        double csig2 = csig1 * csig12 - ssig1 * ssig12;
+        B12 = sinCosSeries(true, ssig2, csig2, C1a, nC1);
+        double serr = (1.0 + A1m1) * (sig12 + (B12 - B11)) - s12 / mB;
+        sig12 = sig12 - serr / std::sqrt(1.0 + k2 * sq(ssig2));
+        ssig12 = std::sin(sig12);
+        csig12 = std::cos(sig12);
+    }
+
+    double ssig2 = ssig1 * csig12 + csig1 * ssig12;
+    double csig2 = csig1 * csig12 - ssig1 * ssig12;
+
+    double sbet2 = calp0 * ssig2;
+    double cbet2 = std::hypot(salp0, calp0 * csig2);
+    if (cbet2 == 0.0) {
+        cbet2 = csig2 = tiny;
+    }
+
+    double somg2 = salp0 * ssig2, comg2 = csig2;
+    double omg12 = std::atan2(somg2 * comg1 - comg2 * somg1, comg2 * comg1 + somg2 * somg1);
+    double lam12 = omg12 + A3c * (sig12 + (sinCosSeries(true, ssig2, csig2, C3a, nC3 - 1) - B31));
+
+    lon2 = angNormalize(angNormalize(lon1) + angNormalize(lam12 * radsToDegs));
+    lat2 = atan2d(sbet2, mF1 * cbet2);
+    azi2 = atan2d(salp0, calp0 * csig2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void aeGeodesic::inverse(
+    const aePointT<T> *from,
+    const aePointT<T> *to,
+    std::size_t count,
+    double *s12,
+    double *azi1,
+    double *azi2
+) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        double salp1, calp1, salp2, calp2, S12;
+        inverse(vertex(from[i].x, from[i].y), vertex(to[i].x, to[i].y), false,
+                s12[i], salp1, calp1, salp2, calp2, S12);
+        if (azi1) {
+            azi1[i] = atan2d(salp1, calp1);
+        }
+        if (azi2) {
+            azi2[i] = atan2d(salp2, calp2);
+        }
+    }
+}
+
+template <typename T>
+void aeGeodesic::direct(
+    const aePointT<T> *from,
+    const double *azi1,
+    const double *s12,
+    aePointT<T> *to,
+    std::size_t count,
+    double *azi2
+) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        double lon2, lat2, a2;
+        direct(from[i].x, from[i].y, azi1[i], s12[i], lon2, lat2, a2);
+        aePointT<T> p = from[i];
+        p.x = T(lon2);
+        p.y = T(lat2);
+        to[i] = p;
+        if (azi2) {
+            azi2[i] = a2;
+        }
+    }
+}
+
+template <typename T>
+double aeGeodesic::length(const aePointT<T> *points, std::size_t count, double *segments) const {
+    if (count < 2) {
+        return 0.0;
+    }
+
+    Accumulator total;
+    Vertex prev = vertex(points[0].x, points[0].y);
+
+    for (std::size_t i = 1; i < count; ++i) {
+        Vertex next = vertex(points[i].x, points[i].y);
+        double s12, salp1, calp1, salp2, calp2, S12;
+        inverse(prev, next, false, s12, salp1, calp1, salp2, calp2, S12);
+        total.add(s12);
+        if (segments) {
+            segments[i - 1] = s12;
+        }
+        prev = next;
+    }
+
+    return total.sum();
+}
+
+template <typename T>
+double aeGeodesic::area(const aePointT<T> *ring, std::size_t count) const {
+    if (count < 2) {
+        return 0.0;
+    }
+
+    Accumulator total;
+    int crossings = 0;
+
+    // an explicitly closed ring needs no closing edge
+    if (count > 2 && ring[count - 1].x == ring[0].x && ring[count - 1].y == ring[0].y) {
+        --count;
+    }
+
+    const Vertex first = vertex(ring[0].x, ring[0].y);
+    Vertex prev = first;
+
+    for (std::size_t i = 1; i <= count; ++i) {
+        Vertex next = (i < count) ? vertex(ring[i].x, ring[i].y) : first;
+        double s12, salp1, calp1, salp2, calp2, S12;
+        inverse(prev, next, true, s12, salp1, calp1, salp2, calp2, S12);
+        total.add(S12);
+        crossings += transit(prev.lon, next.lon);
+        prev = next;
+    }
+
+    return reduceArea(total, ellipsoidArea(), crossings);
+}
+
+template <typename T>
+double aeGeodesic::length(const aeGeometryT<T> &geometry) const {
+    std::shared_ptr<const aeGeometryT<T> > linear = geometry.linearize(curveTolerance);
+    const aeGeometryT<T> &g = *linear;
+    const aePointT<T> *points = g.points().data();
+    const bool closed = isAreal(g.baseType());
+
+    Accumulator total;
+
+    for (unsigned int i = 0, n = g.partCount(); i < n; ++i) {
+        unsigned int begin = g.partBegin(i), end = g.partEnd(i);
+        if (end > begin + 1) {
+            total.add(length(points + begin, end - begin));
+            if (closed) {
+                const aePointT<T> &p = points[end - 1], &q = points[begin];
+                if (p.x != q.x || p.y != q.y) {
+                    total.add(inverse(p.x, p.y, q.x, q.y));
+                }
+            }
+        }
+    }
+
+    return total.sum();
+}
+
+template <typename T>
+double aeGeodesic::area(const aeGeometryT<T> &geometry) const {
+    std::shared_ptr<const aeGeometryT<T> > linear = geometry.linearize(curveTolerance);
+    const aeGeometryT<T> &g = *linear;
+    const aePointT<T> *points = g.points().data();
+
+    Accumulator total;
+
+    for (unsigned int i = 0, n = g.partCount(); i < n; ++i) {
+        unsigned int begin = g.partBegin(i), end = g.partEnd(i);
+        if (end > begin + 2) {
+            total.add(area(points + begin, end - begin));
+        }
+    }
+
+    return total.sum();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template void aeGeodesic::inverse<double>(const aePointT<double> *, const aePointT<double> *, std::size_t, double *, double *, double *) const;
+template void aeGeodesic::inverse<float>(const aePointT<float> *, const aePointT<float> *, std::size_t, double *, double *, double *) const;
+template void aeGeodesic::direct<double>(const aePointT<double> *, const double *, const double *, aePointT<double> *, std::size_t, double *) const;
+template void aeGeodesic::direct<float>(const aePointT<float> *, const double *, const double *, aePointT<float> *, std::size_t, double *) const;
+template double aeGeodesic::length<double>(const aePointT<double> *, std::size_t, double *) const;
+template double aeGeodesic::length<float>(const aePointT<float> *, std::size_t, double *) const;
+template double aeGeodesic::area<double>(const aePointT<double> *, std::size_t) const;
+template double aeGeodesic::area<float>(const aePointT<float> *, std::size_t) const;
+template double aeGeodesic::length<double>(const aeGeometryT<double> &) const;
+template double aeGeodesic::length<float>(const aeGeometryT<float> &) const;
+template double aeGeodesic::area<double>(const aeGeometryT<double> &) const;
+template double aeGeodesic::area<float>(const aeGeometryT<float> &) const;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEGEODESIC_HPP_INCLUDE_GUARD
+#define AEGEODESIC_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeom.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Geodesics on an ellipsoid of revolution, by Karney's method ("Algorithms
+//  for geodesics", J. Geodesy 87, 2013), with the series taken to sixth order
+//  in the third flattening as in GeographicLib.  Results are accurate to about
+//  15 nanometres for the WGS 84 ellipsoid, and the inverse solution converges
+//  for every pair of points, antipodal ones included.
+//
+//  The polynomial coefficients that depend only on the ellipsoid are computed
+//  by the constructor.  The array functions reduce each vertex's latitude to
+//  the auxiliary sphere once, so the consecutive segments of a line share
+//  that work, and keep their scratch series on the stack.
+//
+//  Coordinates are (longitude, latitude) in degrees, longitude first as in
+//  the rest of the library; azimuths are in degrees clockwise from north,
+//  distances in metres and areas in square metres.
+
+class aeGeodesic {
+public:
+    /**
+     * Geodesics on the ellipsoid with semi-major axis a and flattening f.
+     * Throws aeArgumentError unless both semi-axes are positive.
+     */
+    aeGeodesic(double a, double f);
+
+    static const aeGeodesic &wgs84();
+
+    double semiMajorAxis() const { return mA; }
+    double flattening() const { return mF; }
+
+    /**
+     * Total area of the ellipsoid.
+     */
+    double ellipsoidArea() const;
+
+    /**
+     * Length of the shortest geodesic between two points.
+     */
+    double inverse(double lon1, double lat1, double lon2, double lat2) const;
+
+    /**
+     * Length of the shortest geodesic between two points, with its azimuths
+     * at each end (the forward azimuth at the second point).
+     */
+    double inverse(
+        double lon1, double lat1,
+        double lon2, double lat2,
+        double &azi1, double &azi2
+    ) const;
+
+    /**
+     * End point and azimuth of the geodesic of length s12 leaving a point
+     * with azimuth azi1.  Negative lengths go backwards.
+     */
+    void direct(
+        double lon1, double lat1,
+        double azi1, double s12,
+        double &lon2, double &lat2, double &azi2
+    ) const;
+
+    /**
+     * Pairwise distances from each point of one array to the same point of
+     * another, with the azimuths at each end if asked for.
+     */
+    template <typename T>
+    void inverse(
+        const aePointT<T> *from,
+        const aePointT<T> *to,
+        std::size_t count,
+        double *s12,
+        double *azi1 = nullptr,
+        double *azi2 = nullptr
+    ) const;
+
+    /**
+     * End points of geodesics leaving count points with the given azimuths
+     * and lengths; from and to may be the same buffer.  Z and M values are
+     * copied.
+     */
+    template <typename T>
+    void direct(
+        const aePointT<T> *from,
+        const double *azi1,
+        const double *s12,
+        aePointT<T> *to,
+        std::size_t count,
+        double *azi2 = nullptr
+    ) const;
+
+    /**
+     * Length of the line through count points, writing the count - 1
+     * segment lengths if asked for.
+     */
+    template <typename T>
+    double length(const aePointT<T> *points, std::size_t count, double *segments = nullptr) const;
+
+    /**
+     * Signed area of the ring through count points, closed back to its
+     * first point: positive if the ring runs counter-clockwise.  The ring
+     * may encircle a pole.
+     */
+    template <typename T>
+    double area(const aePointT<T> *ring, std::size_t count) const;
+
+    /**
+     * Total length of a geometry's parts, with each ring of a polygon closed.
+     */
+    template <typename T>
+    double length(const aeGeometryT<T> &geometry) const;
+
+    /**
+     * Sum of the signed areas of a geometry's parts, each closed to its first
+     * point; the ellipsoidal counterpart of aeGeometryT::area().
+     */
+    template <typename T>
+    double area(const aeGeometryT<T> &geometry) const;
+
+private:
+    struct Vertex;
+
+    Vertex vertex(double lon, double lat) const;
+
+    void inverse(
+        const Vertex &v1, const Vertex &v2, bool wantArea,
+        double &s12, double &salp1, double &calp1,
+        double &salp2, double &calp2, double &S12
+    ) const;
+
+    void inverseStart(
+        double sbet1, double cbet1, double dn1,
+        double sbet2, double cbet2, double dn2,
+        double lam12, double slam12, double clam12,
+        double &sig12, double &salp1, double &calp1,
+        double &salp2, double &calp2, double &dnm,
+        double *C1a, double *C2a
+    ) const;
+
+    double lambda12(
+        double sbet1, double cbet1, double dn1,
+        double sbet2, double cbet2, double dn2,
+        double salp1, double calp1,
+        double slam120, double clam120,
+        double &salp2, double &calp2, double &sig12,
+        double &ssig1, double &csig1, double &ssig2, double &csig2,
+        double &eps, double &domg12, bool diffp, double &dlam12,
+        double *C1a, double *C2a, double *C3a
+    ) const;
+
+    void lengths(
+        double eps, double sig12,
+        double ssig1, double csig1, double dn1,
+        double ssig2, double csig2, double dn2,
+        unsigned int mask,
+        double &s12b, double &m12b, double &m0,
+        double *C1a, double *C2a
+    ) const;
+
+    double A3f(double eps) const;
+    void C3f(double eps, double *c) const;
+    void C4f(double eps, double *c) const;
+
+private:
+    double mA;
+    double mF;
+    double mF1;         // 1 - f
+    double mE2;         // first eccentricity squared
+    double mEp2;        // second eccentricity squared
+    double mN;          // third flattening
+    double mB;          // semi-minor axis
+    double mC2;         // authalic radius squared
+    double mEtol2;
+    double mA3x[6];
+    double mC3x[15];
+    double mC4x[21];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEGEODESIC_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
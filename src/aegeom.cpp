@@ -4,303 +4,524 @@
 
 #include "aegeom.hpp"
 #include "aeexcept.hpp"
+#include "aepred.hpp"
+#include "aesweep.hpp"
 
 #include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <mutex>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    /* Guards the linearization caches of const geometries shared between
+     * threads; geometries are spread over a few locks by address, so the
+     * class itself stays copyable. */
+    std::mutex &cacheLock(const void *geometry) {
+        static std::mutex locks[16];
+        return locks[(reinterpret_cast<uintptr_t>(geometry) >> 4) % 16];
+    }
+
+    // Circular arc through three points, in double precision
+    struct Arc {
+        double cx;
+        double cy;
+        double r;
+        double a0;
+        double sweep;
+
+        // Returns false if the points are collinear
+        template <typename T>
+        bool fit(const aePointT<T> &p0, const aePointT<T> &p1, const aePointT<T> &p2) {
+            if (p0.x == p2.x && p0.y == p2.y) {
+                // Full circle; p1 is diametrically opposite p0
+                if (p0.x == p1.x && p0.y == p1.y) {
+                    return false;
+                }
+                cx = (double(p0.x) + double(p1.x)) * 0.5;
+                cy = (double(p0.y) + double(p1.y)) * 0.5;
+                r = std::hypot(double(p0.x) - cx, double(p0.y) - cy);
+                a0 = std::atan2(double(p0.y) - cy, double(p0.x) - cx);
+                sweep = 2.0 * aePi;
+                return true;
+            }
+
+            double o = aeOrient2d(p0, p1, p2);
+            if (o == 0.0) {
+                return false;
+            }
+
+            double bx = double(p1.x) - double(p0.x), by = double(p1.y) - double(p0.y);
+            double dx = double(p2.x) - double(p0.x), dy = double(p2.y) - double(p0.y);
+            double b2 = bx * bx + by * by, d2 = dx * dx + dy * dy;
+            double den = 2.0 * (bx * dy - by * dx);
+            double ux = (dy * b2 - by * d2) / den;
+            double uy = (bx * d2 - dx * b2) / den;
+
+            cx = double(p0.x) + ux;
+            cy = double(p0.y) + uy;
+            r = std::hypot(ux, uy);
+            a0 = std::atan2(-uy, -ux);
+
+            double a2 = std::atan2(double(p2.y) - cy, double(p2.x) - cx);
+            sweep = a2 - a0;
+
+            if (o > 0.0 && sweep <= 0.0) {
+                sweep += 2.0 * aePi;
+            } else if (o < 0.0 && sweep >= 0.0) {
+                sweep -= 2.0 * aePi;
+            }
+
+            return true;
+        }
+
+        bool covers(double a) const {
+            double t = (sweep > 0.0) ? (a - a0) : (a0 - a);
+            t = std::fmod(t, 2.0 * aePi);
+            if (t < 0.0) {
+                t += 2.0 * aePi;
+            }
+            return t <= std::abs(sweep);
+        }
+
+        // Signed area between the arc and its chord
+        double segmentArea() const {
+            return 0.5 * r * r * (sweep - std::sin(sweep));
+        }
+
+        // Distance from the centre to the centroid of the segment
+        double segmentCentroid() const {
+            double phi = std::abs(sweep);
+            double s = std::sin(phi * 0.5);
+            return 4.0 * r * s * s * s / (3.0 * (phi - std::sin(phi)));
+        }
+
+        // Number of chords keeping within the given distance of the arc
+        unsigned int chords(double tolerance) const {
+            double c = std::max(-1.0, std::min(1.0, 1.0 - tolerance / r));
+            double step = std::min(2.0 * aePi / 3.0, 2.0 * std::acos(c));
+            double n = std::ceil(std::abs(sweep) / step);
+            return (n < 1.0) ? 1 : (n > 1e6) ? 1000000 : (unsigned int)(n);
+        }
+    };
+
+    // Calls line(a, b) or arc(a, b, c) for each segment of the curve formed
+    // by joining parts [first, last) end to end
+    template <typename T, typename L, typename A>
+    void walkCurve(const aeGeometryT<T> &g, unsigned int first, unsigned int last, L line, A arc) {
+        const std::vector< aePointT<T> > &p = g.points();
+
+        for (unsigned int i = first; i < last; ++i) {
+            unsigned int begin = g.partBegin(i), end = g.partEnd(i);
+
+            if (g.partType(i) == aeGeometryT<T>::CircularString) {
+                for (unsigned int k = begin; k + 2 < end; k += 2) {
+                    arc(p[k], p[k + 1], p[k + 2]);
+                }
+            } else {
+                for (unsigned int k = begin; k + 1 < end; ++k) {
+                    line(p[k], p[k + 1]);
+                }
+            }
+        }
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
 void aeGeometryT<T>::update() const {
+    typedef typename aeCoordTraitsT<T>::Wide Wide;
+
+    if (isCurve() && mPoints.size() > 2) {
+        updateCurve();
+        return;
+    }
+
     aeExtentT<T> extent;
 
-    T area = T();
-    aePointT<T> q, c;
+    Wide area = Wide();
+    aePointT<Wide> c;
+    aePointT<T> q;
+
+    for (unsigned int i = 0, n = partCount(); i < n; ++i) {
+        unsigned int begin = partBegin(i), end = partEnd(i);
 
-    if (!mPoints.empty()) {
-        q = mPoints.back();
+        if (begin < end) {
+            q = mPoints[end - 1];
 
-        for (const aePointT<T> &p : mPoints) {
-            extent |= p;
-            T d = det(q, p);
-            c += (q + p) * d;
-            area += d;
-            q = p;
+            for (unsigned int k = begin; k < end; ++k) {
+                const aePointT<T> &p = mPoints[k];
+                extent |= p;
+                Wide d = Wide(q.x) * Wide(p.y) - Wide(q.y) * Wide(p.x);
+                c += (aePointT<Wide>(q) + aePointT<Wide>(p)) * d;
+                area += d;
+                q = p;
+            }
         }
     }
 
     mExtent = extent;
-    mArea = area * T(0.5);
+    mArea = Real(area) * Real(0.5);
 
     if (mPoints.size() == 1) {
         // N == 1 -> centroid = single point
-        mCentroid = mPoints[0];
+        mCentroid = aePointT<Real>(mPoints[0]);
     } else if (mPoints.size() == 2) {
         // N == 2 -> centroid = midpoint
-        mCentroid = (mPoints[0] + mPoints[1]) / T(2);
+        mCentroid = (aePointT<Real>(mPoints[0]) + aePointT<Real>(mPoints[1])) / Real(2);
     } else {
         // N == 0 -> centroid = <NaN, NaN>
         // N > 2 -> centroid = calculated from area
-        mCentroid = c / (mArea * T(6.0));
+        mCentroid = aePointT<Real>(c) / (mArea * Real(6.0));
     }
 
     mNeedsUpdate = false;
 }
 
 template <typename T>
-bool aeGeometryT<T>::findIntersections(Points &intersections, bool /*abortOnFirst*/) const {
-    struct Segment {
-        aePointT<T> a;
-        aePointT<T> b;
+void aeGeometryT<T>::updateCurve() const {
+    typedef aeCoordTraitsT<T> Traits;
 
-        Segment(): a(), b() {}
-        Segment(const aePointT<T> &a, const aePointT<T> &b): a(a), b(b) {}
+    // Area and centroid by Green's theorem: each chord contributes as in a
+    // polygon, and each arc adds the circular segment between it and its
+    // chord.  Arcs pass through all of their control points, so the extent
+    // only needs widening where an arc crosses an axis direction.
 
-        bool intersects(const Segment &s) const {
-            aePointT<T> p;
-            return intersects(s, p);
-        }
-        bool intersects(const Segment &s, aePointT<T> &p) const {
-            aePointT<T> l1 = {   b.x -   a.x,   b.y -   a.y };
-            aePointT<T> l2 = { s.b.x - s.a.x, s.b.y - s.a.y };
+    aeExtentT<T> extent;
 
-            T d = det(l1, l2);
+    for (const aePointT<T> &p : mPoints) {
+        extent |= p;
+    }
 
-            if (d != 0.0) {
-                T t = det(l2, a - s.a) / d;
+    double area = 0.0, mx = 0.0, my = 0.0;
 
-                if (t >= 0.0 && t <= 1.0) {
-                    p = a + t * l1;
-                    return true;
-                }
-            }
+    auto addChord = [&](const aePointT<T> &a, const aePointT<T> &b) {
+        double d = double(a.x) * double(b.y) - double(a.y) * double(b.x);
+        area += d * 0.5;
+        mx += (double(a.x) + double(b.x)) * d / 6.0;
+        my += (double(a.y) + double(b.y)) * d / 6.0;
+    };
 
-            return false;
+    auto addArc = [&](const aePointT<T> &a, const aePointT<T> &b, const aePointT<T> &c) {
+        Arc circle;
+        if (!circle.fit(a, b, c)) {
+            addChord(a, b);
+            addChord(b, c);
+            return;
+        }
+
+        addChord(a, c);
+
+        double s = circle.segmentArea();
+        double d = circle.segmentCentroid();
+        double am = circle.a0 + circle.sweep * 0.5;
+        area += s;
+        mx += s * (circle.cx + d * std::cos(am));
+        my += s * (circle.cy + d * std::sin(am));
+
+        for (int k = 0; k < 4; ++k) {
+            double angle = k * aePi * 0.5;
+            if (circle.covers(angle)) {
+                T x = Traits::fromReal(circle.cx + circle.r * std::cos(angle));
+                T y = Traits::fromReal(circle.cy + circle.r * std::sin(angle));
+                extent.min.x = std::min(extent.min.x, x);
+                extent.min.y = std::min(extent.min.y, y);
+                extent.max.x = std::max(extent.max.x, x);
+                extent.max.y = std::max(extent.max.y, y);
+            }
         }
     };
 
-    struct Event {
-        enum Type { Invalid, LeftEnd, RightEnd, Intersection } type;
-        aePointT<T> point;
-        Segment *seg1;
-        Segment *seg2;
+    bool compound = (baseType() == CompoundCurve);
+    unsigned int parts = partCount();
 
-        Event() {
-        }
+    for (unsigned int i = 0; i < parts; i = compound ? parts : i + 1) {
+        unsigned int last = compound ? parts : i + 1;
+        unsigned int begin = partBegin(i), end = partEnd(last - 1);
 
-        Event(Type type): type(type), point(), seg1(), seg2() {
+        if (begin < end) {
+            walkCurve(*this, i, last, addChord, addArc);
+            addChord(mPoints[end - 1], mPoints[begin]);
         }
+    }
 
-        Event(
-            Type type,
-            const aePointT<T> &point
-        ): type(type), point(point), seg1(), seg2() {
-        }
+    mExtent = extent;
+    mArea = Real(area);
+    mCentroid = aePointT<Real>(Real(mx / area), Real(my / area));
+    mNeedsUpdate = false;
+}
 
-        Event(
-            Type type,
-            Segment *segment
-        ): type(type), point(), seg1(segment), seg2() {
-        }
+template <typename T>
+aeGeometryT<T>::aeGeometryT(const aeGeometryT<T> &other):
+    mType(other.mType),
+    mPoints(other.mPoints),
+    mParts(other.mParts),
+    mPartTypes(other.mPartTypes),
+    mArea(other.mArea),
+    mCentroid(other.mCentroid),
+    mExtent(other.mExtent),
+    mNeedsUpdate(other.mNeedsUpdate) {
+    std::lock_guard<std::mutex> lock(cacheLock(&other));
+    mLinearized = other.mLinearized;
+}
 
-        bool operator == (const Event &e) const {
-            return point == e.point;
+template <typename T>
+aeGeometryT<T> &aeGeometryT<T>::operator = (const aeGeometryT<T> &other) {
+    if (this != &other) {
+        // copy the cache out first: both geometries may share a lock
+        std::vector< std::pair< Real, std::shared_ptr<const aeGeometryT<T> > > > linearized;
+        {
+            std::lock_guard<std::mutex> lock(cacheLock(&other));
+            linearized = other.mLinearized;
         }
 
-        bool operator < (const Event &e) const {
-            return (
-                point.x == e.point.x
-            ) ? (
-                point.y < e.point.y
-            ) : (
-                point.x < e.point.x
-            );
-        }
-    };
+        mType = other.mType;
+        mPoints = other.mPoints;
+        mParts = other.mParts;
+        mPartTypes = other.mPartTypes;
+        mArea = other.mArea;
+        mCentroid = other.mCentroid;
+        mExtent = other.mExtent;
+        mNeedsUpdate = other.mNeedsUpdate;
+
+        std::lock_guard<std::mutex> lock(cacheLock(this));
+        mLinearized.swap(linearized);
+    }
+    return *this;
+}
 
-    class SweepLine {
-    public:
-        void insert(const Segment * /*seg*/) {
-            //!@todo implement
-        }
+template <typename T>
+std::shared_ptr<const aeGeometryT<T> > aeGeometryT<T>::linearize(Real tolerance) const {
+    typedef aeCoordTraitsT<T> Traits;
 
-        const Segment *above(const Segment * /*seg*/) const {
-            //!@todo implement
-            return nullptr;
-        }
+    if (!isCurve()) {
+        return std::shared_ptr<const aeGeometryT<T> >(this, [](const aeGeometryT<T> *) {});
+    }
+
+    if (!(tolerance > Real())) {
+        throw aeArgumentError("aeGeometry: tolerance must be positive");
+    }
 
-        const Segment *below(const Segment * /*seg*/) const {
-            //!@todo implement
-            return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(cacheLock(this));
+        for (const auto &entry : mLinearized) {
+            if (entry.first == tolerance) {
+                return entry.second;
+            }
         }
+    }
 
-    private:
-    };
+    Type base = baseType();
+    bool compound = (base == CompoundCurve);
+    unsigned int parts = partCount();
 
-    class EventQueue {
-    public:
-        void push(const Event &e) {
-            mEvents.push_back(e);
-            std::push_heap(mEvents.begin(), mEvents.end());
-        }
+    Type type = (base == CurvePolygon) ? Polygon :
+                (compound || parts == 1) ? LineString : MultiLineString;
 
-        Event peek() {
-            return mEvents.front();
-        }
+    std::shared_ptr< aeGeometryT<T> > result =
+        std::make_shared< aeGeometryT<T> >(Type(type | (mType & (HasZ | HasM))));
 
-        Event pop() {
-            Event e = mEvents.front();
-            std::pop_heap(mEvents.begin(), mEvents.end());
-            mEvents.pop_back();
-            return e;
-        }
+    Points &out = result->mPoints;
+
+    auto addLine = [&](const aePointT<T> &, const aePointT<T> &b) {
+        out.push_back(b);
+    };
 
-        bool contains(const Event &e) const {
-            return std::find(mEvents.begin(), mEvents.end(), e) != mEvents.end();
+    auto addArc = [&](const aePointT<T> &a, const aePointT<T> &b, const aePointT<T> &c) {
+        Arc circle;
+        if (!circle.fit(a, b, c)) {
+            out.push_back(b);
+            out.push_back(c);
+            return;
         }
 
-        bool empty() const {
-            return mEvents.empty();
+        unsigned int n = circle.chords(double(tolerance));
+
+        for (unsigned int k = 1; k < n; ++k) {
+            double t = double(k) / double(n);
+            double angle = circle.a0 + circle.sweep * t;
+            out.push_back(aePointT<T>(
+                Traits::fromReal(circle.cx + circle.r * std::cos(angle)),
+                Traits::fromReal(circle.cy + circle.r * std::sin(angle)),
+                Traits::fromReal(double(a.z) + (double(c.z) - double(a.z)) * t),
+                Traits::fromReal(double(a.m) + (double(c.m) - double(a.m)) * t)
+            ));
         }
 
-    private:
-        std::vector<Event> mEvents;
+        out.push_back(c);
     };
 
-/*
-    Initialize event queue EQ = all segment endpoints;
-    Sort EQ by increasing x and y;
-    Initialize sweep line SL to be empty;
-    Initialize output intersection list IL to be empty;
-*/
+    for (unsigned int i = 0; i < parts; i = compound ? parts : i + 1) {
+        unsigned int last = compound ? parts : i + 1;
+        unsigned int begin = partBegin(i);
 
-    intersections.clear();
-
-    SweepLine sweepLine;
-    EventQueue eventQueue;
-
-    unsigned int n = mPoints.size();
+        if (begin < partEnd(last - 1)) {
+            if (parts > 1 && !compound) {
+                result->mParts.push_back(out.size());
+            }
+            out.push_back(mPoints[begin]);
+            walkCurve(*this, i, last, addLine, addArc);
+        }
+    }
 
-    std::vector<Segment> segments;
-    segments.reserve(n);
+    std::lock_guard<std::mutex> lock(cacheLock(this));
 
-    for (unsigned int i = 0, j = 1; i < n; ++i, ++j) {
-        if (j >= n) {
-            j = 0;
+    // another thread may have got here first
+    for (const auto &entry : mLinearized) {
+        if (entry.first == tolerance) {
+            return entry.second;
         }
+    }
 
-        segments.push_back(Segment(mPoints[i], mPoints[j]));
+    if (mLinearized.size() >= 4) {
+        mLinearized.erase(mLinearized.begin());
+    }
+    mLinearized.push_back(std::make_pair(tolerance, result));
 
-        Event l(Event::LeftEnd, &segments.back());
-        Event r(Event::RightEnd, &segments.back());
+    return result;
+}
 
-        if (mPoints[j].x < mPoints[i].x) {
-            l.point = mPoints[j];
-            r.point = mPoints[i];
-        } else {
-            l.point = mPoints[i];
-            r.point = mPoints[j];
+template <typename T>
+bool aeGeometryT<T>::findIntersections(Points &intersections, bool abortOnFirst) const {
+    struct Segment {
+        aePointT<T> a;
+        aePointT<T> b;
+        unsigned int index;
+        unsigned int first;
+        unsigned int last;
+
+        Segment(): a(), b(), index(), first(), last() {}
+        Segment(
+            const aePointT<T> &a,
+            const aePointT<T> &b,
+            unsigned int index,
+            unsigned int first
+        ): a(a), b(b), index(index), first(first), last(index) {}
+
+        static int sign(double d) {
+            return (d > 0.0) - (d < 0.0);
         }
 
-        eventQueue.push(l);
-        eventQueue.push(r);
-    }
+        static bool between(const aePointT<T> &p, const aePointT<T> &q, const aePointT<T> &r) {
+            // q is collinear with p and r; test whether it lies between them
+            return std::min(p.x, r.x) <= q.x && q.x <= std::max(p.x, r.x) &&
+                   std::min(p.y, r.y) <= q.y && q.y <= std::max(p.y, r.y);
+        }
 
-    while (!eventQueue.empty()) {
-        Event e = eventQueue.pop();
+        bool intersects(const Segment &s, bool adjacent, aePointT<T> &p) const {
+            double o1 = aeOrient2d(s.a, s.b, a);
+            double o2 = aeOrient2d(s.a, s.b, b);
+            int d1 = sign(o1), d2 = sign(o2);
+            int d3 = sign(aeOrient2d(a, b, s.a));
+            int d4 = sign(aeOrient2d(a, b, s.b));
 
-        switch (e.type) {
-            case Event::Invalid: {
-                throw aeInternalError("aeGeometry::findIntersections: invalid Event type");
+            if (d1 * d2 < 0 && d3 * d4 < 0) {
+                p = aeLerp(a, b, o1 / (o1 - o2));
+                return true;
             }
 
-            case Event::LeftEnd: {
-                Segment *seg = e.seg1;
-                sweepLine.insert(seg);
-                aePointT<T> p;
-
-                const Segment *above = sweepLine.above(seg);
-                if (above && seg->intersects(*sweepLine.above(seg), p)) {
-                    eventQueue.push(Event(Event::Intersection, p));
+            if (adjacent) {
+                // Adjacent segments always meet at their shared vertex; they
+                // only intersect elsewhere if they fold back over each other.
+                if (d1 != 0 || d2 != 0) {
+                    return false;
                 }
-
-                const Segment *below = sweepLine.below(seg);
-                if (below && seg->intersects(*sweepLine.below(seg), p)) {
-                    eventQueue.push(Event(Event::Intersection, p));
+                bool forward = (b.x == s.a.x && b.y == s.a.y);
+                const aePointT<T> &v = forward ? b : a;
+                const aePointT<T> &q = forward ? a : b;
+                const aePointT<T> &r = forward ? s.b : s.a;
+                // in the wide type, as integer coordinate products overflow
+                typedef typename aeCoordTraitsT<T>::Wide Wide;
+                Wide dot = (Wide(q.x) - Wide(v.x)) * (Wide(r.x) - Wide(v.x)) +
+                           (Wide(q.y) - Wide(v.y)) * (Wide(r.y) - Wide(v.y));
+                if (dot > Wide()) {
+                    p = v;
+                    return true;
                 }
-
-                break;
+                return false;
             }
 
-            case Event::RightEnd: {
-                Segment *seg = e.seg1;
-                sweepLine.insert(seg);
-                aePointT<T> p;
-
-                const Segment *above = sweepLine.above(seg);
-                const Segment *below = sweepLine.below(seg);
-                if (above && below && sweepLine.above(seg)->intersects(*sweepLine.below(seg), p)) {
-                    Event e(Event::Intersection, p);
-                    if (!eventQueue.contains(e)) {
-                        eventQueue.push(e);
-                    }
-                }
+            if (d3 == 0 && between(a, s.a, b)) { p = s.a; return true; }
+            if (d4 == 0 && between(a, s.b, b)) { p = s.b; return true; }
+            if (d1 == 0 && between(s.a, a, s.b)) { p = a; return true; }
+            if (d2 == 0 && between(s.a, b, s.b)) { p = b; return true; }
 
-                break;
-            }
-
-            case Event::Intersection: {
-                intersections.push_back(e.point);
-                //!@todo implement
-                break;
-            }
+            return false;
         }
+    };
 
-/*
-        if (E is a left endpoint) {
-            Let segE = E's segment;
-            Add segE to SL;
-            Let segA = the segment Above segE in SL;
-            Let segB = the segment Below segE in SL;
-            if (I = Intersect( segE with segA) exists) {
-                Insert I into EQ;
+    intersections.clear();
+
+    Type base = baseType();
+    bool closed = (base == Polygon || base == MultiPolygon ||
+                   base == Triangle || base == TIN);
+
+    std::vector<Segment> segments;
+    segments.reserve(mPoints.size());
+
+    for (unsigned int i = 0, parts = partCount(); i < parts; ++i) {
+        unsigned int begin = partBegin(i), end = partEnd(i);
+        unsigned int first = segments.size();
+
+        for (unsigned int k = begin; k < end; ++k) {
+            if (k + 1 == end && !closed) {
+                break;
             }
-            if (I = Intersect( segE with segB) exists) {
-                Insert I into EQ;
+            const aePointT<T> &a = mPoints[k];
+            const aePointT<T> &b = mPoints[(k + 1 < end) ? k + 1 : begin];
+            if (a.x != b.x || a.y != b.y) {
+                segments.push_back(Segment(a, b, segments.size(), first));
             }
         }
-        else if (E is a right endpoint) {
-            Let segE = E's segment;
-            Let segA = the segment Above segE in SL;
-            Let segB = the segment Below segE in SL;
-            Delete segE from SL;
-            if (I = Intersect( segA with segB) exists) {
-                If (I is not in EQ already) {
-                    Insert I into EQ;
-                }
-            }
+
+        for (unsigned int k = first; k < segments.size(); ++k) {
+            segments[k].last = segments.size() - 1;
         }
-        else {  // E is an intersection event
-            Add E’s intersect point to the output list IL;
-            Let segE1 above segE2 be E's intersecting segments in SL;
-            Swap their positions so that segE2 is now above segE1;
-            Let segA = the segment above segE2 in SL;
-            Let segB = the segment below segE1 in SL;
-            if (I = Intersect(segE2 with segA) exists) {
-                if (I is not in EQ already) {
-                    Insert I into EQ;
-                }
-            }
-            if (I = Intersect(segE1 with segB) exists) {
-                if (I is not in EQ already) {
-                    Insert I into EQ;
-                }
+    }
+
+    aeSweepT<T> sweep;
+    sweep.reserve(segments.size());
+
+    for (const Segment &seg : segments) {
+        sweep.insert(seg.a, seg.b);
+    }
+
+    sweep.run(
+        [&](unsigned int i, unsigned int j) -> bool {
+            const Segment &s1 = segments[i], &s2 = segments[j];
+
+            unsigned int lo = std::min(s1.index, s2.index);
+            unsigned int hi = std::max(s1.index, s2.index);
+            bool adjacent = (s1.first == s2.first) && (
+                (hi - lo == 1) ||
+                (closed && lo == s1.first && hi == s1.last)
+            );
+
+            aePointT<T> p;
+            if (s2.intersects(s1, adjacent, p)) {
+                intersections.push_back(p);
+                return abortOnFirst;
             }
+
+            return false;
         }
-*/
+    );
+
+    if (abortOnFirst) {
+        return intersections.size() > 0;
     }
 
-    throw aeNotImplementedError();
-    return false;
+    std::sort(intersections.begin(), intersections.end(),
+        [](const aePointT<T> &p, const aePointT<T> &q) {
+            return (p.x == q.x) ? (p.y < q.y) : (p.x < q.x);
+        }
+    );
+    intersections.erase(
+        std::unique(intersections.begin(), intersections.end()),
+        intersections.end()
+    );
 
     return intersections.size() > 0;
 }
@@ -309,6 +530,7 @@ bool aeGeometryT<T>::findIntersections(Points &intersections, bool /*abortOnFirs
 
 template class aeGeometryT<double>;
 template class aeGeometryT<float>;
+template class aeGeometryT<int32_t>;
 
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
@@ -7,11 +7,15 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "aecoord.hpp"
 #include "aeextent.hpp"
 #include "aepoint.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cinttypes>
+#include <memory>
+#include <utility>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -44,25 +48,86 @@ public:
     };
 
     typedef std::vector< aePointT<T> > Points;
+    typedef std::vector<unsigned int> Parts;
+    typedef std::vector<Type> PartTypes;
+
+    // Area and centroid are exact sums for integer coordinates, so they are
+    // reported in a wider type than the coordinates themselves
+    typedef typename aeCoordTraitsT<T>::Real Real;
 
 public:
     aeGeometryT(Type type): mType(type), mNeedsUpdate(true) {}
 
-    Points &points() { return mPoints; }
+    /**
+     * Copies take the source's linearization cache under its lock, so a
+     * geometry may be copied while another thread linearizes it.
+     */
+    aeGeometryT(const aeGeometryT<T> &other);
+    aeGeometryT(aeGeometryT<T> &&other) = default;
+
+    aeGeometryT<T> &operator = (const aeGeometryT<T> &other);
+    aeGeometryT<T> &operator = (aeGeometryT<T> &&other) = default;
+
+    Points &points() { invalidate(); return mPoints; }
     const Points &points() const { return mPoints; }
 
+    /**
+     * Index of the first point of each part (ring, line, etc.); an empty list
+     * means the geometry has a single part.
+     */
+    Parts &parts() { invalidate(); return mParts; }
+    const Parts &parts() const { return mParts; }
+
+    /**
+     * Segment type of each part of a curve, either LineString or
+     * CircularString; an empty list means every part is circular in a
+     * CircularString and linear otherwise.  A circular part is a chain of
+     * arcs, each through three points, sharing their end points.  The parts
+     * of a CompoundCurve are joined end to end into a single curve, and the
+     * parts of a CurvePolygon are its rings.  Each ring of a CurvePolygon is
+     * therefore wholly linear or wholly circular: a ring mixing the two, as
+     * a CompoundCurve ring would, cannot be expressed.
+     */
+    PartTypes &partTypes() { invalidate(); return mPartTypes; }
+    const PartTypes &partTypes() const { return mPartTypes; }
+
+    Type partType(unsigned int i) const {
+        if (i < mPartTypes.size()) {
+            return mPartTypes[i];
+        }
+        return (baseType() == CircularString) ? CircularString : LineString;
+    }
+
+    unsigned int partCount() const {
+        return mParts.empty() ? 1 : mParts.size();
+    }
+
+    unsigned int partBegin(unsigned int i) const {
+        return mParts.empty() ? 0 : mParts[i];
+    }
+
+    unsigned int partEnd(unsigned int i) const {
+        return (i + 1 < mParts.size()) ? mParts[i + 1] : mPoints.size();
+    }
+
 private:
+    void invalidate() {
+        mNeedsUpdate = true;
+        mLinearized.clear();
+    }
+
     void update() const;
+    void updateCurve() const;
 
 public:
-    const T &area() const {
+    const Real &area() const {
         if (mNeedsUpdate) {
             update();
         }
         return mArea;
     }
 
-    const aePointT<T> &centroid() const {
+    const aePointT<Real> &centroid() const {
         if (mNeedsUpdate) {
             update();
         }
@@ -77,9 +142,25 @@ public:
     }
 
     Type type() const { return mType; }
+    Type baseType() const { return Type(mType & ~(HasZ | HasM)); }
     bool hasZ() const { return mType & HasZ; }
     bool hasM() const { return mType & HasM; }
 
+    bool isCurve() const {
+        Type base = baseType();
+        return base == CircularString || base == CompoundCurve || base == CurvePolygon;
+    }
+
+    /**
+     * Returns an approximation of a curve geometry made of straight segments,
+     * deviating from each arc by at most the given tolerance (a LineString,
+     * MultiLineString or Polygon).  Results are cached per tolerance, and the
+     * returned pointer keeps its result alive after it leaves the cache.
+     * Geometries without arcs are returned as they are, by a pointer that
+     * does not own them.  Safe to call from several threads at once.
+     */
+    std::shared_ptr<const aeGeometryT<T> > linearize(Real tolerance) const;
+
 private:
     bool findIntersections(Points &intersections, bool abortOnFirst) const;
 
@@ -96,15 +177,19 @@ public:
 private:
     Type mType;
     Points mPoints;
-    mutable T mArea;
-    mutable aePointT<T> mCentroid;
+    Parts mParts;
+    PartTypes mPartTypes;
+    mutable Real mArea;
+    mutable aePointT<Real> mCentroid;
     mutable aeExtentT<T> mExtent;
     mutable bool mNeedsUpdate;
+    mutable std::vector< std::pair< Real, std::shared_ptr<const aeGeometryT<T> > > > mLinearized;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef aeGeometryT<double> aeGeometry;
+typedef aeGeometryT<int32_t> aeFixedGeometry;
 
 ////////////////////////////////////////////////////////////////////////////////
 
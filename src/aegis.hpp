@@ -7,19 +7,35 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "aeaffine.hpp"
+#include "aecodec.hpp"
 #include "aeconst.hpp"
+#include "aecoord.hpp"
 #include "aecurve.hpp"
+#include "aedatum.hpp"
+#include "aeepsg.hpp"
 #include "aeexcept.hpp"
 #include "aeextent.hpp"
+#include "aegeodesic.hpp"
 #include "aegeom.hpp"
+#include "aegrid.hpp"
 #include "aeindex.hpp"
 #include "aelayer.hpp"
+#include "aeoverlay.hpp"
+#include "aepacked.hpp"
+#include "aeparallel.hpp"
 #include "aepoint.hpp"
+#include "aepred.hpp"
 #include "aeproj.hpp"
+#include "aequant.hpp"
 #include "aescript.hpp"
 #include "aestats.hpp"
 #include "aestream.hpp"
+#include "aesweep.hpp"
 #include "aesymbol.hpp"
+#include "aetess.hpp"
+#include "aetile.hpp"
+#include "aetmerc.hpp"
 #include "aetypes.hpp"
 #include "aeuuid.hpp"
 
@@ -0,0 +1,452 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegrid.hpp"
+#include "aeconst.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+static const std::size_t ntv2RecordSize = 16;
+static const std::size_t gtxHeaderSize = 40;
+static const double gtxNoData = -88.8888;
+
+uint32_t swap32(uint32_t v) {
+    return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+}
+
+uint64_t swap64(uint64_t v) {
+    return (uint64_t(swap32(uint32_t(v))) << 32) | swap32(uint32_t(v >> 32));
+}
+
+bool hostIsBigEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 0;
+}
+
+/*
+ * Unaligned reads from the mapping, swapping bytes if asked.
+ */
+uint32_t readUInt32(const uint8_t *p, bool swap) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return swap ? swap32(v) : v;
+}
+
+float readFloat(const uint8_t *p, bool swap) {
+    uint32_t v = readUInt32(p, swap);
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+double readDouble(const uint8_t *p, bool swap) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if (swap) {
+        v = swap64(v);
+    }
+    double d;
+    std::memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+/*
+ * NTv2 strings are eight characters, padded with spaces or nulls.
+ */
+std::string readName(const uint8_t *p) {
+    std::string s(reinterpret_cast<const char*>(p), 8);
+    std::size_t end = s.find_last_not_of(std::string(" \0", 2));
+    return (end == std::string::npos) ? std::string() : s.substr(0, end + 1);
+}
+
+const uint8_t *mapStream(
+    const std::shared_ptr<aeInputStream> &stream,
+    std::size_t &size
+) {
+    const void *data = stream ? stream->map() : nullptr;
+    if (!data) {
+        throw aeArgumentError("grid stream cannot be mapped");
+    }
+    size = std::size_t(stream->length());
+    return static_cast<const uint8_t*>(data);
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeGridShift::aeGridShift(
+    const std::string &filename
+): mStream(std::make_shared<aeMappedInputStream>(filename)) {
+    load();
+}
+
+aeGridShift::aeGridShift(
+    const std::shared_ptr<aeInputStream> &stream
+): mStream(stream) {
+    load();
+}
+
+/*
+ * Parses the overview header and each sub-grid header, skipping over the
+ * shift records.  Nothing but the headers is touched.
+ */
+void aeGridShift::load() {
+    mData = mapStream(mStream, mSize);
+
+    if (mSize < 11 * ntv2RecordSize) {
+        throw aeArgumentError("aeGridShift: file too short");
+    }
+
+    // NUM_OREC is 11, which tells the byte order
+    uint32_t numOrec = readUInt32(mData + 8, false);
+    if (numOrec == 11) {
+        mSwap = false;
+    } else if (swap32(numOrec) == 11) {
+        mSwap = true;
+        numOrec = 11;
+    } else {
+        throw aeArgumentError("aeGridShift: not an NTv2 file");
+    }
+
+    uint32_t numSrec = readUInt32(mData + 24, mSwap);
+    uint32_t numFile = readUInt32(mData + 40, mSwap);
+
+    if (readName(mData + 56) != "SECONDS") {
+        throw aeArgumentError("aeGridShift: only GS_TYPE SECONDS is supported");
+    }
+
+    mSourceName = readName(mData + 88);
+    mTargetName = readName(mData + 104);
+
+    const double unit = 1.0 / 3600.0;
+    std::size_t offset = numOrec * ntv2RecordSize;
+    std::vector<std::string> parents;
+
+    for (uint32_t i = 0; i < numFile; ++i) {
+        if (offset + numSrec * ntv2RecordSize > mSize || numSrec < 11) {
+            throw aeArgumentError("aeGridShift: truncated sub-grid header");
+        }
+
+        const uint8_t *h = mData + offset;
+        SubGrid g;
+        g.name = readName(h + 8);
+        parents.push_back(readName(h + 24));
+
+        // longitudes are positive west in the file
+        g.minLat = readDouble(h + 72, mSwap) * unit;
+        g.maxLat = readDouble(h + 88, mSwap) * unit;
+        g.maxLon = -readDouble(h + 104, mSwap) * unit;
+        g.minLon = -readDouble(h + 120, mSwap) * unit;
+        g.dLat = readDouble(h + 136, mSwap) * unit;
+        g.dLon = readDouble(h + 152, mSwap) * unit;
+        uint32_t count = readUInt32(h + 168, mSwap);
+
+        if (!(g.dLat > 0.0) || !(g.dLon > 0.0) ||
+            !(g.maxLat > g.minLat) || !(g.maxLon > g.minLon)) {
+            throw aeArgumentError("aeGridShift: invalid sub-grid " + g.name);
+        }
+
+        // range-checked as doubles, since a corrupt header can give a ratio
+        // too large to convert; interpolation needs two rows and columns
+        double rows = std::floor((g.maxLat - g.minLat) / g.dLat + 0.5) + 1.0;
+        double columns = std::floor((g.maxLon - g.minLon) / g.dLon + 0.5) + 1.0;
+
+        if (!(rows >= 2.0 && rows <= double(count)) ||
+            !(columns >= 2.0 && columns <= double(count))) {
+            throw aeArgumentError("aeGridShift: invalid sub-grid " + g.name);
+        }
+
+        g.rows = uint32_t(rows);
+        g.columns = uint32_t(columns);
+        g.offset = offset + numSrec * ntv2RecordSize;
+
+        if (uint64_t(g.rows) * g.columns != count ||
+            g.offset + std::size_t(count) * ntv2RecordSize > mSize) {
+            throw aeArgumentError("aeGridShift: invalid sub-grid " + g.name);
+        }
+
+        mGrids.push_back(g);
+        offset = g.offset + std::size_t(count) * ntv2RecordSize;
+    }
+
+    // nest each sub-grid under its parent, in file order
+    for (std::size_t i = 0; i < mGrids.size(); ++i) {
+        if (parents[i] == "NONE") {
+            mRoots.push_back(i);
+            mExtent |= aePoint(mGrids[i].minLon, mGrids[i].minLat);
+            mExtent |= aePoint(mGrids[i].maxLon, mGrids[i].maxLat);
+            continue;
+        }
+
+        std::size_t p = 0;
+        while (p < mGrids.size() && mGrids[p].name != parents[i]) {
+            ++p;
+        }
+        if (p == mGrids.size() || p == i) {
+            throw aeArgumentError("aeGridShift: missing parent of sub-grid " + mGrids[i].name);
+        }
+        mGrids[p].children.push_back(i);
+    }
+}
+
+/*
+ * Finds the finest sub-grid containing a point.  The last grid used is
+ * tried first, since successive points are usually close together.
+ */
+const aeGridShift::SubGrid *aeGridShift::find(double lon, double lat, const SubGrid *hint) const {
+    if (hint && hint->children.empty() && hint->contains(lon, lat)) {
+        return hint;
+    }
+
+    const SubGrid *found = nullptr;
+    const std::vector<std::size_t> *candidates = &mRoots;
+
+    while (candidates) {
+        const std::vector<std::size_t> *next = nullptr;
+        for (std::size_t i : *candidates) {
+            if (mGrids[i].contains(lon, lat)) {
+                found = &mGrids[i];
+                next = &found->children;
+                break;
+            }
+        }
+        candidates = next;
+    }
+    return found;
+}
+
+float aeGridShift::value(std::size_t offset) const {
+    return readFloat(mData + offset, mSwap);
+}
+
+void aeGridShift::shift(const SubGrid &g, double lon, double lat, double &dlon, double &dlat) const {
+    // columns run west from the eastern edge, rows north from the south
+    double u = (g.maxLon - lon) / g.dLon;
+    double v = (lat - g.minLat) / g.dLat;
+    uint32_t i = std::min(uint32_t(u), g.columns - 2);
+    uint32_t j = std::min(uint32_t(v), g.rows - 2);
+    u -= i;
+    v -= j;
+
+    std::size_t r00 = g.offset + (std::size_t(j) * g.columns + i) * ntv2RecordSize;
+    std::size_t r10 = r00 + ntv2RecordSize;
+    std::size_t r01 = r00 + std::size_t(g.columns) * ntv2RecordSize;
+    std::size_t r11 = r01 + ntv2RecordSize;
+
+    double w00 = (1.0 - u) * (1.0 - v), w10 = u * (1.0 - v);
+    double w01 = (1.0 - u) * v,         w11 = u * v;
+
+    // shifts are in arc-seconds, longitude positive west
+    dlat = (w00 * value(r00) + w10 * value(r10) +
+            w01 * value(r01) + w11 * value(r11)) / 3600.0;
+    dlon = -(w00 * value(r00 + 4) + w10 * value(r10 + 4) +
+             w01 * value(r01 + 4) + w11 * value(r11 + 4)) / 3600.0;
+}
+
+bool aeGridShift::forward(double &lon, double &lat, const SubGrid *&hint) const {
+    hint = find(lon, lat, hint);
+    if (!hint) {
+        return false;
+    }
+
+    double dlon, dlat;
+    shift(*hint, lon, lat, dlon, dlat);
+    lon += dlon;
+    lat += dlat;
+    return true;
+}
+
+/*
+ * Solves x + shift(x) = p by fixed-point iteration; shifts vary slowly
+ * enough across a grid that a few steps reach double precision.
+ */
+bool aeGridShift::backward(double &lon, double &lat, const SubGrid *&hint) const {
+    hint = find(lon, lat, hint);
+    if (!hint) {
+        return false;
+    }
+
+    double x = lon, y = lat;
+    for (int i = 0; i < 10; ++i) {
+        const SubGrid *g = find(x, y, hint);
+        if (!g) {
+            break;
+        }
+        hint = g;
+
+        double dlon, dlat;
+        shift(*g, x, y, dlon, dlat);
+        double nx = lon - dlon, ny = lat - dlat;
+        bool done = std::fabs(nx - x) < 1e-12 && std::fabs(ny - y) < 1e-12;
+        x = nx;
+        y = ny;
+        if (done) {
+            break;
+        }
+    }
+
+    lon = x;
+    lat = y;
+    return true;
+}
+
+bool aeGridShift::apply(double &lon, double &lat) const {
+    const SubGrid *hint = nullptr;
+    return forward(lon, lat, hint);
+}
+
+bool aeGridShift::inverse(double &lon, double &lat) const {
+    const SubGrid *hint = nullptr;
+    return backward(lon, lat, hint);
+}
+
+template <typename T>
+std::size_t aeGridShift::apply(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const {
+    const SubGrid *hint = nullptr;
+    std::size_t shifted = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        aePointT<T> p = in[i];
+        double lon = p.x, lat = p.y;
+        if (forward(lon, lat, hint)) {
+            p.x = T(lon);
+            p.y = T(lat);
+            ++shifted;
+        }
+        out[i] = p;
+    }
+    return shifted;
+}
+
+template <typename T>
+std::size_t aeGridShift::inverse(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const {
+    const SubGrid *hint = nullptr;
+    std::size_t shifted = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        aePointT<T> p = in[i];
+        double lon = p.x, lat = p.y;
+        if (backward(lon, lat, hint)) {
+            p.x = T(lon);
+            p.y = T(lat);
+            ++shifted;
+        }
+        out[i] = p;
+    }
+    return shifted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeGeoidGrid::aeGeoidGrid(
+    const std::string &filename
+): mStream(std::make_shared<aeMappedInputStream>(filename)) {
+    load();
+}
+
+aeGeoidGrid::aeGeoidGrid(
+    const std::shared_ptr<aeInputStream> &stream
+): mStream(stream) {
+    load();
+}
+
+/*
+ * The header is big-endian: origin latitude and longitude, spacing in
+ * latitude and longitude (all degrees), then the row and column counts.
+ * Rows run north from the origin and columns east.
+ */
+void aeGeoidGrid::load() {
+    mData = mapStream(mStream, mSize);
+
+    if (mSize < gtxHeaderSize) {
+        throw aeArgumentError("aeGeoidGrid: file too short");
+    }
+
+    const bool swap = !hostIsBigEndian();
+    mLat0 = readDouble(mData, swap);
+    mLon0 = readDouble(mData + 8, swap);
+    mDLat = readDouble(mData + 16, swap);
+    mDLon = readDouble(mData + 24, swap);
+    mRows = readUInt32(mData + 32, swap);
+    mColumns = readUInt32(mData + 36, swap);
+
+    // divide rather than multiply so that huge counts cannot wrap
+    const uint64_t cells = (mSize - gtxHeaderSize) / 4;
+
+    if (!(mDLat > 0.0) || !(mDLon > 0.0) || mRows < 2 || mColumns < 2 ||
+        mRows > cells || mColumns > cells / mRows) {
+        throw aeArgumentError("aeGeoidGrid: invalid GTX header");
+    }
+
+    mGlobal = mColumns * mDLon >= 360.0 - 1e-9;
+    mExtent = aeExtent(aePoint(mLon0, mLat0),
+                       aePoint(mLon0 + (mColumns - 1) * mDLon, mLat0 + (mRows - 1) * mDLat));
+}
+
+float aeGeoidGrid::value(uint32_t row, uint32_t column) const {
+    std::size_t offset = gtxHeaderSize + (std::size_t(row) * mColumns + column) * 4;
+    return readFloat(mData + offset, !hostIsBigEndian());
+}
+
+double aeGeoidGrid::height(double lon, double lat) const {
+    // longitudes may be given in either -180..180 or 0..360
+    double x = std::fmod(lon - mLon0, 360.0);
+    if (x < 0.0) {
+        x += 360.0;
+    }
+
+    double u = x / mDLon;
+    double v = (lat - mLat0) / mDLat;
+
+    if (!(v >= 0.0 && v <= mRows - 1) || !(u <= (mGlobal ? mColumns : mColumns - 1))) {
+        return aeNaN;
+    }
+
+    uint32_t i = std::min(uint32_t(u), mGlobal ? mColumns - 1 : mColumns - 2);
+    uint32_t j = std::min(uint32_t(v), mRows - 2);
+    uint32_t i1 = (i + 1 < mColumns) ? i + 1 : 0;
+    u -= i;
+    v -= j;
+
+    double h00 = value(j, i), h10 = value(j, i1);
+    double h01 = value(j + 1, i), h11 = value(j + 1, i1);
+
+    if (std::fabs(h00 - gtxNoData) < 1e-3 || std::fabs(h10 - gtxNoData) < 1e-3 ||
+        std::fabs(h01 - gtxNoData) < 1e-3 || std::fabs(h11 - gtxNoData) < 1e-3) {
+        return aeNaN;
+    }
+
+    return (1.0 - v) * ((1.0 - u) * h00 + u * h10) + v * ((1.0 - u) * h01 + u * h11);
+}
+
+template <typename T>
+void aeGeoidGrid::height(const aePointT<T> *points, double *heights, std::size_t count) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        heights[i] = height(points[i].x, points[i].y);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template std::size_t aeGridShift::apply<double>(const aePointT<double> *, aePointT<double> *, std::size_t) const;
+template std::size_t aeGridShift::apply<float>(const aePointT<float> *, aePointT<float> *, std::size_t) const;
+template std::size_t aeGridShift::inverse<double>(const aePointT<double> *, aePointT<double> *, std::size_t) const;
+template std::size_t aeGridShift::inverse<float>(const aePointT<float> *, aePointT<float> *, std::size_t) const;
+
+template void aeGeoidGrid::height<double>(const aePointT<double> *, double *, std::size_t) const;
+template void aeGeoidGrid::height<float>(const aePointT<float> *, double *, std::size_t) const;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEGRID_HPP_INCLUDE_GUARD
+#define AEGRID_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeextent.hpp"
+#include "aepoint.hpp"
+#include "aestream.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A horizontal grid shift in NTv2 format (.gsb), as published for
+//  NAD27 to NAD83, OSTN15, ED50 to ETRS89 and others.  The grid is read in
+//  place from a stream that can be mapped into memory (see
+//  aeInputStream::map()): only the headers are parsed when it is opened,
+//  into a small index of the sub-grids and their nesting, and the shift
+//  records are read straight from the mapping as points need them.  For a
+//  memory-mapped file that means only the pages holding the nodes around
+//  the points actually shifted are ever read from disk.  Files of either
+//  byte order are accepted.
+//
+//  Coordinates are (longitude, latitude) in degrees, longitude positive
+//  east.  Each point is shifted by bilinear interpolation in the finest
+//  sub-grid containing it; points outside every sub-grid are not shifted.
+
+class aeGridShift {
+public:
+    /**
+     * Maps a file by its native path; throws aeStreamError if it cannot be
+     * opened and aeArgumentError if it is not a valid NTv2 file.
+     */
+    aeGridShift(const std::string &filename);
+
+    /**
+     * Reads a grid from a stream, which must support map(); it is held for
+     * the lifetime of the grid.  Throws aeArgumentError otherwise, or if the
+     * contents are not a valid NTv2 file.
+     */
+    aeGridShift(const std::shared_ptr<aeInputStream> &stream);
+
+    const std::string &sourceName() const { return mSourceName; }
+    const std::string &targetName() const { return mTargetName; }
+
+    std::size_t gridCount() const { return mGrids.size(); }
+
+    /**
+     * Extent of the top-level sub-grids.
+     */
+    const aeExtent &extent() const { return mExtent; }
+
+    /**
+     * Shifts a point from the source datum to the target, returning false
+     * (and leaving it unchanged) if it is outside the grid.
+     */
+    bool apply(double &lon, double &lat) const;
+
+    /**
+     * Shifts a point from the target datum back to the source by iterating
+     * the forward shift.
+     */
+    bool inverse(double &lon, double &lat) const;
+
+    /**
+     * Shifts count points, returning the number inside the grid; in and out
+     * may be the same buffer.  Z and M values are unchanged.
+     */
+    template <typename T>
+    std::size_t apply(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const;
+
+    template <typename T>
+    std::size_t inverse(const aePointT<T> *in, aePointT<T> *out, std::size_t count) const;
+
+private:
+    struct SubGrid {
+        std::string name;
+        double minLon, minLat, maxLon, maxLat;
+        double dLon, dLat;
+        uint32_t columns, rows;
+        std::size_t offset;         // of the first record
+        std::vector<std::size_t> children;
+
+        bool contains(double lon, double lat) const {
+            return lon >= minLon && lon <= maxLon && lat >= minLat && lat <= maxLat;
+        }
+    };
+
+    void load();
+    bool forward(double &lon, double &lat, const SubGrid *&hint) const;
+    bool backward(double &lon, double &lat, const SubGrid *&hint) const;
+    const SubGrid *find(double lon, double lat, const SubGrid *hint) const;
+    void shift(const SubGrid &grid, double lon, double lat, double &dlon, double &dlat) const;
+    float value(std::size_t offset) const;
+
+private:
+    std::shared_ptr<aeInputStream> mStream;
+    const uint8_t *mData;
+    std::size_t mSize;
+    bool mSwap;
+    std::string mSourceName;
+    std::string mTargetName;
+    std::vector<SubGrid> mGrids;
+    std::vector<std::size_t> mRoots;
+    aeExtent mExtent;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A geoid or other vertical reference surface in the GTX format used
+//  by PROJ and NOAA: a regular grid of heights above the ellipsoid, in
+//  metres.  As with aeGridShift the file is read in place from a mapped
+//  stream and only the header is parsed up front.  Heights are interpolated
+//  bilinearly; grids spanning 360 degrees of longitude wrap around.  Points
+//  outside the grid, or next to a node with no data, have a NaN height.
+
+class aeGeoidGrid {
+public:
+    aeGeoidGrid(const std::string &filename);
+    aeGeoidGrid(const std::shared_ptr<aeInputStream> &stream);
+
+    const aeExtent &extent() const { return mExtent; }
+
+    double height(double lon, double lat) const;
+
+    /**
+     * Heights at count points.
+     */
+    template <typename T>
+    void height(const aePointT<T> *points, double *heights, std::size_t count) const;
+
+private:
+    void load();
+    float value(uint32_t row, uint32_t column) const;
+
+private:
+    std::shared_ptr<aeInputStream> mStream;
+    const uint8_t *mData;
+    std::size_t mSize;
+    double mLon0, mLat0;
+    double mDLon, mDLat;
+    uint32_t mRows, mColumns;
+    bool mGlobal;
+    aeExtent mExtent;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEGRID_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -3,6 +3,95 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aelayer.hpp"
+#include "aeparallel.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    const uint32_t NotPacked = 0xFFFFFFFF;
+}
+
+aeExtent aeLayer::extent(unsigned int threads) const {
+    // Geometries cache their extent on first use, so each one must be
+    // visited by a single thread even if features share it
+    std::vector<const aeGeometry *> geometries;
+    std::vector<uint32_t> packed;
+    geometries.reserve(mFeatures.size());
+
+    for (std::size_t i = 0; i < mFeatures.size(); ++i) {
+        if (mFeatures[i].geometry) {
+            geometries.push_back(mFeatures[i].geometry);
+        } else if (i < mPackedIndex.size() && mPackedIndex[i] != NotPacked) {
+            packed.push_back(mPackedIndex[i]);
+        }
+    }
+
+    std::sort(geometries.begin(), geometries.end());
+    geometries.erase(std::unique(geometries.begin(), geometries.end()), geometries.end());
+    std::sort(packed.begin(), packed.end());
+    packed.erase(std::unique(packed.begin(), packed.end()), packed.end());
+
+    const std::size_t count = geometries.size();
+
+    return aeParallelReduce<aeExtent>(count + packed.size(), 1024, threads,
+        [this, &geometries, &packed, count](std::size_t begin, std::size_t end) {
+            aeExtent extent;
+            for (std::size_t i = begin; i < end; ++i) {
+                extent |= (i < count) ? geometries[i]->extent() :
+                                        mPacked[packed[i - count]].extent();
+            }
+            return extent;
+        },
+        [](aeExtent &result, const aeExtent &partial) {
+            result |= partial;
+        }
+    );
+}
+
+void aeLayer::pack() {
+    std::map<const aeGeometry *, uint32_t> seen;
+
+    mPackedIndex.resize(mFeatures.size(), NotPacked);
+
+    for (std::size_t i = 0; i < mFeatures.size(); ++i) {
+        aeFeature &feature = mFeatures[i];
+        if (!feature.geometry) {
+            continue;
+        }
+
+        std::pair<std::map<const aeGeometry *, uint32_t>::iterator, bool> r =
+            seen.insert(std::make_pair(feature.geometry, uint32_t(mPacked.size())));
+        if (r.second) {
+            mPacked.push_back(aePackedGeometry(*feature.geometry));
+        }
+
+        mPackedIndex[i] = r.first->second;
+        feature.geometry = nullptr;
+    }
+}
+
+const aePackedGeometry *aeLayer::packedGeometry(std::size_t i) const {
+    if (i < mPackedIndex.size() && mPackedIndex[i] != NotPacked) {
+        return &mPacked[mPackedIndex[i]];
+    }
+    return nullptr;
+}
+
+aeGeometry aeLayer::geometry(std::size_t i) const {
+    if (mFeatures[i].geometry) {
+        return *mFeatures[i].geometry;
+    }
+    if (const aePackedGeometry *packed = packedGeometry(i)) {
+        return packed->unpack();
+    }
+    return aeGeometry(aeGeometry::Geometry);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
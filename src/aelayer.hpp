@@ -8,11 +8,18 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aegeom.hpp"
+#include "aepacked.hpp"
+#include "aequant.hpp"
 #include "aesymbol.hpp"
 #include "aetypes.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cinttypes>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
 struct aeFeature {
     aeObjectID id;
     aeGeometry *geometry;
@@ -21,8 +28,46 @@ struct aeFeature {
 
 class aeLayer {
 public:
+    std::vector<aeFeature> &features() { return mFeatures; }
+    const std::vector<aeFeature> &features() const { return mFeatures; }
+
+    /**
+     * Computes the extent of every feature's geometry, splitting the features
+     * across threads for large layers (zero uses the hardware concurrency).
+     */
+    aeExtent extent(unsigned int threads = 0) const;
+
+    /**
+     * Copies each feature's geometry into the layer's own storage, keeping
+     * only the coordinates its type carries (see aePackedPointsT), and
+     * clears the feature's pointer so that the original may be freed.
+     * Features sharing a geometry share its packed copy.
+     */
+    void pack();
+
+    /**
+     * The packed geometry of feature i, or null if it has none.
+     */
+    const aePackedGeometry *packedGeometry(std::size_t i) const;
+
+    /**
+     * A copy of feature i's geometry, whether held by pointer or packed;
+     * an empty Geometry if it has neither.
+     */
+    aeGeometry geometry(std::size_t i) const;
+
+    /**
+     * Transform between this layer's coordinates and the 32-bit integer
+     * coordinates used to store them compactly.
+     */
+    const aeQuantization &quantization() const { return mQuantization; }
+    void quantization(const aeQuantization &q) { mQuantization = q; }
+
 private:
     std::vector<aeFeature> mFeatures;
+    std::vector<aePackedGeometry> mPacked;
+    std::vector<uint32_t> mPackedIndex;
+    aeQuantization mQuantization;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
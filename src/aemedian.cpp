@@ -3,13 +3,433 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aemedian.hpp"
+#include "aecodec.hpp"
+#include "aeexcept.hpp"
+#include "aestream.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    // Level capacities shrink by this factor below the top level
+    static const double CapacityRatio = 2.0 / 3.0;
+
+    static const unsigned int MinK = 8;
+    static const std::size_t MaxLevels = 64;
+
+    bool bigEndian() {
+        const uint16_t one = 1;
+        uint8_t first;
+        std::memcpy(&first, &one, 1);
+        return first == 0;
+    }
+
+    template <typename T>
+    void putValue(const T &value, std::vector<uint8_t> &buffer) {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if (bigEndian()) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T getValue(const uint8_t *data) {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, data, sizeof(T));
+        if (bigEndian()) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename N>
+aeQuantileSketchT<T, N>::aeQuantileSketchT(unsigned int k): mK(k) {
+    if (k < MinK) {
+        throw aeArgumentError("aeQuantileSketch: k must be at least 8");
+    }
+    clear();
+}
+
+template <typename T, typename N>
+void aeQuantileSketchT<T, N>::clear() {
+    mN = N();
+    mMin = mMax = T(aeNaN);
+    mSize = 0;
+    mRandom = UINT64_C(0x9e3779b97f4a7c15);
+    mLevels.clear();
+    grow();
+}
+
+template <typename T, typename N>
+std::size_t aeQuantileSketchT<T, N>::capacity(std::size_t level) const {
+    double depth = double(mLevels.size() - level - 1);
+    return std::size_t(std::ceil(mK * std::pow(CapacityRatio, depth))) + 1;
+}
+
+template <typename T, typename N>
+void aeQuantileSketchT<T, N>::grow() {
+    mLevels.push_back(std::vector<T>());
+    mMaxSize = 0;
+    for (std::size_t h = 0; h < mLevels.size(); ++h) {
+        mMaxSize += capacity(h);
+    }
+    mLevels[0].reserve(capacity(0));
+}
+
+template <typename T, typename N>
+bool aeQuantileSketchT<T, N>::coin() {
+    // xorshift64
+    mRandom ^= mRandom << 13;
+    mRandom ^= mRandom >> 7;
+    mRandom ^= mRandom << 17;
+    return mRandom & 1;
+}
+
+/*
+ * Compacts full levels from the bottom up until the sketch is back under
+ * its capacity.  A compaction sorts the level and promotes every other
+ * value to the next level from a random offset; with an odd count the
+ * smallest value stays behind, so the total weight is unchanged.
+ */
+template <typename T, typename N>
+void aeQuantileSketchT<T, N>::compress() {
+    for (std::size_t h = 0; h < mLevels.size(); ++h) {
+        if (mLevels[h].size() < capacity(h)) {
+            continue;
+        }
+
+        if (h + 1 >= mLevels.size()) {
+            grow();
+        }
+
+        std::vector<T> &level = mLevels[h];
+        std::vector<T> &next = mLevels[h + 1];
+        std::sort(level.begin(), level.end());
+
+        std::size_t n = level.size();
+        std::size_t first = n & 1;
+
+        for (std::size_t i = first + (coin() ? 1 : 0); i < n; i += 2) {
+            next.push_back(level[i]);
+        }
+
+        level.resize(first);
+        mSize -= (n - first) / 2;
+
+        if (mSize < mMaxSize) {
+            break;
+        }
+    }
+}
+
+template <typename T, typename N>
+aeQuantileSketchT<T, N> &aeQuantileSketchT<T, N>::update(const T &x) {
+    if (x != x) {
+        return *this;
+    }
+
+    if (mN == 0) {
+        mMin = mMax = x;
+    } else {
+        if (mMin > x) { mMin = x; }
+        if (mMax < x) { mMax = x; }
+    }
+
+    mLevels[0].push_back(x);
+    ++mN;
+
+    if (++mSize >= mMaxSize) {
+        compress();
+    }
+
+    return *this;
+}
+
+template <typename T, typename N>
+aeQuantileSketchT<T, N> &aeQuantileSketchT<T, N>::update(const T *data, std::size_t count) {
+    std::size_t i = 0;
+
+    while (i < count) {
+        // runs of values go straight into the lowest level, up to the point
+        // where the sketch must be compressed
+        std::size_t run = std::min(count - i, mMaxSize - mSize);
+        std::vector<T> &level = mLevels[0];
+        std::size_t added = 0;
+
+        for (std::size_t end = i + run; i < end; ++i) {
+            const T &x = data[i];
+            if (x == x) {
+                if (mN + added == 0) {
+                    mMin = mMax = x;
+                } else {
+                    mMin = (x < mMin) ? x : mMin;
+                    mMax = (x > mMax) ? x : mMax;
+                }
+                level.push_back(x);
+                ++added;
+            }
+        }
+
+        mN += added;
+        mSize += added;
+
+        if (mSize >= mMaxSize) {
+            compress();
+        }
+    }
+
+    return *this;
+}
+
+template <typename T, typename N>
+aeQuantileSketchT<T, N> &aeQuantileSketchT<T, N>::merge(const aeQuantileSketchT<T, N> &rhs) {
+    if (&rhs == this) {
+        aeQuantileSketchT<T, N> copy(rhs);
+        return merge(copy);
+    }
+
+    if (rhs.mN == 0) {
+        return *this;
+    }
+
+    if (mN == 0) {
+        mMin = rhs.mMin;
+        mMax = rhs.mMax;
+    } else {
+        if (mMin > rhs.mMin) { mMin = rhs.mMin; }
+        if (mMax < rhs.mMax) { mMax = rhs.mMax; }
+    }
+
+    while (mLevels.size() < rhs.mLevels.size()) {
+        grow();
+    }
+
+    for (std::size_t h = 0; h < rhs.mLevels.size(); ++h) {
+        const std::vector<T> &level = rhs.mLevels[h];
+        mLevels[h].insert(mLevels[h].end(), level.begin(), level.end());
+    }
+
+    mN += rhs.mN;
+    mSize += rhs.mSize;
+    mRandom ^= rhs.mRandom << 1;
+
+    while (mSize >= mMaxSize) {
+        compress();
+    }
+
+    return *this;
+}
+
+template <typename T, typename N>
+T aeQuantileSketchT<T, N>::min() const {
+    return mMin;
+}
+
+template <typename T, typename N>
+T aeQuantileSketchT<T, N>::max() const {
+    return mMax;
+}
+
+/*
+ * Collects the held values sorted, each with the cumulative weight of the
+ * values up to and including it.
+ */
+template <typename T, typename N>
+void aeQuantileSketchT<T, N>::sorted(std::vector<std::pair<T, N> > &items) const {
+    items.clear();
+    items.reserve(mSize);
+
+    for (std::size_t h = 0; h < mLevels.size(); ++h) {
+        const N weight = N(1) << h;
+        for (const T &x : mLevels[h]) {
+            items.push_back(std::make_pair(x, weight));
+        }
+    }
+
+    std::sort(items.begin(), items.end(),
+        [](const std::pair<T, N> &a, const std::pair<T, N> &b) {
+            return a.first < b.first;
+        });
+
+    N total = N();
+    for (std::pair<T, N> &item : items) {
+        total += item.second;
+        item.second = total;
+    }
+}
+
+template <typename T, typename N>
+T aeQuantileSketchT<T, N>::quantile(double q) const {
+    T value;
+    quantiles(&q, &value, 1);
+    return value;
+}
+
+template <typename T, typename N>
+void aeQuantileSketchT<T, N>::quantiles(const double *q, T *values, std::size_t count) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!(q[i] >= 0.0 && q[i] <= 1.0)) {
+            throw aeArgumentError("aeQuantileSketch: quantile must be between 0 and 1");
+        }
+    }
+
+    if (mN == 0) {
+        std::fill(values, values + count, T(aeNaN));
+        return;
+    }
+
+    std::vector<std::pair<T, N> > items;
+    sorted(items);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (q[i] == 0.0) {
+            values[i] = mMin;
+        } else if (q[i] == 1.0) {
+            values[i] = mMax;
+        } else {
+            double target = q[i] * double(mN);
+            auto it = std::lower_bound(items.begin(), items.end(), target,
+                [](const std::pair<T, N> &item, double t) {
+                    return double(item.second) < t;
+                });
+            values[i] = (it != items.end()) ? it->first : mMax;
+        }
+    }
+}
+
+template <typename T, typename N>
+double aeQuantileSketchT<T, N>::cdf(const T &x) const {
+    if (mN == 0 || x != x) {
+        return aeNaN;
+    }
+
+    if (x < mMin) {
+        return 0.0;
+    }
+
+    if (!(x < mMax)) {
+        return 1.0;
+    }
+
+    N rank = N();
+    for (std::size_t h = 0; h < mLevels.size(); ++h) {
+        N below = N();
+        for (const T &v : mLevels[h]) {
+            below += (v <= x) ? 1 : 0;
+        }
+        rank += below << h;
+    }
+
+    return double(rank) / double(mN);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename N>
+void aeQuantileSketchT<T, N>::encode(std::vector<uint8_t> &buffer) const {
+    std::vector<int64_t> header;
+    header.push_back(int64_t(sizeof(T)));
+    header.push_back(int64_t(mK));
+    header.push_back(int64_t(mN));
+    header.push_back(int64_t(mLevels.size()));
+    for (const std::vector<T> &level : mLevels) {
+        header.push_back(int64_t(level.size()));
+    }
+
+    aeEncodeVarints(header.data(), header.size(), buffer);
+
+    buffer.reserve(buffer.size() + (mSize + 2) * sizeof(T));
+    putValue(mMin, buffer);
+    putValue(mMax, buffer);
+    for (const std::vector<T> &level : mLevels) {
+        for (const T &x : level) {
+            putValue(x, buffer);
+        }
+    }
+}
+
+template <typename T, typename N>
+std::size_t aeQuantileSketchT<T, N>::decode(const uint8_t *data, std::size_t size) {
+    int64_t header[4];
+    std::size_t used = aeDecodeVarints(data, size, header, 4);
+
+    if (header[0] != int64_t(sizeof(T))) {
+        throw aeStreamError("aeQuantileSketch: value size mismatch");
+    }
+
+    if (header[1] < int64_t(MinK) || header[1] > int64_t(UINT32_MAX) ||
+        header[2] < 0 || header[3] < 1 || header[3] > int64_t(MaxLevels)) {
+        throw aeStreamError("aeQuantileSketch: invalid header");
+    }
+
+    std::vector<int64_t> sizes(header[3]);
+    used += aeDecodeVarints(data + used, size - used, sizes.data(), sizes.size());
+
+    // every held value must be present, and their weights must add up to
+    // the count
+    std::size_t total = 0;
+    N weight = N();
+    for (std::size_t h = 0; h < sizes.size(); ++h) {
+        if (sizes[h] < 0 || uint64_t(sizes[h]) > size) {
+            throw aeStreamError("aeQuantileSketch: invalid level size");
+        }
+        total += std::size_t(sizes[h]);
+        weight += N(sizes[h]) << h;
+    }
+
+    if (weight != N(header[2])) {
+        throw aeStreamError("aeQuantileSketch: inconsistent count");
+    }
+
+    if ((size - used) / sizeof(T) < total + 2) {
+        throw aeStreamError("aeQuantileSketch: truncated data");
+    }
+
+    const uint8_t *p = data + used;
+
+    mK = unsigned(header[1]);
+    mN = N(header[2]);
+    mMin = getValue<T>(p);
+    mMax = getValue<T>(p + sizeof(T));
+    p += 2 * sizeof(T);
+
+    mLevels.clear();
+    for (std::size_t h = 0; h < sizes.size(); ++h) {
+        grow();
+        std::vector<T> &level = mLevels.back();
+        level.resize(std::size_t(sizes[h]));
+        for (T &x : level) {
+            x = getValue<T>(p);
+            p += sizeof(T);
+        }
+    }
+
+    mSize = total;
+    mRandom = UINT64_C(0x9e3779b97f4a7c15) ^ uint64_t(mN);
+
+    return std::size_t(p - data);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template class aeMedianT<double, unsigned long long>;
 template class aeMedianT<float, unsigned long long>;
 
+template class aeQuantileSketchT<double, unsigned long long>;
+template class aeQuantileSketchT<float, unsigned long long>;
+
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
 ////////////////////////////////////////////////////////////////////////////////
-
@@ -8,9 +8,17 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aeconst.hpp"
+#include "aeparallel.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,23 +26,81 @@
 //  @note Technically computes the "remedian" value, which approximates the
 //  median for very large datasets.  This implementation uses a fixed base (B)
 //  and increases the exponent as needed.
+//
+//  Values are appended to the lowest level unsorted; when a level fills, its
+//  median is found with a sorting network unrolled at compile time for B and
+//  carried up to the next level.  Every level the count type can reach is
+//  reserved up front, and again by copies, so updates never allocate.  NaN
+//  values are ignored, and not counted, since they have no place in the
+//  ordering.
+//
+//  Remedians of separate parts of the data can be merged; each entry of
+//  level i remains the median of B entries of level i - 1, so after k full
+//  levels the estimate always lies between at least ceil(B/2)^k inputs on
+//  either side, whether the data was seen in one pass or in pieces.
 
 template <typename T, typename N=unsigned long long, unsigned int B=11>
 class aeMedianT {
+    static_assert(B >= 2, "aeMedianT: the base must be at least 2");
+
 private:
     static constexpr T mNaN = T(aeNaN);
 
 public:
     aeMedianT() {
+        mData.reserve(levels(std::numeric_limits<N>::max()));
         clear();
     }
 
+    /**
+     * Copies reserve every level again, since a copied vector only holds as
+     * many levels as are in use.
+     */
+    aeMedianT(const aeMedianT<T, N, B> &other): mN(other.mN) {
+        mData.reserve(levels(std::numeric_limits<N>::max()));
+        mData.assign(other.mData.begin(), other.mData.end());
+    }
+
+    aeMedianT(aeMedianT<T, N, B> &&other) = default;
+
+    aeMedianT<T, N, B> &operator = (const aeMedianT<T, N, B> &other) {
+        mN = other.mN;
+        mData.reserve(levels(std::numeric_limits<N>::max()));
+        mData.assign(other.mData.begin(), other.mData.end());
+        return *this;
+    }
+
+    aeMedianT<T, N, B> &operator = (aeMedianT<T, N, B> &&other) = default;
+
     template <typename I>
-    aeMedianT(const I &i, const I &j) {
-        clear();
+    aeMedianT(const I &i, const I &j): aeMedianT() {
         update(i, j);
     }
 
+    /**
+     * Computes the remedian of a random-access range on up to the given
+     * number of threads (or the hardware concurrency if zero), merging the
+     * partial results in order.  Each chunk is added with update(i, j), so
+     * pointer ranges fill whole levels through the bulk path.
+     */
+    template <typename I>
+    aeMedianT(const I &first, const I &last, unsigned int threads): aeMedianT() {
+        std::size_t count = std::size_t(std::distance(first, last));
+        merge(aeParallelReduce<aeMedianT<T, N, B> >(count, mGrain, threads,
+            [first](std::size_t begin, std::size_t end) {
+                I i(first), j(first);
+                std::advance(i, begin);
+                std::advance(j, end);
+                aeMedianT<T, N, B> partial;
+                partial.update(i, j);
+                return partial;
+            },
+            [](aeMedianT<T, N, B> &result, const aeMedianT<T, N, B> &partial) {
+                result.merge(partial);
+            }
+        ));
+    }
+
     void clear() {
         mN = N();
         mData.clear();
@@ -46,16 +112,15 @@ public:
     }
 
     aeMedianT<T, N, B> &update(const T &x) {
-        unsigned int i = 0;
-        T t(x);
-
-        while (mData[i].insert(t)) {
-            t = mData[i].median();
-            mData[i++].clear();
-            if (i >= mData.size())
-            {
-                mData.push_back(Level());
-            }
+        if (x != x) {
+            return *this;
+        }
+
+        Level &level = mData[0];
+        level.entries[level.count++] = x;
+
+        if (level.count >= B) {
+            carry();
         }
 
         ++mN;
@@ -63,11 +128,70 @@ public:
         return *this;
     }
 
+    /**
+     * Adds count values, filling the lowest level a whole level at a time.
+     */
+    aeMedianT<T, N, B> &update(const T *data, std::size_t count) {
+        const T *end = data + count;
+
+        while (data < end) {
+            Level &level = mData[0];
+            unsigned int n = level.count;
+
+            for (; n < B && data < end; ++data) {
+                if (*data == *data) {
+                    level.entries[n++] = *data;
+                }
+            }
+
+            mN += N(n - level.count);
+            level.count = n;
+
+            if (level.count >= B) {
+                carry();
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * Adds the values in [i, j); contiguous arrays of T take the bulk path.
+     */
     template <typename I>
     void update(const I &i, const I &j) {
-        for (I k(i); k != j; ++k) {
-            update(*k);
+        updateRange(i, j, std::is_convertible<I, const T *>());
+    }
+
+    /**
+     * Adds the entries of another remedian level by level, carrying the
+     * median of each level that fills, as if its blocks had been seen here.
+     */
+    aeMedianT<T, N, B> &merge(const aeMedianT<T, N, B> &rhs) {
+        if (&rhs == this) {
+            aeMedianT<T, N, B> copy(rhs);
+            return merge(copy);
         }
+
+        for (std::size_t i = 0; i < rhs.mData.size(); ++i) {
+            if (i >= mData.size()) {
+                mData.push_back(Level());
+            }
+
+            const Level &from = rhs.mData[i];
+            for (unsigned int j = 0; j < from.count; ++j) {
+                Level &level = mData[i];
+                level.entries[level.count++] = from.entries[j];
+
+                if (level.count >= B) {
+                    carry(i);
+                }
+            }
+        }
+
+        mN += rhs.mN;
+
+        return *this;
     }
 
     T median() const {
@@ -75,6 +199,21 @@ public:
     }
 
 private:
+    static constexpr std::size_t mGrain = 1 << 16;
+
+    template <typename I>
+    void updateRange(const I &i, const I &j, std::false_type) {
+        for (I k(i); k != j; ++k) {
+            update(*k);
+        }
+    }
+
+    template <typename I>
+    void updateRange(const I &i, const I &j, std::true_type) {
+        const T *first = i, *last = j;
+        update(first, std::size_t(last - first));
+    }
+
     struct Level {
         unsigned int count;
         T entries[B];
@@ -85,36 +224,223 @@ private:
             count = 0;
         }
 
-        bool insert(const T &value) {
-            if (count < B) {
-                // @todo keep entries sorted
-                unsigned i, j;
-                for (i = 0; i < count; i++) {
-                    if (entries[i] >= value) {
-                        break;
-                    }
-                }
-                for (j = count; j > i; j--) {
-                    entries[j] = entries[j-1];
+        /**
+         * Median of a full level; leaves the entries sorted.
+         */
+        T select() {
+            sort(std::integral_constant<bool, (B <= mUnrolled)>());
+            return entries[B/2];
+        }
+
+        void sort(std::true_type) {
+            Network<0, B * mSlots>::sort(entries);
+        }
+
+        // the same network as loops, for bases too large to unroll
+        void sort(std::false_type) {
+            for (unsigned int r = 0; r < B; ++r) {
+                for (unsigned int i = r % 2; i + 1 < B; i += 2) {
+                    const T a = entries[i], b = entries[i + 1];
+                    entries[i] = std::min(a, b);
+                    entries[i + 1] = std::max(a, b);
                 }
-                entries[i] = value;
-                ++count;
             }
-            return (count >= B);
         }
 
         T median() const {
-            return (count > 0) ? entries[count/2] : mNaN;
+            if (count == 0) {
+                return mNaN;
+            }
+
+            T sorted[B];
+            std::copy(entries, entries + count, sorted);
+            std::nth_element(sorted, sorted + count/2, sorted + count);
+            return sorted[count/2];
+        }
+    };
+
+    /**
+     * Odd-even transposition sort of B values: comparator k sits in round
+     * k / mSlots, comparing values (i, i + 1) for i = 2 (k % mSlots) plus the
+     * round's parity.  The comparator range is halved at each level of
+     * template recursion, so the network is fully unrolled with a recursion
+     * depth of O(log B), and each comparator is a branchless min and max.
+     * Bases above mUnrolled run the same comparators in loops instead.
+     */
+    static constexpr unsigned int mSlots = B / 2;
+    static constexpr unsigned int mUnrolled = 32;
+
+    template <unsigned int Lo, unsigned int Hi, bool One = (Hi - Lo == 1)>
+    struct Network {
+        static void sort(T *v) {
+            Network<Lo, (Lo + Hi) / 2>::sort(v);
+            Network<(Lo + Hi) / 2, Hi>::sort(v);
         }
     };
 
+    template <unsigned int Lo, unsigned int Hi>
+    struct Network<Lo, Hi, true> {
+        static void sort(T *v) {
+            Exchange<(Lo / mSlots) % 2 + 2 * (Lo % mSlots)>::apply(v);
+        }
+    };
+
+    template <unsigned int I, bool Valid = (I + 1 < B)>
+    struct Exchange {
+        static void apply(T *v) {
+            const T a = v[I], b = v[I + 1];
+            v[I] = std::min(a, b);
+            v[I + 1] = std::max(a, b);
+        }
+    };
+
+    template <unsigned int I>
+    struct Exchange<I, false> {
+        static void apply(T *) {}
+    };
+
+    static constexpr std::size_t levels(N n) {
+        return (n < B) ? 1 : 1 + levels(n / B);
+    }
+
+    /**
+     * Carries the median of each full level, from level i, up to the next.
+     */
+    void carry(std::size_t i = 0) {
+        while (mData[i].count >= B) {
+            T t = mData[i].select();
+            mData[i].clear();
+
+            if (++i >= mData.size()) {
+                mData.push_back(Level());
+            }
+
+            mData[i].entries[mData[i].count++] = t;
+        }
+    }
+
     N mN;
     std::vector<Level> mData;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+//  @note A KLL quantile sketch (Karnin, Lang and Liberty, "Optimal Quantile
+//  Approximation in Streams", 2016).  Values are kept in a stack of
+//  compactors: level h holds values that each stand for 2^h of the inputs,
+//  and when the sketch is full the lowest full level is sorted and every
+//  other value (from a random offset) is promoted to the next level.  Level
+//  capacities shrink geometrically downwards from k, so the sketch holds
+//  O(k) values however many it has seen.
+//
+//  Any quantile or rank can be estimated, with a rank error of about 1.7%
+//  at the default k of 200 (halving roughly as k doubles); the minimum and
+//  maximum are exact.  Sketches built over separate parts of the data, on
+//  other threads or machines, can be merged with the same guarantee, and
+//  can be sent between them in a compact binary form.  NaN values are
+//  ignored.
+
+template <typename T, typename N=unsigned long long>
+class aeQuantileSketchT {
+public:
+    /**
+     * Creates an empty sketch; larger k is more accurate but uses more
+     * memory.  Throws aeArgumentError if k is less than 8.
+     */
+    explicit aeQuantileSketchT(unsigned int k = 200);
+
+    template <typename I>
+    aeQuantileSketchT(const I &i, const I &j, unsigned int k = 200): aeQuantileSketchT(k) {
+        update(i, j);
+    }
+
+    void clear();
+
+    unsigned int k() const { return mK; }
+
+    N count() const { return mN; }
+
+    /**
+     * Number of values held.
+     */
+    std::size_t size() const { return mSize; }
+
+    aeQuantileSketchT<T, N> &update(const T &x);
+
+    /**
+     * Adds count values, filling the lowest level a run at a time.
+     */
+    aeQuantileSketchT<T, N> &update(const T *data, std::size_t count);
+
+    template <typename I>
+    void update(const I &i, const I &j) {
+        for (I k(i); k != j; ++k) {
+            update(*k);
+        }
+    }
+
+    /**
+     * Adds the values summarized by another sketch.  Both should have the
+     * same k; the result keeps this sketch's.
+     */
+    aeQuantileSketchT<T, N> &merge(const aeQuantileSketchT<T, N> &rhs);
+
+    T min() const;
+    T max() const;
+
+    /**
+     * Estimates the value at the given fraction (0 to 1) of the way through
+     * the sorted data; NaN for an empty sketch.  Throws aeArgumentError if
+     * q is outside [0, 1].
+     */
+    T quantile(double q) const;
+
+    /**
+     * Estimates several quantiles with one pass over the sorted sketch.
+     */
+    void quantiles(const double *q, T *values, std::size_t count) const;
+
+    /**
+     * Estimates the fraction of values less than or equal to x.
+     */
+    double cdf(const T &x) const;
+
+    /**
+     * Appends the sketch to a buffer: varints for the value size, k, count
+     * and level sizes, then the minimum, maximum and held values as little
+     * endian.
+     */
+    void encode(std::vector<uint8_t> &buffer) const;
+
+    /**
+     * Replaces the sketch with one decoded from a buffer, returning the
+     * number of bytes used.  Throws aeStreamError if the data is truncated
+     * or inconsistent.
+     */
+    std::size_t decode(const uint8_t *data, std::size_t size);
+
+private:
+    std::size_t capacity(std::size_t level) const;
+    void grow();
+    void compress();
+    void sorted(std::vector<std::pair<T, N> > &items) const;
+    bool coin();
+
+private:
+    unsigned int mK;
+    N mN;
+    T mMin;
+    T mMax;
+    std::size_t mSize;          // values held in all levels
+    std::size_t mMaxSize;       // total capacity of the levels
+    uint64_t mRandom;
+    std::vector<std::vector<T> > mLevels;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 typedef aeMedianT<double, unsigned long long> aeMedian;
+typedef aeQuantileSketchT<double, unsigned long long> aeQuantileSketch;
 
 ////////////////////////////////////////////////////////////////////////////////
 
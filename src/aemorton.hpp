@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEMORTON_HPP_INCLUDE_GUARD
+#define AEMORTON_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Interleaves the bits of x and y into a Morton (Z-order) code, with x in
+ * the even bits.
+ */
+inline uint64_t aeMortonEncode(uint32_t x, uint32_t y) {
+    uint64_t a = x, b = y;
+    a = (a | (a << 16)) & 0x0000ffff0000ffffull;
+    b = (b | (b << 16)) & 0x0000ffff0000ffffull;
+    a = (a | (a << 8))  & 0x00ff00ff00ff00ffull;
+    b = (b | (b << 8))  & 0x00ff00ff00ff00ffull;
+    a = (a | (a << 4))  & 0x0f0f0f0f0f0f0f0full;
+    b = (b | (b << 4))  & 0x0f0f0f0f0f0f0f0full;
+    a = (a | (a << 2))  & 0x3333333333333333ull;
+    b = (b | (b << 2))  & 0x3333333333333333ull;
+    a = (a | (a << 1))  & 0x5555555555555555ull;
+    b = (b | (b << 1))  & 0x5555555555555555ull;
+    return a | (b << 1);
+}
+
+inline void aeMortonDecode(uint64_t code, uint32_t &x, uint32_t &y) {
+    uint64_t a = code & 0x5555555555555555ull, b = (code >> 1) & 0x5555555555555555ull;
+    a = (a | (a >> 1))  & 0x3333333333333333ull;
+    b = (b | (b >> 1))  & 0x3333333333333333ull;
+    a = (a | (a >> 2))  & 0x0f0f0f0f0f0f0f0full;
+    b = (b | (b >> 2))  & 0x0f0f0f0f0f0f0f0full;
+    a = (a | (a >> 4))  & 0x00ff00ff00ff00ffull;
+    b = (b | (b >> 4))  & 0x00ff00ff00ff00ffull;
+    a = (a | (a >> 8))  & 0x0000ffff0000ffffull;
+    b = (b | (b >> 8))  & 0x0000ffff0000ffffull;
+    a = (a | (a >> 16)) & 0x00000000ffffffffull;
+    b = (b | (b >> 16)) & 0x00000000ffffffffull;
+    x = uint32_t(a);
+    y = uint32_t(b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEMORTON_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
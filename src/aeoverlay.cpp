@@ -0,0 +1,872 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeoverlay.hpp"
+#include "aeexcept.hpp"
+#include "aemorton.hpp"
+#include "aepred.hpp"
+#include "aesweep.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    static const uint32_t None = std::numeric_limits<uint32_t>::max();
+
+    template <typename T>
+    struct Rings {
+        std::vector< aePointT<T> > points;
+        std::vector<unsigned int> starts;
+
+        Rings(): points(), starts(1, 0) {}
+
+        unsigned int count() const {
+            return starts.size() - 1;
+        }
+
+        const aePointT<T> *ring(unsigned int r) const {
+            return &points[starts[r]];
+        }
+
+        unsigned int size(unsigned int r) const {
+            return starts[r + 1] - starts[r];
+        }
+    };
+
+    template <typename T>
+    bool ringContains(const aePointT<T> *ring, unsigned int n, const aePointT<T> &p) {
+        bool inside = false;
+        for (unsigned int i = 0, j = n - 1; i < n; j = i++) {
+            const aePointT<T> &a = ring[j], &b = ring[i];
+            if ((a.y > p.y) != (b.y > p.y)) {
+                double o = aeOrient2d(a, b, p);
+                if ((b.y > a.y) ? (o > 0.0) : (o < 0.0)) {
+                    inside = !inside;
+                }
+            }
+        }
+        return inside;
+    }
+
+    template <typename T>
+    double ringArea(const aePointT<T> *ring, unsigned int n) {
+        double area = 0.0;
+        for (unsigned int i = 0, j = n - 1; i < n; j = i++) {
+            area += (double(ring[j].x) - double(ring[i].x)) *
+                    (double(ring[j].y) + double(ring[i].y));
+        }
+        return area * 0.5;
+    }
+
+    template <typename T>
+    aeExtentT<T> ringExtent(const aePointT<T> *ring, unsigned int n) {
+        aeExtentT<T> extent;
+        for (unsigned int i = 0; i < n; ++i) {
+            extent |= ring[i];
+        }
+        return extent;
+    }
+
+    template <typename T>
+    bool extentContains(const aeExtentT<T> &e, const aePointT<T> &p) {
+        return p.x >= e.min.x && p.x <= e.max.x &&
+               p.y >= e.min.y && p.y <= e.max.y;
+    }
+
+    // 1 if p lies inside the ring, -1 if outside and 0 if on its boundary
+    template <typename T>
+    int ringSide(const aePointT<T> *ring, unsigned int n, const aePointT<T> &p) {
+        for (unsigned int i = 0, j = n - 1; i < n; j = i++) {
+            const aePointT<T> &a = ring[j], &b = ring[i];
+            if (p.x >= std::min(a.x, b.x) && p.x <= std::max(a.x, b.x) &&
+                p.y >= std::min(a.y, b.y) && p.y <= std::max(a.y, b.y) &&
+                aeOrient2d(a, b, p) == 0.0) {
+                return 0;
+            }
+        }
+        return ringContains(ring, n, p) ? 1 : -1;
+    }
+
+    // 1 if the ring other lies inside ring, -1 if outside; rings that do
+    // not cross may still touch, so each vertex and then each edge midpoint
+    // of other is tried until one is off ring's boundary.  0 if none is.
+    template <typename T>
+    int ringSide(const aePointT<T> *ring, unsigned int n, const aeExtentT<T> &extent,
+                 const aePointT<T> *other, unsigned int m) {
+        for (unsigned int k = 0; k < 2 * m; ++k) {
+            aePointT<T> p = (k < m) ? other[k] : (other[k - m] + other[(k - m + 1) % m]) / T(2);
+            if (!extentContains(extent, p)) {
+                return -1;
+            }
+            int side = ringSide(ring, n, p);
+            if (side != 0) {
+                return side;
+            }
+        }
+        return 0;
+    }
+
+    // Extracts the rings of a polygonal geometry, dropping repeated points,
+    // and orients them so the interior lies to the left of every edge.
+    template <typename T>
+    void extractRings(const aeGeometryT<T> &g, Rings<T> &rings) {
+        typename aeGeometryT<T>::Type base = g.baseType();
+
+        if (base != aeGeometryT<T>::Polygon &&
+            base != aeGeometryT<T>::MultiPolygon &&
+            base != aeGeometryT<T>::Triangle) {
+            throw aeArgumentError("aeOverlay: not a polygon");
+        }
+
+        const std::vector< aePointT<T> > &points = g.points();
+
+        for (unsigned int i = 0, n = g.partCount(); i < n; ++i) {
+            unsigned int begin = g.partBegin(i), end = g.partEnd(i);
+            unsigned int first = rings.points.size();
+
+            for (unsigned int k = begin; k < end; ++k) {
+                const aePointT<T> &p = points[k];
+                if (rings.points.size() > first) {
+                    const aePointT<T> &q = rings.points.back();
+                    if (p.x == q.x && p.y == q.y) {
+                        continue;
+                    }
+                }
+                rings.points.push_back(p);
+            }
+
+            while (rings.points.size() > first + 1) {
+                const aePointT<T> &p = rings.points[first];
+                const aePointT<T> &q = rings.points.back();
+                if (p.x != q.x || p.y != q.y) {
+                    break;
+                }
+                rings.points.pop_back();
+            }
+
+            if (rings.points.size() < first + 3) {
+                rings.points.resize(first);
+            } else {
+                rings.starts.push_back(rings.points.size());
+            }
+        }
+
+        unsigned int count = rings.count();
+        std::vector<aeExtentT<T> > extents(count);
+        std::vector<bool> holes(count, false);
+
+        for (unsigned int r = 0; r < count; ++r) {
+            extents[r] = ringExtent(rings.ring(r), rings.size(r));
+        }
+
+        if (base != aeGeometryT<T>::MultiPolygon) {
+            for (unsigned int r = 1; r < count; ++r) {
+                holes[r] = true;
+            }
+        } else {
+            // A ring is a hole if it lies inside an odd number of others;
+            // only rings with overlapping extents can contain one another
+
+            aeSweepT<T> sweep;
+            sweep.reserve(count);
+
+            for (unsigned int r = 0; r < count; ++r) {
+                sweep.insert(extents[r].min, extents[r].max);
+            }
+
+            sweep.run(
+                [&](unsigned int i, unsigned int j) -> bool {
+                    if (ringSide(rings.ring(i), rings.size(i), extents[i],
+                                 rings.ring(j), rings.size(j)) > 0) {
+                        holes[j] = !holes[j];
+                    }
+                    if (ringSide(rings.ring(j), rings.size(j), extents[j],
+                                 rings.ring(i), rings.size(i)) > 0) {
+                        holes[i] = !holes[i];
+                    }
+                    return false;
+                }
+            );
+        }
+
+        for (unsigned int r = 0; r < count; ++r) {
+            if ((ringArea(rings.ring(r), rings.size(r)) < 0.0) != holes[r]) {
+                std::reverse(rings.points.begin() + rings.starts[r],
+                             rings.points.begin() + rings.starts[r + 1]);
+            }
+        }
+    }
+
+    // Buckets the edges of a set of rings by y, so point-in-polygon tests
+    // only examine edges that can cross the query point's scanline.
+    template <typename T>
+    class EdgeBands {
+    public:
+        EdgeBands(const Rings<T> &rings): mRings(rings) {
+            unsigned int edges = rings.points.size();
+
+            for (const aePointT<T> &p : rings.points) {
+                mExtent |= p;
+            }
+
+            mBands = std::max(1u, edges / 4);
+            mScale = (mExtent.max.y > mExtent.min.y) ?
+                double(mBands) / (double(mExtent.max.y) - double(mExtent.min.y)) : 0.0;
+
+            mOffsets.assign(mBands + 1, 0);
+
+            for (int pass = 0; pass < 2; ++pass) {
+                for (unsigned int r = 0; r < rings.count(); ++r) {
+                    unsigned int first = rings.starts[r], n = rings.size(r);
+                    for (unsigned int i = 0; i < n; ++i) {
+                        const aePointT<T> &a = rings.points[first + i];
+                        const aePointT<T> &b = rings.points[first + (i + 1) % n];
+                        unsigned int lo = band(std::min(a.y, b.y));
+                        unsigned int hi = band(std::max(a.y, b.y));
+                        for (unsigned int k = lo; k <= hi; ++k) {
+                            if (pass == 0) {
+                                ++mOffsets[k + 1];
+                            } else {
+                                mEdges[mCursor[k]++] = first + i;
+                            }
+                        }
+                    }
+                }
+
+                if (pass == 0) {
+                    for (unsigned int k = 0; k < mBands; ++k) {
+                        mOffsets[k + 1] += mOffsets[k];
+                    }
+                    mEdges.resize(mOffsets[mBands]);
+                    mCursor.assign(mOffsets.begin(), mOffsets.end() - 1);
+                }
+            }
+
+            mNext.resize(edges);
+            for (unsigned int r = 0; r < rings.count(); ++r) {
+                unsigned int first = rings.starts[r], n = rings.size(r);
+                for (unsigned int i = 0; i < n; ++i) {
+                    mNext[first + i] = first + (i + 1) % n;
+                }
+            }
+        }
+
+        bool contains(const aePointT<T> &p) const {
+            if (mRings.points.empty() || p.y < mExtent.min.y || p.y > mExtent.max.y) {
+                return false;
+            }
+
+            bool inside = false;
+            unsigned int k = band(p.y);
+
+            for (unsigned int i = mOffsets[k]; i < mOffsets[k + 1]; ++i) {
+                const aePointT<T> &a = mRings.points[mEdges[i]];
+                const aePointT<T> &b = mRings.points[mNext[mEdges[i]]];
+                if ((a.y > p.y) != (b.y > p.y)) {
+                    double o = aeOrient2d(a, b, p);
+                    if ((b.y > a.y) ? (o > 0.0) : (o < 0.0)) {
+                        inside = !inside;
+                    }
+                }
+            }
+
+            return inside;
+        }
+
+    private:
+        unsigned int band(const T &y) const {
+            double k = (double(y) - double(mExtent.min.y)) * mScale;
+            return (k <= 0.0) ? 0 : std::min(mBands - 1, (unsigned int)(k));
+        }
+
+        const Rings<T> &mRings;
+        aeExtentT<T> mExtent;
+        unsigned int mBands;
+        double mScale;
+        std::vector<unsigned int> mOffsets;
+        std::vector<unsigned int> mCursor;
+        std::vector<unsigned int> mEdges;
+        std::vector<unsigned int> mNext;
+    };
+
+    template <typename T>
+    struct Edge {
+        aePointT<T> a;
+        aePointT<T> b;
+        uint8_t source;
+    };
+
+    template <typename T>
+    struct Split {
+        uint32_t edge;
+        T t;
+        aePointT<T> point;
+
+        bool operator < (const Split &s) const {
+            return (edge == s.edge) ? (t < s.t) : (edge < s.edge);
+        }
+    };
+
+    template <typename T>
+    bool between(const aePointT<T> &p, const aePointT<T> &q, const aePointT<T> &r) {
+        // q is collinear with p and r; test whether it lies strictly between
+        if ((q.x == p.x && q.y == p.y) || (q.x == r.x && q.y == r.y)) {
+            return false;
+        }
+        return std::min(p.x, r.x) <= q.x && q.x <= std::max(p.x, r.x) &&
+               std::min(p.y, r.y) <= q.y && q.y <= std::max(p.y, r.y);
+    }
+
+    template <typename T>
+    Split<T> makeSplit(uint32_t e, const Edge<T> &edge, const aePointT<T> &p) {
+        Split<T> s;
+        s.edge = e;
+        s.t = (p.x - edge.a.x) * (edge.b.x - edge.a.x) +
+              (p.y - edge.a.y) * (edge.b.y - edge.a.y);
+        s.point = p;
+        return s;
+    }
+
+    // Clockwise angle from (a - b) to (c - b) is less than to (d - b)
+    template <typename T>
+    bool clockwiseLess(
+        const aePointT<T> &b,
+        const aePointT<T> &a,
+        const aePointT<T> &c,
+        const aePointT<T> &d
+    ) {
+        struct Half {
+            static int of(const aePointT<T> &b, const aePointT<T> &a, const aePointT<T> &c) {
+                double o = aeOrient2d(b, a, c);
+                if (o < 0.0) { return 0; }
+                if (o > 0.0) { return 1; }
+                double dot = (double(a.x) - double(b.x)) * (double(c.x) - double(b.x)) +
+                             (double(a.y) - double(b.y)) * (double(c.y) - double(b.y));
+                return (dot < 0.0) ? 1 : 2;
+            }
+        };
+
+        int hc = Half::of(b, a, c), hd = Half::of(b, a, d);
+        if (hc != hd) {
+            return hc < hd;
+        }
+        return aeOrient2d(b, c, d) < 0.0;
+    }
+
+    template <typename T>
+    aeExtentT<T> polygonExtent(const aeGeometryT<T> &g) {
+        aeExtentT<T> extent;
+        for (const aePointT<T> &p : g.points()) {
+            extent |= p;
+        }
+        return extent;
+    }
+
+    template <typename T>
+    void appendParts(aeGeometryT<T> &target, const aeGeometryT<T> &source) {
+        unsigned int offset = target.points().size();
+        for (unsigned int i = 0, n = source.partCount(); i < n; ++i) {
+            if (source.partBegin(i) < source.partEnd(i)) {
+                target.parts().push_back(offset + source.partBegin(i));
+            }
+        }
+        target.points().insert(target.points().end(),
+                               source.points().begin(), source.points().end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aeGeometryT<T> aeOverlayT<T>::compute(
+    const aeGeometryT<T> &a,
+    const aeGeometryT<T> &b,
+    Operation op
+) const {
+    Rings<T> rings[2];
+
+    extractRings(a, rings[0]);
+    extractRings(b, rings[1]);
+
+    // Collect the directed edges of both operands
+
+    std::vector< Edge<T> > edges;
+    edges.reserve(rings[0].points.size() + rings[1].points.size());
+
+    for (uint8_t s = 0; s < 2; ++s) {
+        for (unsigned int r = 0; r < rings[s].count(); ++r) {
+            const aePointT<T> *ring = rings[s].ring(r);
+            unsigned int n = rings[s].size(r);
+            for (unsigned int i = 0; i < n; ++i) {
+                Edge<T> e = { ring[i], ring[(i + 1) % n], s };
+                edges.push_back(e);
+            }
+        }
+    }
+
+    // Node the edges against each other: every crossing, and every endpoint
+    // touching the interior of another edge, splits that edge
+
+    std::vector< Split<T> > splits;
+
+    aeSweepT<T> sweep;
+    sweep.reserve(edges.size());
+
+    for (const Edge<T> &e : edges) {
+        sweep.insert(e.a, e.b);
+    }
+
+    sweep.run(
+        [&](unsigned int i, unsigned int j) -> bool {
+            const Edge<T> &e = edges[i], &f = edges[j];
+
+            double o1 = aeOrient2d(f.a, f.b, e.a);
+            double o2 = aeOrient2d(f.a, f.b, e.b);
+            double o3 = aeOrient2d(e.a, e.b, f.a);
+            double o4 = aeOrient2d(e.a, e.b, f.b);
+
+            if (((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0)) &&
+                ((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0))) {
+                aePointT<T> p = aeLerp(e.a, e.b, o1 / (o1 - o2));
+                splits.push_back(makeSplit(i, e, p));
+                splits.push_back(makeSplit(j, f, p));
+                return false;
+            }
+
+            if (o1 == 0.0 && between(f.a, e.a, f.b)) { splits.push_back(makeSplit(j, f, e.a)); }
+            if (o2 == 0.0 && between(f.a, e.b, f.b)) { splits.push_back(makeSplit(j, f, e.b)); }
+            if (o3 == 0.0 && between(e.a, f.a, e.b)) { splits.push_back(makeSplit(i, e, f.a)); }
+            if (o4 == 0.0 && between(e.a, f.b, e.b)) { splits.push_back(makeSplit(i, e, f.b)); }
+
+            return false;
+        }
+    );
+
+    std::sort(splits.begin(), splits.end());
+
+    // Break the edges into sub-edges between shared vertices
+
+    struct SubEdge {
+        uint32_t u;
+        uint32_t v;
+        uint8_t source;
+        uint8_t action;
+    };
+
+    enum { Drop, Keep, Reverse };
+
+    std::vector< aePointT<T> > vertices;
+    std::map<std::pair<T, T>, uint32_t> ids;
+    std::vector<SubEdge> subEdges;
+
+    auto vertex = [&](const aePointT<T> &p) -> uint32_t {
+        std::pair<typename std::map<std::pair<T, T>, uint32_t>::iterator, bool> r =
+            ids.insert(std::make_pair(std::make_pair(p.x, p.y), uint32_t(vertices.size())));
+        if (r.second) {
+            vertices.push_back(p);
+        }
+        return r.first->second;
+    };
+
+    std::size_t k = 0;
+
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        uint32_t u = vertex(edges[i].a);
+
+        for (; k < splits.size() && splits[k].edge == i; ++k) {
+            uint32_t w = vertex(splits[k].point);
+            if (w != u) {
+                SubEdge s = { u, w, edges[i].source, Drop };
+                subEdges.push_back(s);
+                u = w;
+            }
+        }
+
+        uint32_t w = vertex(edges[i].b);
+        if (w != u) {
+            SubEdge s = { u, w, edges[i].source, Drop };
+            subEdges.push_back(s);
+        }
+    }
+
+    // Decide which sub-edges bound the result; edges shared by both
+    // operands are decided by whether the interiors lie on the same side
+
+    std::vector<uint32_t> order(subEdges.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(),
+        [&subEdges](uint32_t i, uint32_t j) {
+            const SubEdge &e = subEdges[i], &f = subEdges[j];
+            uint32_t e0 = std::min(e.u, e.v), e1 = std::max(e.u, e.v);
+            uint32_t f0 = std::min(f.u, f.v), f1 = std::max(f.u, f.v);
+            if (e0 != f0) { return e0 < f0; }
+            if (e1 != f1) { return e1 < f1; }
+            return e.source < f.source;
+        }
+    );
+
+    EdgeBands<T> bands[2] = { EdgeBands<T>(rings[0]), EdgeBands<T>(rings[1]) };
+
+    for (std::size_t i = 0; i < order.size(); ) {
+        SubEdge &e = subEdges[order[i]];
+        std::size_t j = i + 1;
+
+        while (j < order.size() &&
+               std::min(subEdges[order[j]].u, subEdges[order[j]].v) == std::min(e.u, e.v) &&
+               std::max(subEdges[order[j]].u, subEdges[order[j]].v) == std::max(e.u, e.v)) {
+            ++j;
+        }
+
+        uint32_t other = None;
+        for (std::size_t m = i + 1; m < j; ++m) {
+            if (subEdges[order[m]].source != e.source) {
+                other = order[m];
+                break;
+            }
+        }
+
+        if (other != None) {
+            bool same = (subEdges[other].u == e.u);
+
+            switch (op) {
+                case Union:
+                case Intersection: {
+                    e.action = same ? Keep : Drop;
+                    break;
+                }
+
+                case Difference: {
+                    e.action = same ? Drop : Keep;
+                    break;
+                }
+
+                case SymmetricDifference: {
+                    e.action = Drop;
+                    break;
+                }
+            }
+        } else {
+            aePointT<T> mid = (vertices[e.u] + vertices[e.v]) / T(2);
+            bool inside = bands[1 - e.source].contains(mid);
+
+            switch (op) {
+                case Union: {
+                    e.action = inside ? Drop : Keep;
+                    break;
+                }
+
+                case Intersection: {
+                    e.action = inside ? Keep : Drop;
+                    break;
+                }
+
+                case Difference: {
+                    if (e.source == 0) {
+                        e.action = inside ? Drop : Keep;
+                    } else {
+                        e.action = inside ? Reverse : Drop;
+                    }
+                    break;
+                }
+
+                case SymmetricDifference: {
+                    e.action = inside ? Reverse : Keep;
+                    break;
+                }
+            }
+        }
+
+        i = j;
+    }
+
+    // Link the surviving edges into rings, turning as far left as possible
+    // at each vertex so that rings touching at a point are kept apart
+
+    uint32_t count = vertices.size();
+    std::vector<uint32_t> offsets(count + 1, 0), targets;
+
+    for (SubEdge &e : subEdges) {
+        if (e.action == Reverse) {
+            std::swap(e.u, e.v);
+            e.action = Keep;
+        }
+        if (e.action == Keep) {
+            ++offsets[e.u + 1];
+        }
+    }
+    for (uint32_t v = 0; v < count; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    targets.resize(offsets[count]);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+
+    for (const SubEdge &e : subEdges) {
+        if (e.action == Keep) {
+            targets[cursor[e.u]++] = e.v;
+        }
+    }
+
+    std::vector<bool> used(targets.size(), false);
+
+    Rings<T> result;
+    std::vector<uint32_t> ring;
+
+    for (uint32_t v = 0; v < count; ++v) {
+        for (uint32_t s = offsets[v]; s < offsets[v + 1]; ++s) {
+            if (used[s]) {
+                continue;
+            }
+
+            ring.clear();
+
+            uint32_t from = v, slot = s;
+
+            while (slot != None && !used[slot]) {
+                used[slot] = true;
+                ring.push_back(from);
+
+                uint32_t to = targets[slot], best = None;
+                uint32_t first = offsets[to], last = offsets[to + 1];
+
+                for (uint32_t t = first; t < last; ++t) {
+                    if (used[t] && t != s) {
+                        continue;
+                    }
+                    if (targets[t] == from && last - first > 1) {
+                        continue;
+                    }
+                    if (best == None || clockwiseLess(
+                            vertices[to], vertices[from],
+                            vertices[targets[t]], vertices[targets[best]])) {
+                        best = t;
+                    }
+                }
+
+                from = to;
+                slot = best;
+            }
+
+            // Remove collinear vertices left over from noding
+
+            unsigned int start = result.points.size();
+            unsigned int n = ring.size();
+
+            for (unsigned int i = 0; i < n; ++i) {
+                const aePointT<T> &p = vertices[ring[(i + n - 1) % n]];
+                const aePointT<T> &q = vertices[ring[i]];
+                const aePointT<T> &r = vertices[ring[(i + 1) % n]];
+                if (aeOrient2d(p, q, r) != 0.0) {
+                    result.points.push_back(q);
+                }
+            }
+
+            if (result.points.size() < start + 3 ||
+                ringArea(&result.points[start], result.points.size() - start) == 0.0) {
+                result.points.resize(start);
+            } else {
+                result.starts.push_back(result.points.size());
+            }
+        }
+    }
+
+    // Assemble shells and holes; each hole belongs to the smallest shell
+    // containing it
+
+    unsigned int rc = result.count();
+    std::vector<double> areas(rc);
+    std::vector< aeExtentT<T> > extents(rc);
+    std::vector<uint32_t> owner(rc, None);
+
+    for (unsigned int r = 0; r < rc; ++r) {
+        areas[r] = ringArea(result.ring(r), result.size(r));
+        extents[r] = ringExtent(result.ring(r), result.size(r));
+    }
+
+    // Only shells whose extents overlap a hole's can contain it
+
+    aeSweepT<T> shellSweep;
+    shellSweep.reserve(rc);
+
+    for (unsigned int r = 0; r < rc; ++r) {
+        shellSweep.insert(extents[r].min, extents[r].max);
+    }
+
+    shellSweep.run(
+        [&](unsigned int i, unsigned int j) -> bool {
+            if ((areas[i] > 0.0) == (areas[j] > 0.0)) {
+                return false;
+            }
+
+            unsigned int r = (areas[i] > 0.0) ? j : i, s = (areas[i] > 0.0) ? i : j;
+
+            if (owner[r] != None && areas[s] >= areas[owner[r]]) {
+                return false;
+            }
+
+            if (ringSide(result.ring(s), result.size(s), extents[s],
+                         result.ring(r), result.size(r)) > 0) {
+                owner[r] = s;
+            }
+            return false;
+        }
+    );
+
+    // Group the holes by shell
+
+    std::vector<uint32_t> holeStarts(rc + 1, 0), holes;
+
+    for (unsigned int r = 0; r < rc; ++r) {
+        if (areas[r] < 0.0) {
+            if (owner[r] == None) {
+                throw aeInternalError("aeOverlay: hole outside every shell");
+            }
+            ++holeStarts[owner[r] + 1];
+        }
+    }
+    for (unsigned int r = 0; r < rc; ++r) {
+        holeStarts[r + 1] += holeStarts[r];
+    }
+
+    holes.resize(holeStarts[rc]);
+    std::vector<uint32_t> holeCursor(holeStarts.begin(), holeStarts.end() - 1);
+
+    for (unsigned int r = 0; r < rc; ++r) {
+        if (areas[r] < 0.0) {
+            holes[holeCursor[owner[r]]++] = r;
+        }
+    }
+
+    aeGeometryT<T> output(aeGeometryT<T>::MultiPolygon);
+    output.points().reserve(result.points.size());
+
+    auto append = [&](unsigned int r) {
+        output.parts().push_back(output.points().size());
+        output.points().insert(output.points().end(),
+                               result.ring(r), result.ring(r) + result.size(r));
+    };
+
+    for (unsigned int r = 0; r < rc; ++r) {
+        if (areas[r] > 0.0) {
+            append(r);
+            for (uint32_t h = holeStarts[r]; h < holeStarts[r + 1]; ++h) {
+                append(holes[h]);
+            }
+        }
+    }
+
+    return output;
+}
+
+template <typename T>
+aeGeometryT<T> aeOverlayT<T>::uniteAll(std::vector< aeGeometryT<T> > geometries) const {
+    if (geometries.empty()) {
+        return aeGeometryT<T>(aeGeometryT<T>::MultiPolygon);
+    }
+
+    // Order the inputs along a Z-order curve over their extent centres
+
+    aeExtentT<T> all;
+    std::vector< aeExtentT<T> > extents;
+    extents.reserve(geometries.size());
+
+    for (const aeGeometryT<T> &g : geometries) {
+        extents.push_back(polygonExtent(g));
+        all |= extents.back();
+    }
+
+    double sx = (all.max.x > all.min.x) ? 65535.0 / (double(all.max.x) - double(all.min.x)) : 0.0;
+    double sy = (all.max.y > all.min.y) ? 65535.0 / (double(all.max.y) - double(all.min.y)) : 0.0;
+
+    std::vector< std::pair<uint32_t, uint32_t> > keys(geometries.size());
+
+    for (uint32_t i = 0; i < geometries.size(); ++i) {
+        const aeExtentT<T> &e = extents[i];
+        uint32_t code = 0;
+        if (!std::isnan(e.min.x)) {
+            double cx = (double(e.min.x) + double(e.max.x)) * 0.5 - double(all.min.x);
+            double cy = (double(e.min.y) + double(e.max.y)) * 0.5 - double(all.min.y);
+            // 16 bits a side, so the code fits in 32
+            code = uint32_t(aeMortonEncode(uint32_t(cx * sx), uint32_t(cy * sy)));
+        }
+        keys[i] = std::make_pair(code, i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector< aeGeometryT<T> > level;
+    level.reserve(geometries.size());
+
+    for (const std::pair<uint32_t, uint32_t> &key : keys) {
+        level.push_back(normalize(geometries[key.second]));
+    }
+
+    geometries.clear();
+
+    // Merge neighbours pairwise until one geometry remains
+
+    while (level.size() > 1) {
+        std::vector< aeGeometryT<T> > next;
+        next.reserve((level.size() + 1) / 2);
+
+        for (std::size_t i = 0; i < level.size(); i += 2) {
+            if (i + 1 == level.size()) {
+                next.push_back(level[i]);
+                continue;
+            }
+
+            const aeGeometryT<T> &a = level[i], &b = level[i + 1];
+            aeExtentT<T> ea = polygonExtent(a), eb = polygonExtent(b);
+
+            if (std::isnan(ea.min.x) || std::isnan(eb.min.x) ||
+                ea.max.x < eb.min.x || eb.max.x < ea.min.x ||
+                ea.max.y < eb.min.y || eb.max.y < ea.min.y) {
+                aeGeometryT<T> merged(aeGeometryT<T>::MultiPolygon);
+                appendParts(merged, a);
+                appendParts(merged, b);
+                next.push_back(merged);
+            } else {
+                next.push_back(compute(a, b, Union));
+            }
+        }
+
+        level.swap(next);
+    }
+
+    return level[0];
+}
+
+template <typename T>
+aeGeometryT<T> aeOverlayT<T>::normalize(const aeGeometryT<T> &polygon) const {
+    Rings<T> rings;
+    extractRings(polygon, rings);
+
+    aeGeometryT<T> output(polygon.baseType() == aeGeometryT<T>::Polygon ?
+                          aeGeometryT<T>::Polygon : aeGeometryT<T>::MultiPolygon);
+
+    output.points() = rings.points;
+    for (unsigned int r = 0; r < rings.count(); ++r) {
+        output.parts().push_back(rings.starts[r]);
+    }
+
+    return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template class aeOverlayT<double>;
+template class aeOverlayT<float>;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEOVERLAY_HPP_INCLUDE_GUARD
+#define AEOVERLAY_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeom.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Boolean operations on polygons and multi-polygons (with holes).  Both
+//  operands are noded against each other with a plane sweep, each resulting
+//  edge is classified as inside or outside the other operand, and the edges
+//  bounding the result are linked back into rings.  Results are returned as a
+//  MultiPolygon whose shells are counterclockwise and whose holes are
+//  clockwise, each shell followed by its holes.
+//
+//  Crossing points are computed from exact orientation tests but stored
+//  rounded to T, without snap rounding.  For double coordinates the rounding
+//  is far below any meaningful tolerance; with float coordinates a rounded
+//  node can, rarely, move far enough to cross a nearby edge, leaving a
+//  slightly self-intersecting result.  Overlay such inputs in double.
+
+template <typename T>
+class aeOverlayT {
+public:
+    enum Operation {
+        Union,
+        Intersection,
+        Difference,
+        SymmetricDifference
+    };
+
+public:
+    aeOverlayT() {}
+
+    aeGeometryT<T> compute(
+        const aeGeometryT<T> &a,
+        const aeGeometryT<T> &b,
+        Operation op
+    ) const;
+
+    aeGeometryT<T> unite(const aeGeometryT<T> &a, const aeGeometryT<T> &b) const {
+        return compute(a, b, Union);
+    }
+
+    aeGeometryT<T> intersect(const aeGeometryT<T> &a, const aeGeometryT<T> &b) const {
+        return compute(a, b, Intersection);
+    }
+
+    aeGeometryT<T> subtract(const aeGeometryT<T> &a, const aeGeometryT<T> &b) const {
+        return compute(a, b, Difference);
+    }
+
+    /**
+     * Computes the union of many polygons at once.  Inputs are ordered along a
+     * Morton (Z-order) curve so that neighbours are merged first, then merged
+     * pairwise in a balanced tree; pairs whose extents are disjoint are simply
+     * concatenated without running the overlay.
+     */
+    aeGeometryT<T> uniteAll(std::vector< aeGeometryT<T> > geometries) const;
+
+    template <typename I>
+    aeGeometryT<T> uniteAll(const I &first, const I &last) const {
+        return uniteAll(std::vector< aeGeometryT<T> >(first, last));
+    }
+
+    /**
+     * Returns a copy of a polygonal geometry with shells oriented
+     * counterclockwise and holes clockwise.
+     */
+    aeGeometryT<T> normalize(const aeGeometryT<T> &polygon) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aeOverlayT<double> aeOverlay;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEOVERLAY_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aepacked.hpp"
+
+#include <cinttypes>
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aePackedPointsT<T>::aePackedPointsT(const aeGeometryT<T> &geometry):
+    mLayout(layoutOf(geometry.hasZ(), geometry.hasM())),
+    mStride(strideOf(mLayout)) {
+    const std::vector< aePointT<T> > &points = geometry.points();
+
+    mCoords.resize(points.size() * mStride);
+
+    T *c = mCoords.data();
+
+    switch (mLayout) {
+        case XY:
+            for (const aePointT<T> &p : points) {
+                *c++ = p.x; *c++ = p.y;
+            }
+            break;
+        case XYZ:
+            for (const aePointT<T> &p : points) {
+                *c++ = p.x; *c++ = p.y; *c++ = p.z;
+            }
+            break;
+        case XYM:
+            for (const aePointT<T> &p : points) {
+                *c++ = p.x; *c++ = p.y; *c++ = p.m;
+            }
+            break;
+        case XYZM:
+            for (const aePointT<T> &p : points) {
+                *c++ = p.x; *c++ = p.y; *c++ = p.z; *c++ = p.m;
+            }
+            break;
+    }
+}
+
+template <typename T>
+void aePackedPointsT<T>::unpack(std::vector< aePointT<T> > &points) const {
+    std::size_t n = size();
+
+    points.resize(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        points[i] = (*this)[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aePackedGeometryT<T>::aePackedGeometryT(const aeGeometryT<T> &geometry):
+    mType(geometry.type()),
+    mParts(geometry.parts()),
+    mPartTypes(geometry.partTypes()),
+    mPoints(geometry) {
+}
+
+template <typename T>
+aeExtentT<T> aePackedGeometryT<T>::extent() const {
+    Type base = Type(mType & ~(aeGeometryT<T>::HasZ | aeGeometryT<T>::HasM));
+    if (base == aeGeometryT<T>::CircularString || base == aeGeometryT<T>::CompoundCurve ||
+        base == aeGeometryT<T>::CurvePolygon) {
+        return unpack().extent();
+    }
+
+    aeExtentT<T> extent;
+    mPoints.forEach([&extent](const aePointT<T> &p) { extent |= p; });
+    return extent;
+}
+
+template <typename T>
+aeGeometryT<T> aePackedGeometryT<T>::unpack() const {
+    aeGeometryT<T> geometry(mType);
+    geometry.parts() = mParts;
+    geometry.partTypes() = mPartTypes;
+    mPoints.unpack(geometry.points());
+    return geometry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template class aePackedPointsT<double>;
+template class aePackedPointsT<float>;
+template class aePackedPointsT<int32_t>;
+
+template class aePackedGeometryT<double>;
+template class aePackedGeometryT<float>;
+template class aePackedGeometryT<int32_t>;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
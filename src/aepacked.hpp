@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEPACKED_HPP_INCLUDE_GUARD
+#define AEPACKED_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeom.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Stores the points of a geometry with only the coordinates its type
+//  carries: two values per point for plain 2D data, three with Z or M, and
+//  four only when both are present (the geometry's HasZ and HasM flags).
+//  Individual points are read back as aePointT, or as the matching compact
+//  point type through forEach().
+
+template <typename T>
+class aePackedPointsT {
+public:
+    enum Layout {
+        XY,
+        XYZ,
+        XYM,
+        XYZM
+    };
+
+public:
+    aePackedPointsT(bool hasZ = false, bool hasM = false):
+        mLayout(layoutOf(hasZ, hasM)), mStride(strideOf(mLayout)) {}
+
+    /**
+     * Packs the points of a geometry, choosing the layout from its type.
+     */
+    explicit aePackedPointsT(const aeGeometryT<T> &geometry);
+
+    Layout layout() const { return mLayout; }
+    unsigned int stride() const { return mStride; }
+    bool hasZ() const { return mLayout == XYZ || mLayout == XYZM; }
+    bool hasM() const { return mLayout == XYM || mLayout == XYZM; }
+
+    std::size_t size() const { return mCoords.size() / mStride; }
+    bool empty() const { return mCoords.empty(); }
+    void clear() { mCoords.clear(); }
+    void reserve(std::size_t n) { mCoords.reserve(n * mStride); }
+
+    const T *data() const { return mCoords.data(); }
+
+    aePointT<T> operator [] (std::size_t i) const {
+        const T *c = &mCoords[i * mStride];
+        switch (mLayout) {
+            case XY:   return aePointT<T>(c[0], c[1]);
+            case XYZ:  return aePointT<T>(c[0], c[1], c[2]);
+            case XYM:  return aePointT<T>(c[0], c[1], T(), c[2]);
+            default:   return aePointT<T>(c[0], c[1], c[2], c[3]);
+        }
+    }
+
+    void push_back(const aePointT<T> &p) {
+        mCoords.push_back(p.x);
+        mCoords.push_back(p.y);
+        if (hasZ()) { mCoords.push_back(p.z); }
+        if (hasM()) { mCoords.push_back(p.m); }
+    }
+
+    /**
+     * Calls f once per point with the compact point type for this layout
+     * (aePointXYT, aePointXYZT, aePointXYMT or aePointT), so f must accept
+     * all four; the layout is tested once, not per point.  The compact types
+     * convert to aePointT, so a lambda taking an aePointT also works.
+     */
+    template <typename F>
+    void forEach(F &&f) const {
+        const T *c = mCoords.data(), *end = c + mCoords.size();
+        switch (mLayout) {
+            case XY:
+                for (; c < end; c += 2) { f(aePointXYT<T>(c[0], c[1])); }
+                break;
+            case XYZ:
+                for (; c < end; c += 3) { f(aePointXYZT<T>(c[0], c[1], c[2])); }
+                break;
+            case XYM:
+                for (; c < end; c += 3) { f(aePointXYMT<T>(c[0], c[1], c[2])); }
+                break;
+            case XYZM:
+                for (; c < end; c += 4) { f(aePointT<T>(c[0], c[1], c[2], c[3])); }
+                break;
+        }
+    }
+
+    /**
+     * Expands the packed points back into a geometry's point list.
+     */
+    void unpack(std::vector< aePointT<T> > &points) const;
+
+private:
+    static Layout layoutOf(bool hasZ, bool hasM) {
+        return hasZ ? (hasM ? XYZM : XYZ) : (hasM ? XYM : XY);
+    }
+
+    static unsigned int strideOf(Layout layout) {
+        return (layout == XY) ? 2 : (layout == XYZM) ? 4 : 3;
+    }
+
+    Layout mLayout;
+    unsigned int mStride;
+    std::vector<T> mCoords;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A geometry held in packed form: its type, parts and part types as
+//  in aeGeometryT, and its points in an aePackedPointsT.  This is how layers
+//  store geometries they own; unpack() rebuilds the aeGeometryT when one is
+//  needed.
+
+template <typename T>
+class aePackedGeometryT {
+public:
+    typedef typename aeGeometryT<T>::Type Type;
+    typedef typename aeGeometryT<T>::Parts Parts;
+    typedef typename aeGeometryT<T>::PartTypes PartTypes;
+
+public:
+    explicit aePackedGeometryT(const aeGeometryT<T> &geometry);
+
+    Type type() const { return mType; }
+    const Parts &parts() const { return mParts; }
+    const PartTypes &partTypes() const { return mPartTypes; }
+    const aePackedPointsT<T> &points() const { return mPoints; }
+
+    /**
+     * Extent of the points, read from the packed coordinates; curves are
+     * unpacked, since their extent depends on the arcs.
+     */
+    aeExtentT<T> extent() const;
+
+    aeGeometryT<T> unpack() const;
+
+private:
+    Type mType;
+    Parts mParts;
+    PartTypes mPartTypes;
+    aePackedPointsT<T> mPoints;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aePackedPointsT<double> aePackedPoints;
+typedef aePackedGeometryT<double> aePackedGeometry;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEPACKED_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
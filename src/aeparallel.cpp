@@ -0,0 +1,27 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeparallel.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int aeThreadCount(unsigned int requested, std::size_t count, std::size_t grain) {
+    unsigned int n = requested;
+
+    if (n == 0) {
+        n = std::thread::hardware_concurrency();
+    }
+
+    std::size_t chunks = (grain > 0) ? (count / grain) : count;
+
+    if (chunks < n) {
+        n = unsigned(chunks);
+    }
+
+    return std::max(n, 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
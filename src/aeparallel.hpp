@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEPARALLEL_HPP_INCLUDE_GUARD
+#define AEPARALLEL_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns the number of threads to use for a request of the given size: the
+ * hardware concurrency if zero, and never more than one per grain of work.
+ */
+unsigned int aeThreadCount(unsigned int requested, std::size_t count, std::size_t grain);
+
+/**
+ * Splits [0, count) into contiguous chunks, computes reduce(begin, end) for
+ * each chunk on its own thread, and folds the partial results together in
+ * order with merge(result, partial).  The first chunk runs on the calling
+ * thread.  An exception thrown by any chunk is rethrown once every thread
+ * has finished; if a thread cannot be started, the threads already running
+ * are joined before the error propagates.
+ */
+template <typename R, typename F, typename M>
+R aeParallelReduce(
+    std::size_t count,
+    std::size_t grain,
+    unsigned int threads,
+    F reduce,
+    M merge
+) {
+    unsigned int n = aeThreadCount(threads, count, grain);
+
+    if (n <= 1) {
+        return reduce(std::size_t(0), count);
+    }
+
+    std::vector<R> partials(n);
+    std::vector<std::exception_ptr> errors(n);
+    std::vector<std::thread> workers;
+    workers.reserve(n - 1);
+
+    auto run = [&](unsigned int i) {
+        std::size_t begin = count * i / n;
+        std::size_t end = count * (i + 1) / n;
+        try {
+            partials[i] = reduce(begin, end);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    // a worker that failed to start must not leave the others joinable
+    try {
+        for (unsigned int i = 1; i < n; ++i) {
+            workers.push_back(std::thread(run, i));
+        }
+    } catch (...) {
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+
+    run(0);
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    R result = partials[0];
+    for (unsigned int i = 1; i < n; ++i) {
+        merge(result, partials[i]);
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEPARALLEL_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
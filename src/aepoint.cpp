@@ -4,10 +4,20 @@
 
 #include "aepoint.hpp"
 
+#include <cinttypes>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 template class aePointT<double>;
 template class aePointT<float>;
+template class aePointT<int32_t>;
+
+template class aePointXYT<double>;
+template class aePointXYT<float>;
+template class aePointXYZT<double>;
+template class aePointXYZT<float>;
+template class aePointXYMT<double>;
+template class aePointXYMT<float>;
 
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
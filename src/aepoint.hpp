@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cmath>
+#include <type_traits>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -46,17 +47,40 @@ struct aePointT {
     ): x(x), y(y), z(z), m(m) {
     }
 
+    template <typename U>
+    explicit aePointT(
+        const aePointT<U> &p
+    ): x(T(p.x)), y(T(p.y)), z(T(p.z)), m(T(p.m)) {
+    }
+
     bool equals(const aePointT<T> &rhs, const T &epsilon = T(aeEpsilon)) const;
+
+private:
+    template <typename V>
+    static bool within(const V &a, const V &b, const V &e, std::false_type) {
+        return std::abs(a - b) <= e;
+    }
+
+    // the distance between integers taken unsigned, so it cannot overflow
+    template <typename V>
+    static bool within(const V &a, const V &b, const V &e, std::true_type) {
+        typedef typename std::make_unsigned<V>::type U;
+        if (e < V()) {
+            return false;
+        }
+        return ((a < b) ? U(b) - U(a) : U(a) - U(b)) <= U(e);
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
 bool aePointT<T>::equals(const aePointT<T> &p, const T &e) const {
-    return std::abs(p.x - x) <= e &&
-           std::abs(p.y - y) <= e &&
-           std::abs(p.z - z) <= e &&
-           std::abs(p.m - m) <= e;
+    std::is_integral<T> integral;
+    return within(p.x, x, e, integral) &&
+           within(p.y, y, e, integral) &&
+           within(p.z, z, e, integral) &&
+           within(p.m, m, e, integral);
 }
 
 template <typename T>
@@ -149,6 +173,353 @@ typedef aePointT<double> aePoint;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+//  @note Compact points for data without Z and/or M values, holding only the
+//  coordinates they need.  They support the same arithmetic as aePointT and
+//  convert to it implicitly (missing values are zero); converting from
+//  aePointT is explicit, since it discards coordinates.  aePackedPointsT
+//  stores a whole geometry this way.
+
+template <typename T>
+struct aePointXYT {
+    T x;
+    T y;
+
+    aePointXYT(): x(), y() {
+    }
+
+    aePointXYT(
+        const T &x,
+        const T &y
+    ): x(x), y(y) {
+    }
+
+    explicit aePointXYT(
+        const aePointT<T> &p
+    ): x(p.x), y(p.y) {
+    }
+
+    operator aePointT<T>() const {
+        return aePointT<T>(x, y, T(), T());
+    }
+
+    bool equals(const aePointXYT<T> &p, const T &e = T(aeEpsilon)) const {
+        return std::abs(p.x - x) <= e &&
+               std::abs(p.y - y) <= e;
+    }
+};
+
+template <typename T>
+struct aePointXYZT {
+    T x;
+    T y;
+    T z;
+
+    aePointXYZT(): x(), y(), z() {
+    }
+
+    aePointXYZT(
+        const T &x,
+        const T &y,
+        const T &z
+    ): x(x), y(y), z(z) {
+    }
+
+    explicit aePointXYZT(
+        const aePointT<T> &p
+    ): x(p.x), y(p.y), z(p.z) {
+    }
+
+    operator aePointT<T>() const {
+        return aePointT<T>(x, y, z, T());
+    }
+
+    bool equals(const aePointXYZT<T> &p, const T &e = T(aeEpsilon)) const {
+        return std::abs(p.x - x) <= e &&
+               std::abs(p.y - y) <= e &&
+               std::abs(p.z - z) <= e;
+    }
+};
+
+template <typename T>
+struct aePointXYMT {
+    T x;
+    T y;
+    T m;
+
+    aePointXYMT(): x(), y(), m() {
+    }
+
+    aePointXYMT(
+        const T &x,
+        const T &y,
+        const T &m
+    ): x(x), y(y), m(m) {
+    }
+
+    explicit aePointXYMT(
+        const aePointT<T> &p
+    ): x(p.x), y(p.y), m(p.m) {
+    }
+
+    operator aePointT<T>() const {
+        return aePointT<T>(x, y, T(), m);
+    }
+
+    bool equals(const aePointXYMT<T> &p, const T &e = T(aeEpsilon)) const {
+        return std::abs(p.x - x) <= e &&
+               std::abs(p.y - y) <= e &&
+               std::abs(p.m - m) <= e;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool operator == (const aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return a.equals(b);
+}
+
+template <typename T>
+bool operator != (const aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return !a.equals(b);
+}
+
+template <typename T>
+aePointXYT<T> operator + (const aePointXYT<T> &a) {
+    return a;
+}
+
+template <typename T>
+aePointXYT<T> operator - (const aePointXYT<T> &a) {
+    return aePointXYT<T>(-a.x, -a.y);
+}
+
+template <typename T>
+aePointXYT<T> operator + (const aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return aePointXYT<T>(a.x + b.x, a.y + b.y);
+}
+
+template <typename T>
+aePointXYT<T> operator - (const aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return aePointXYT<T>(a.x - b.x, a.y - b.y);
+}
+
+template <typename T>
+aePointXYT<T> operator * (const aePointXYT<T> &a, const T &b) {
+    return aePointXYT<T>(a.x * b, a.y * b);
+}
+
+template <typename T>
+aePointXYT<T> operator * (const T &a, const aePointXYT<T> &b) {
+    return aePointXYT<T>(a * b.x, a * b.y);
+}
+
+template <typename T>
+aePointXYT<T> operator / (const aePointXYT<T> &a, const T &b) {
+    return aePointXYT<T>(a.x / b, a.y / b);
+}
+
+template <typename T>
+aePointXYT<T> &operator += (aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return a.x += b.x, a.y += b.y, a;
+}
+
+template <typename T>
+aePointXYT<T> &operator -= (aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return a.x -= b.x, a.y -= b.y, a;
+}
+
+template <typename T>
+aePointXYT<T> &operator *= (aePointXYT<T> &a, const T &b) {
+    return a.x *= b, a.y *= b, a;
+}
+
+template <typename T>
+aePointXYT<T> &operator /= (aePointXYT<T> &a, const T &b) {
+    return a.x /= b, a.y /= b, a;
+}
+
+template <typename T>
+T dot(const aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+template <typename T>
+T det(const aePointXYT<T> &a, const aePointXYT<T> &b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool operator == (const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return a.equals(b);
+}
+
+template <typename T>
+bool operator != (const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return !a.equals(b);
+}
+
+template <typename T>
+aePointXYZT<T> operator + (const aePointXYZT<T> &a) {
+    return a;
+}
+
+template <typename T>
+aePointXYZT<T> operator - (const aePointXYZT<T> &a) {
+    return aePointXYZT<T>(-a.x, -a.y, -a.z);
+}
+
+template <typename T>
+aePointXYZT<T> operator + (const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return aePointXYZT<T>(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+template <typename T>
+aePointXYZT<T> operator - (const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return aePointXYZT<T>(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+template <typename T>
+aePointXYZT<T> operator * (const aePointXYZT<T> &a, const T &b) {
+    return aePointXYZT<T>(a.x * b, a.y * b, a.z * b);
+}
+
+template <typename T>
+aePointXYZT<T> operator * (const T &a, const aePointXYZT<T> &b) {
+    return aePointXYZT<T>(a * b.x, a * b.y, a * b.z);
+}
+
+template <typename T>
+aePointXYZT<T> operator / (const aePointXYZT<T> &a, const T &b) {
+    return aePointXYZT<T>(a.x / b, a.y / b, a.z / b);
+}
+
+template <typename T>
+aePointXYZT<T> &operator += (aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return a.x += b.x, a.y += b.y, a.z += b.z, a;
+}
+
+template <typename T>
+aePointXYZT<T> &operator -= (aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return a.x -= b.x, a.y -= b.y, a.z -= b.z, a;
+}
+
+template <typename T>
+aePointXYZT<T> &operator *= (aePointXYZT<T> &a, const T &b) {
+    return a.x *= b, a.y *= b, a.z *= b, a;
+}
+
+template <typename T>
+aePointXYZT<T> &operator /= (aePointXYZT<T> &a, const T &b) {
+    return a.x /= b, a.y /= b, a.z /= b, a;
+}
+
+template <typename T>
+T dot(const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename T>
+T det(const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+template <typename T>
+aePointXYZT<T> cross(const aePointXYZT<T> &a, const aePointXYZT<T> &b) {
+    return aePointXYZT<T>(
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x
+    );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+bool operator == (const aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return a.equals(b);
+}
+
+template <typename T>
+bool operator != (const aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return !a.equals(b);
+}
+
+template <typename T>
+aePointXYMT<T> operator + (const aePointXYMT<T> &a) {
+    return a;
+}
+
+template <typename T>
+aePointXYMT<T> operator - (const aePointXYMT<T> &a) {
+    return aePointXYMT<T>(-a.x, -a.y, -a.m);
+}
+
+template <typename T>
+aePointXYMT<T> operator + (const aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return aePointXYMT<T>(a.x + b.x, a.y + b.y, a.m + b.m);
+}
+
+template <typename T>
+aePointXYMT<T> operator - (const aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return aePointXYMT<T>(a.x - b.x, a.y - b.y, a.m - b.m);
+}
+
+template <typename T>
+aePointXYMT<T> operator * (const aePointXYMT<T> &a, const T &b) {
+    return aePointXYMT<T>(a.x * b, a.y * b, a.m * b);
+}
+
+template <typename T>
+aePointXYMT<T> operator * (const T &a, const aePointXYMT<T> &b) {
+    return aePointXYMT<T>(a * b.x, a * b.y, a * b.m);
+}
+
+template <typename T>
+aePointXYMT<T> operator / (const aePointXYMT<T> &a, const T &b) {
+    return aePointXYMT<T>(a.x / b, a.y / b, a.m / b);
+}
+
+template <typename T>
+aePointXYMT<T> &operator += (aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return a.x += b.x, a.y += b.y, a.m += b.m, a;
+}
+
+template <typename T>
+aePointXYMT<T> &operator -= (aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return a.x -= b.x, a.y -= b.y, a.m -= b.m, a;
+}
+
+template <typename T>
+aePointXYMT<T> &operator *= (aePointXYMT<T> &a, const T &b) {
+    return a.x *= b, a.y *= b, a.m *= b, a;
+}
+
+template <typename T>
+aePointXYMT<T> &operator /= (aePointXYMT<T> &a, const T &b) {
+    return a.x /= b, a.y /= b, a.m /= b, a;
+}
+
+template <typename T>
+T dot(const aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+template <typename T>
+T det(const aePointXYMT<T> &a, const aePointXYMT<T> &b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aePointXYT<double> aePointXY;
+typedef aePointXYZT<double> aePointXYZ;
+typedef aePointXYMT<double> aePointXYM;
+
+////////////////////////////////////////////////////////////////////////////////
+
 #endif // AEPOINT_HPP_INCLUDE_GUARD
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aepred.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    //  An expansion is a sum of non-overlapping doubles, ordered by increasing
+    //  magnitude, with zero components eliminated.  N bounds its length, so
+    //  expansions live on the stack; each operation's result type carries the
+    //  bound for its inputs' bounds.
+    template <std::size_t N>
+    struct Expansion {
+        double v[N];
+        std::size_t n;
+
+        Expansion(): n(0) {}
+    };
+
+    static const double splitter = 134217729.0; // 2^27 + 1
+
+    inline void twoSum(double a, double b, double &x, double &y) {
+        x = a + b;
+        double bv = x - a;
+        double av = x - bv;
+        y = (a - av) + (b - bv);
+    }
+
+    inline void twoDiff(double a, double b, double &x, double &y) {
+        x = a - b;
+        double bv = a - x;
+        double av = x + bv;
+        y = (a - av) + (bv - b);
+    }
+
+    inline void split(double a, double &hi, double &lo) {
+        double c = splitter * a;
+        double abig = c - a;
+        hi = c - abig;
+        lo = a - hi;
+    }
+
+    inline void twoProduct(double a, double b, double &x, double &y) {
+        double ahi, alo, bhi, blo;
+        x = a * b;
+        split(a, ahi, alo);
+        split(b, bhi, blo);
+        double err1 = x - (ahi * bhi);
+        double err2 = err1 - (alo * bhi);
+        double err3 = err2 - (ahi * blo);
+        y = (alo * blo) - err3;
+    }
+
+    Expansion<2> difference(double a, double b) {
+        double x, y;
+        twoDiff(a, b, x, y);
+        Expansion<2> h;
+        if (y != 0.0) { h.v[h.n++] = y; }
+        if (x != 0.0) { h.v[h.n++] = x; }
+        return h;
+    }
+
+    // Adds b to h in place; h must have room for one more component
+    template <std::size_t N>
+    void grow(Expansion<N> &h, double b) {
+        double q = b, hh;
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < h.n; ++i) {
+            twoSum(q, h.v[i], q, hh);
+            if (hh != 0.0) {
+                h.v[k++] = hh;
+            }
+        }
+        if (q != 0.0 || k == 0) {
+            h.v[k++] = q;
+        }
+        h.n = k;
+    }
+
+    template <std::size_t M, std::size_t N>
+    Expansion<M + N> sum(const Expansion<M> &e, const Expansion<N> &f) {
+        Expansion<M + N> h;
+        std::copy(e.v, e.v + e.n, h.v);
+        h.n = e.n;
+        for (std::size_t i = 0; i < f.n; ++i) {
+            grow(h, f.v[i]);
+        }
+        return h;
+    }
+
+    template <std::size_t N>
+    Expansion<N> negate(const Expansion<N> &e) {
+        Expansion<N> h;
+        for (std::size_t i = 0; i < e.n; ++i) {
+            h.v[i] = -e.v[i];
+        }
+        h.n = e.n;
+        return h;
+    }
+
+    template <std::size_t N>
+    Expansion<2 * N> scale(const Expansion<N> &e, double b) {
+        Expansion<2 * N> h;
+        if (e.n == 0) {
+            return h;
+        }
+
+        double q, hh, product1, product0, sum;
+        twoProduct(e.v[0], b, q, hh);
+        if (hh != 0.0) {
+            h.v[h.n++] = hh;
+        }
+        for (std::size_t i = 1; i < e.n; ++i) {
+            twoProduct(e.v[i], b, product1, product0);
+            twoSum(q, product0, sum, hh);
+            if (hh != 0.0) {
+                h.v[h.n++] = hh;
+            }
+            twoSum(product1, sum, q, hh);
+            if (hh != 0.0) {
+                h.v[h.n++] = hh;
+            }
+        }
+        if (q != 0.0 || h.n == 0) {
+            h.v[h.n++] = q;
+        }
+        return h;
+    }
+
+    template <std::size_t M, std::size_t N>
+    Expansion<2 * M * N> product(const Expansion<M> &e, const Expansion<N> &f) {
+        Expansion<2 * M * N> h;
+        for (std::size_t i = 0; i < f.n; ++i) {
+            Expansion<2 * M> s = scale(e, f.v[i]);
+            for (std::size_t k = 0; k < s.n; ++k) {
+                grow(h, s.v[k]);
+            }
+        }
+        return h;
+    }
+
+    template <std::size_t N>
+    double estimate(const Expansion<N> &e) {
+        double q = 0.0;
+        for (std::size_t i = 0; i < e.n; ++i) {
+            q += e.v[i];
+        }
+        return q;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double aeOrient2dExact(
+    double ax, double ay,
+    double bx, double by,
+    double cx, double cy
+) {
+    // at most 16 components
+    Expansion<2> acx = difference(ax, cx), acy = difference(ay, cy);
+    Expansion<2> bcx = difference(bx, cx), bcy = difference(by, cy);
+
+    return estimate(sum(product(acx, bcy), negate(product(acy, bcx))));
+}
+
+double aeInCircleExact(
+    double ax, double ay,
+    double bx, double by,
+    double cx, double cy,
+    double dx, double dy
+) {
+    // at most 1536 components, about 12 KB of stack for the largest
+    Expansion<2> adx = difference(ax, dx), ady = difference(ay, dy);
+    Expansion<2> bdx = difference(bx, dx), bdy = difference(by, dy);
+    Expansion<2> cdx = difference(cx, dx), cdy = difference(cy, dy);
+
+    Expansion<16> alift = sum(product(adx, adx), product(ady, ady));
+    Expansion<16> blift = sum(product(bdx, bdx), product(bdy, bdy));
+    Expansion<16> clift = sum(product(cdx, cdx), product(cdy, cdy));
+
+    Expansion<16> bc = sum(product(bdx, cdy), negate(product(cdx, bdy)));
+    Expansion<16> ca = sum(product(cdx, ady), negate(product(adx, cdy)));
+    Expansion<16> ab = sum(product(adx, bdy), negate(product(bdx, ady)));
+
+    return estimate(sum(sum(product(alift, bc), product(blift, ca)),
+                        product(clift, ab)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
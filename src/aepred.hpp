@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEPRED_HPP_INCLUDE_GUARD
+#define AEPRED_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeconst.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Robust geometric predicates after J. R. Shewchuk, "Adaptive Precision
+//  Floating-Point Arithmetic and Fast Robust Geometric Predicates" (1997).
+//  Each predicate first evaluates its determinant in ordinary floating-point
+//  arithmetic and accepts the result if it exceeds a forward error bound;
+//  only when that filter fails is the determinant recomputed exactly using
+//  floating-point expansions.  The sign of the result is always correct; the
+//  magnitude is an approximation.
+//
+//  All predicates are evaluated in double precision, so the float versions
+//  are exact as well.
+
+////////////////////////////////////////////////////////////////////////////////
+
+static constexpr double aeRoundoff = aeEpsilon * 0.5;
+static constexpr double aeOrient2dErrorBound = (3.0 + 16.0 * aeRoundoff) * aeRoundoff;
+static constexpr double aeInCircleErrorBound = (10.0 + 96.0 * aeRoundoff) * aeRoundoff;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Computes the orientation determinant of (a, b, c) exactly.
+ */
+double aeOrient2dExact(
+    double ax, double ay,
+    double bx, double by,
+    double cx, double cy
+);
+
+/**
+ * Computes the in-circle determinant of (a, b, c, d) exactly.
+ */
+double aeInCircleExact(
+    double ax, double ay,
+    double bx, double by,
+    double cx, double cy,
+    double dx, double dy
+);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returns a positive value if a, b and c occur in counterclockwise order, a
+ * negative value if they occur in clockwise order, and zero if they are
+ * collinear.  Only the x and y coordinates are considered.
+ */
+template <typename T>
+inline double aeOrient2d(
+    const aePointT<T> &a,
+    const aePointT<T> &b,
+    const aePointT<T> &c
+) {
+    double detLeft = (double(a.x) - double(c.x)) * (double(b.y) - double(c.y));
+    double detRight = (double(a.y) - double(c.y)) * (double(b.x) - double(c.x));
+    double det = detLeft - detRight;
+    double detSum;
+
+    if (detLeft > 0.0) {
+        if (detRight <= 0.0) {
+            return det;
+        }
+        detSum = detLeft + detRight;
+    } else if (detLeft < 0.0) {
+        if (detRight >= 0.0) {
+            return det;
+        }
+        detSum = -detLeft - detRight;
+    } else {
+        return det;
+    }
+
+    double errorBound = aeOrient2dErrorBound * detSum;
+
+    if (det >= errorBound || -det >= errorBound) {
+        return det;
+    }
+
+    return aeOrient2dExact(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+/**
+ * Returns a positive value if d lies inside the circle passing through a, b
+ * and c, a negative value if it lies outside, and zero if the four points are
+ * cocircular.  The points a, b and c must be in counterclockwise order, or the
+ * sign of the result is reversed.
+ */
+template <typename T>
+inline double aeInCircle(
+    const aePointT<T> &a,
+    const aePointT<T> &b,
+    const aePointT<T> &c,
+    const aePointT<T> &d
+) {
+    double adx = double(a.x) - double(d.x), ady = double(a.y) - double(d.y);
+    double bdx = double(b.x) - double(d.x), bdy = double(b.y) - double(d.y);
+    double cdx = double(c.x) - double(d.x), cdy = double(c.y) - double(d.y);
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) +
+                 blift * (cdxady - adxcdy) +
+                 clift * (adxbdy - bdxady);
+
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                       (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+
+    double errorBound = aeInCircleErrorBound * permanent;
+
+    if (det > errorBound || -det > errorBound) {
+        return det;
+    }
+
+    return aeInCircleExact(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEPRED_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
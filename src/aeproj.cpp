@@ -3,50 +3,694 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aeproj.hpp"
+#include "aeepsg.hpp"
 #include "aeexcept.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename T>
-aeProjectionT<T>::aeProjectionT() {
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/*
+ * Per-point kernels.  Each maps (x, y) to (x', y') with its constants held as
+ * members, so the batch loops below see them as loop invariants.
+ */
+
+static constexpr double degsToRads = aePi / 180.0;
+static constexpr double radsToDegs = 180.0 / aePi;
+
+/*
+ * Latitude at which the Web Mercator square ends, atan(sinh(pi)).
+ */
+static constexpr double mercatorMaxLatitude = 85.051128779806589;
+
+/*
+ * Web Mercator forward and inverse, mapping the sphere onto the square
+ * [-scale*pi, scale*pi] and then offsetting and optionally flipping y:
+ *
+ *     x = offset + scale * lon
+ *     y = offset + sign * scale * atanh(sin(lat))
+ *
+ * atanh(sin(lat)) equals ln(tan(pi/4 + lat/2)) but needs one
+ * transcendental call fewer.
+ */
+
+struct WebMercatorForward {
+    double scale;
+    double offset;
+    double sign;
+
+    WebMercatorForward(double s, double o, double g): scale(s), offset(o), sign(g) {}
+
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        double lat = std::min(std::max(double(y), -mercatorMaxLatitude), mercatorMaxLatitude);
+        double s = std::sin(degsToRads * lat);
+        ox = offset + scale * degsToRads * x;
+        oy = offset + sign * scale * 0.5 * std::log((1.0 + s) / (1.0 - s));
+    }
+};
+
+struct WebMercatorInverse {
+    double scale;
+    double offset;
+    double sign;
+
+    WebMercatorInverse(double s, double o, double g): scale(1.0 / s), offset(o), sign(g) {}
+
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        double u = scale * (double(x) - offset);
+        double v = sign * scale * (double(y) - offset);
+        v = std::min(std::max(v, -aePi), aePi);
+        ox = radsToDegs * u;
+        oy = radsToDegs * std::atan(std::sinh(v));
+    }
+};
+
+/*
+ * A function sampled at regular intervals and interpolated with four-point
+ * cubic (Lagrange) polynomials; the samples extend two intervals past each
+ * end of the range.
+ */
+struct CubicTable {
+    double origin;
+    double step;
+    double inverseStep;
+    std::vector<double> values;
+
+    template <typename F>
+    CubicTable(double lo, double hi, double h, F f):
+        origin(lo - 2.0 * h), step(h), inverseStep(1.0 / h) {
+        std::size_t n = std::size_t(std::ceil((hi - lo) / h)) + 5;
+        values.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            values[i] = f(origin + i * step);
+        }
+    }
+
+    double operator () (double u) const {
+        double r = (u - origin) * inverseStep;
+        if (!(r == r)) {
+            return r;
+        }
+        // Callers clamp to the range; this keeps the four samples in bounds
+        // for anything that still falls outside it.
+        r = std::min(std::max(r, 1.0), double(values.size() - 3));
+        std::size_t i = std::min(std::size_t(r), values.size() - 3);
+        double t = r - i;
+        const double *v = &values[i - 1];
+        double tm1 = t - 1.0, tm2 = t - 2.0, tp1 = t + 1.0;
+        return (-t * tm1 * tm2 * v[0] + 3.0 * tp1 * tm1 * tm2 * v[1] -
+                3.0 * tp1 * t * tm2 * v[2] + tp1 * t * tm1 * v[3]) / 6.0;
+    }
+};
+
+/*
+ * atanh(sin(lat)) for latitudes in degrees, every 1/32 degree.
+ */
+const CubicTable &mercatorForwardTable() {
+    static const CubicTable table(
+        -mercatorMaxLatitude, mercatorMaxLatitude, 1.0 / 32.0,
+        [](double lat) {
+            double s = std::sin(degsToRads * lat);
+            return 0.5 * std::log((1.0 + s) / (1.0 - s));
+        }
+    );
+    return table;
 }
 
-template <typename T>
-aeProjectionT<T>::aeProjectionT(
-    aeWKID wkid
-): mWKID(wkid) {
+/*
+ * atan(sinh(v)) in degrees for v in [-pi, pi], every pi/1024.
+ */
+const CubicTable &mercatorInverseTable() {
+    static const CubicTable table(
+        -aePi, aePi, aePi / 1024.0,
+        [](double v) {
+            return radsToDegs * std::atan(std::sinh(v));
+        }
+    );
+    return table;
+}
+
+struct WebMercatorForwardApprox {
+    double scale;
+    double offset;
+    double sign;
+    const CubicTable &table;
+
+    WebMercatorForwardApprox(double s, double o, double g):
+        scale(s), offset(o), sign(g), table(mercatorForwardTable()) {}
+
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        double lat = std::min(std::max(double(y), -mercatorMaxLatitude), mercatorMaxLatitude);
+        ox = offset + scale * degsToRads * x;
+        oy = offset + sign * scale * table(lat);
+    }
+};
+
+struct WebMercatorInverseApprox {
+    double scale;
+    double offset;
+    double sign;
+    const CubicTable &table;
+
+    WebMercatorInverseApprox(double s, double o, double g):
+        scale(1.0 / s), offset(o), sign(g), table(mercatorInverseTable()) {}
+
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        double u = scale * (double(x) - offset);
+        double v = sign * scale * (double(y) - offset);
+        v = std::min(std::max(v, -aePi), aePi);
+        ox = radsToDegs * u;
+        oy = table(v);
+    }
+};
+
+/*
+ * EPSG:3857, in metres.
+ */
+static constexpr double mercatorRadius = 6378137.0;
+
+template <typename K>
+K metres() {
+    return K(mercatorRadius, 0.0, 1.0);
+}
+
+/*
+ * The 256-unit zoom level 0 tile, y down.
+ */
+template <typename K>
+K pixels() {
+    return K(128.0 / aePi, 128.0, -1.0);
+}
+
+struct TransverseMercatorForward {
+    const aeTransverseMercator &tm;
+
+    TransverseMercatorForward(const aeTransverseMercator &t): tm(t) {}
+
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        double u, v;
+        tm.forward(x, y, u, v);
+        ox = u;
+        oy = v;
+    }
+};
+
+struct TransverseMercatorInverse {
+    const aeTransverseMercator &tm;
+
+    TransverseMercatorInverse(const aeTransverseMercator &t): tm(t) {}
+
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        double u, v;
+        tm.inverse(x, y, u, v);
+        ox = u;
+        oy = v;
+    }
+};
+
+template <typename T, typename K>
+void transformPoints(const aePointT<T> *in, aePointT<T> *out, std::size_t count, const K &k) {
+    for (std::size_t i = 0; i < count; ++i) {
+        T x = in[i].x, y = in[i].y;
+        out[i].z = in[i].z;
+        out[i].m = in[i].m;
+        k(x, y, out[i].x, out[i].y);
+    }
+}
+
+template <typename T, typename K>
+void transformArrays(
+    const T *xin, const T *yin,
+    T *xout, T *yout,
+    std::size_t count,
+    const K &k
+) {
+    for (std::size_t i = 0; i < count; ++i) {
+        T x = xin[i], y = yin[i];
+        k(x, y, xout[i], yout[i]);
+    }
 }
 
 template <typename T>
-aePointT<T> aeProjectionT<T>::project(const aePointT<T> &p) const {
-    switch (mWKID) {
+void copyPoints(const aePointT<T> *in, aePointT<T> *out, std::size_t count) {
+    if (in != out) {
+        std::copy(in, in + count, out);
+    }
+}
+
+struct Identity {
+    template <typename T>
+    void operator () (T x, T y, T &ox, T &oy) const {
+        ox = x;
+        oy = y;
+    }
+};
+
+/*
+ * Call f with the forward or inverse kernel of a projection.
+ */
+template <typename F>
+void withForward(aeWKID wkid, const aeTransverseMercator *tm, bool approximate, const F &f) {
+    switch (wkid) {
         case aeWKID::WebMercator: {
-            return toWebMercator(p);
+            if (approximate) {
+                f(metres<WebMercatorForwardApprox>());
+            } else {
+                f(metres<WebMercatorForward>());
+            }
+            break;
         }
 
-        //! @todo
+        case aeWKID::WebMercatorPixels: {
+            if (approximate) {
+                f(pixels<WebMercatorForwardApprox>());
+            } else {
+                f(pixels<WebMercatorForward>());
+            }
+            break;
+        }
 
         default: {
-            return p;
+            if (tm) {
+                f(TransverseMercatorForward(*tm));
+            } else {
+                f(Identity());
+            }
+            break;
         }
     }
 }
 
-template <typename T>
-aePointT<T> aeProjectionT<T>::unproject(const aePointT<T> &p) const {
-    switch (mWKID) {
+template <typename F>
+void withInverse(aeWKID wkid, const aeTransverseMercator *tm, bool approximate, const F &f) {
+    switch (wkid) {
         case aeWKID::WebMercator: {
-            return fromWebMercator(p);
+            if (approximate) {
+                f(metres<WebMercatorInverseApprox>());
+            } else {
+                f(metres<WebMercatorInverse>());
+            }
+            break;
         }
 
-        //! @todo
+        case aeWKID::WebMercatorPixels: {
+            if (approximate) {
+                f(pixels<WebMercatorInverseApprox>());
+            } else {
+                f(pixels<WebMercatorInverse>());
+            }
+            break;
+        }
 
         default: {
-            return p;
+            if (tm) {
+                f(TransverseMercatorInverse(*tm));
+            } else {
+                f(Identity());
+            }
+            break;
+        }
+    }
+}
+
+/*
+ * Runs a projection kernel over a buffer.
+ */
+template <typename T>
+struct PointsKernel {
+    const aePointT<T> *in;
+    aePointT<T> *out;
+    std::size_t count;
+
+    template <typename K>
+    void operator () (const K &k) const {
+        transformPoints(in, out, count, k);
+    }
+};
+
+template <typename T>
+struct ArraysKernel {
+    const T *xin;
+    const T *yin;
+    T *xout;
+    T *yout;
+    std::size_t count;
+
+    template <typename K>
+    void operator () (const K &k) const {
+        transformArrays(xin, yin, xout, yout, count, k);
+    }
+};
+
+/*
+ * Point sources and sinks for the fused transformation loop.
+ */
+template <typename T>
+struct PointBuffer {
+    const aePointT<T> *in;
+    aePointT<T> *out;
+
+    void load(std::size_t i, double &x, double &y, double &z, T &m) const {
+        x = in[i].x;
+        y = in[i].y;
+        z = in[i].z;
+        m = in[i].m;
+    }
+
+    void store(std::size_t i, double x, double y, double z, T m) const {
+        out[i] = aePointT<T>(x, y, z, m);
+    }
+};
+
+template <typename T>
+struct ArrayBuffer {
+    const T *xin;
+    const T *yin;
+    T *xout;
+    T *yout;
+
+    void load(std::size_t i, double &x, double &y, double &z, T &m) const {
+        x = xin[i];
+        y = yin[i];
+        z = 0.0;
+        m = T();
+    }
+
+    void store(std::size_t i, double x, double y, double /*z*/, T /*m*/) const {
+        xout[i] = x;
+        yout[i] = y;
+    }
+};
+
+/*
+ * The fused loop: every step of the pipeline is applied to one point before
+ * moving to the next.
+ */
+template <typename T, typename P, typename B, typename U, typename F>
+void fusedLoop(const P &pipeline, const B &buffer, std::size_t count, const U &inverse, const F &forward) {
+    const aeDatumShift *shift = pipeline.shift.get();
+    const aeVerticalDatum *sourceVDatum = pipeline.sourceVDatum;
+    const aeVerticalDatum *targetVDatum = pipeline.targetVDatum;
+    const bool swapSource = pipeline.swapSource;
+    const bool swapTarget = pipeline.swapTarget;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        double x, y, z;
+        T m;
+        buffer.load(i, x, y, z, m);
+
+        if (swapSource) {
+            std::swap(x, y);
+        }
+
+        inverse(x, y, x, y);
+
+        if (sourceVDatum) {
+            z += sourceVDatum->offset(x, y);
+        }
+        if (shift) {
+            shift->apply(x, y, z);
+        }
+        if (targetVDatum) {
+            z -= targetVDatum->offset(x, y);
+        }
+
+        forward(x, y, x, y);
+
+        if (swapTarget) {
+            std::swap(x, y);
         }
+
+        buffer.store(i, x, y, z, m);
     }
 }
 
+template <typename T, typename P, typename B, typename U>
+struct WithTarget {
+    const P &pipeline;
+    const B &buffer;
+    std::size_t count;
+    const U &inverse;
+
+    template <typename F>
+    void operator () (const F &forward) const {
+        fusedLoop<T>(pipeline, buffer, count, inverse, forward);
+    }
+};
+
+template <typename T, typename P, typename B>
+struct WithSource {
+    const P &pipeline;
+    const B &buffer;
+    std::size_t count;
+
+    template <typename U>
+    void operator () (const U &inverse) const {
+        WithTarget<T, P, B, U> next = { pipeline, buffer, count, inverse };
+        withForward(pipeline.targetWKID, pipeline.targetTM, pipeline.targetApproximate, next);
+    }
+};
+
+template <typename T, typename P, typename B>
+void runPipeline(const P &pipeline, const B &buffer, std::size_t count) {
+    WithSource<T, P, B> next = { pipeline, buffer, count };
+    withInverse(pipeline.sourceWKID, pipeline.sourceTM, pipeline.sourceApproximate, next);
+}
+
+/*
+ * Runs a point-array operation over x and y arrays in blocks, through a small
+ * buffer of points with zero z and m.
+ */
+template <typename T, typename F>
+void shiftArrays(
+    const T *xin, const T *yin,
+    T *xout, T *yout,
+    std::size_t count,
+    F f
+) {
+    static const std::size_t block = 256;
+    aePointT<T> buffer[block];
+
+    for (std::size_t i = 0; i < count; i += block) {
+        std::size_t n = std::min(block, count - i);
+        for (std::size_t j = 0; j < n; ++j) {
+            buffer[j] = aePointT<T>(xin[i + j], yin[i + j]);
+        }
+        f(buffer, n);
+        for (std::size_t j = 0; j < n; ++j) {
+            xout[i + j] = buffer[j].x;
+            yout[i + j] = buffer[j].y;
+        }
+    }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aeProjectionT<T>::aeProjectionT(
+): mWKID(aeWKID::NullTransform), mDatum(nullptr), mVDatum(nullptr), mApproximate(false) {
+    update();
+}
+
+template <typename T>
+aeProjectionT<T>::aeProjectionT(
+    aeWKID wkid
+): mWKID(wkid), mDatum(nullptr), mVDatum(nullptr), mApproximate(false) {
+    update();
+}
+
+template <typename T>
+void aeProjectionT<T>::update() {
+    aeEPSGDefinition definition;
+    bool known = aeEPSG::lookup(int32_t(mWKID), definition);
+
+    if (!mDatum) {
+        mDatum = known ? definition.datum : &aeDatum::wgs84();
+    }
+
+    const aeDatum &datum = *mDatum;
+
+    mTransverseMercator.reset();
+    if (known && definition.method == aeEPSGDefinition::TransverseMercator) {
+        mTransverseMercator = std::make_shared<aeTransverseMercator>(
+            datum.semiMajorAxis(), datum.flattening(),
+            definition.centralMeridian, definition.latitudeOfOrigin,
+            definition.scaleFactor,
+            definition.falseEasting, definition.falseNorthing
+        );
+    }
+
+    mToDatum.reset();
+    mFromDatum.reset();
+    if (!datum.isWGS84()) {
+        mToDatum = std::make_shared<aeDatumShift>(aeDatum::wgs84(), datum);
+        mFromDatum = std::make_shared<aeDatumShift>(datum, aeDatum::wgs84());
+    }
+}
+
+template <typename T>
+const aeDatum &aeProjectionT<T>::getDatum() const {
+    return *mDatum;
+}
+
+template <typename T>
+void aeProjectionT<T>::setDatum(const aeDatum &datum) {
+    mDatum = &datum;
+    update();
+}
+
+template <typename T>
+const aeVerticalDatum *aeProjectionT<T>::getVerticalDatum() const {
+    return mVDatum;
+}
+
+template <typename T>
+void aeProjectionT<T>::setVerticalDatum(const aeVerticalDatum *vdatum) {
+    mVDatum = vdatum;
+}
+
+template <typename T>
+void aeProjectionT<T>::toDatum(
+    const aePointT<T> *in,
+    aePointT<T> *out,
+    std::size_t count
+) const {
+    if (mToDatum) {
+        mToDatum->apply(in, out, count);
+    } else {
+        copyPoints(in, out, count);
+    }
+
+    if (mVDatum) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i].z -= mVDatum->offset(out[i].x, out[i].y);
+        }
+    }
+}
+
+template <typename T>
+void aeProjectionT<T>::fromDatum(
+    const aePointT<T> *in,
+    aePointT<T> *out,
+    std::size_t count
+) const {
+    copyPoints(in, out, count);
+
+    if (mVDatum) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i].z += mVDatum->offset(out[i].x, out[i].y);
+        }
+    }
+
+    if (mFromDatum) {
+        mFromDatum->apply(out, out, count);
+    }
+}
+
+template <typename T>
+aePointT<T> aeProjectionT<T>::project(const aePointT<T> &p) const {
+    aePointT<T> q;
+    project(&p, &q, 1);
+    return q;
+}
+
+template <typename T>
+aePointT<T> aeProjectionT<T>::unproject(const aePointT<T> &p) const {
+    aePointT<T> q;
+    unproject(&p, &q, 1);
+    return q;
+}
+
+template <typename T>
+void aeProjectionT<T>::project(
+    const aePointT<T> *in,
+    aePointT<T> *out,
+    std::size_t count
+) const {
+    if (hasDatumShift()) {
+        toDatum(in, out, count);
+        in = out;
+    }
+
+    PointsKernel<T> kernel = { in, out, count };
+    withForward(mWKID, mTransverseMercator.get(), mApproximate, kernel);
+}
+
+template <typename T>
+void aeProjectionT<T>::unproject(
+    const aePointT<T> *in,
+    aePointT<T> *out,
+    std::size_t count
+) const {
+    PointsKernel<T> kernel = { in, out, count };
+    withInverse(mWKID, mTransverseMercator.get(), mApproximate, kernel);
+
+    if (hasDatumShift()) {
+        fromDatum(out, out, count);
+    }
+}
+
+template <typename T>
+void aeProjectionT<T>::project(
+    const T *xin, const T *yin,
+    T *xout, T *yout,
+    std::size_t count
+) const {
+    if (hasDatumShift()) {
+        shiftArrays(xin, yin, xout, yout, count, [this](aePointT<T> *p, std::size_t n) {
+            toDatum(p, p, n);
+        });
+        xin = xout;
+        yin = yout;
+    }
+
+    ArraysKernel<T> kernel = { xin, yin, xout, yout, count };
+    withForward(mWKID, mTransverseMercator.get(), mApproximate, kernel);
+}
+
+template <typename T>
+void aeProjectionT<T>::unproject(
+    const T *xin, const T *yin,
+    T *xout, T *yout,
+    std::size_t count
+) const {
+    ArraysKernel<T> kernel = { xin, yin, xout, yout, count };
+    withInverse(mWKID, mTransverseMercator.get(), mApproximate, kernel);
+
+    if (hasDatumShift()) {
+        shiftArrays(xout, yout, xout, yout, count, [this](aePointT<T> *p, std::size_t n) {
+            fromDatum(p, p, n);
+        });
+    }
+}
+
+template <typename T>
+bool aeProjectionT<T>::isApproximate() const {
+    return mApproximate;
+}
+
+template <typename T>
+void aeProjectionT<T>::setApproximate(bool approximate) {
+    mApproximate = approximate;
+}
+
 template <typename T>
 aeWKID aeProjectionT<T>::getWKID() const {
     return mWKID;
@@ -54,33 +698,310 @@ aeWKID aeProjectionT<T>::getWKID() const {
 
 template <typename T>
 std::string aeProjectionT<T>::toString() const {
-    //! @todo
-    return std::string();
+    if (mWKID == aeWKID::NullTransform) {
+        return aeEPSG::toWKT(int32_t(aeWKID::WGS84));
+    }
+    return aeEPSG::toWKT(int32_t(mWKID));
 }
 
 template <typename T>
 aePointT<T> aeProjectionT<T>::toWebMercator(const aePointT<T> &p) {
-    static const double degsToRads = aePi / 180.0;
-    static const double scaleFactor = 128.0 / aePi;
-    /*
-     * x = (128/pi)*(2**zoom)*(lon+pi);
-     * y = (128/pi)*(2**zoom)*(pi-ln(tan(pi/4+lat/2)));
-     */
     aePointT<T> q(p);
-    q.x = scaleFactor * (aePi + degsToRads * p.x);
-    q.y = scaleFactor * (aePi - std::log(std::tan(aePi / 4.0 + degsToRads * p.y / 2.0)));
+    metres<WebMercatorForward>()(p.x, p.y, q.x, q.y);
     return q;
 }
 
 template <typename T>
-aePointT<T> aeProjectionT<T>::fromWebMercator(const aePointT<T> & /*p*/) {
-    throw aeNotImplementedError();
+aePointT<T> aeProjectionT<T>::fromWebMercator(const aePointT<T> &p) {
+    aePointT<T> q(p);
+    metres<WebMercatorInverse>()(p.x, p.y, q.x, q.y);
+    return q;
+}
+
+template <typename T>
+aePointT<T> aeProjectionT<T>::toWebMercatorPixels(const aePointT<T> &p) {
+    aePointT<T> q(p);
+    pixels<WebMercatorForward>()(p.x, p.y, q.x, q.y);
+    return q;
+}
+
+template <typename T>
+aePointT<T> aeProjectionT<T>::fromWebMercatorPixels(const aePointT<T> &p) {
+    aePointT<T> q(p);
+    pixels<WebMercatorInverse>()(p.x, p.y, q.x, q.y);
+    return q;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct aeCoordinateTransformT<T>::Pipeline {
+    aeProjectionT<T> source;
+    aeProjectionT<T> target;
+    aeWKID sourceWKID;
+    aeWKID targetWKID;
+    const aeTransverseMercator *sourceTM;
+    const aeTransverseMercator *targetTM;
+    const aeVerticalDatum *sourceVDatum;
+    const aeVerticalDatum *targetVDatum;
+    bool sourceApproximate;
+    bool targetApproximate;
+    std::shared_ptr<const aeDatumShift> shift;
+    bool swapSource;
+    bool swapTarget;
+
+    Pipeline(const aeProjectionT<T> &s, const aeProjectionT<T> &t, unsigned int options):
+        source(s), target(t),
+        sourceWKID(s.mWKID), targetWKID(t.mWKID),
+        sourceTM(source.mTransverseMercator.get()),
+        targetTM(target.mTransverseMercator.get()),
+        sourceVDatum(s.mVDatum), targetVDatum(t.mVDatum),
+        sourceApproximate(s.mApproximate), targetApproximate(t.mApproximate),
+        swapSource((options & SwapSourceAxes) != 0),
+        swapTarget((options & SwapTargetAxes) != 0) {
+        std::shared_ptr<aeDatumShift> datumShift =
+            std::make_shared<aeDatumShift>(s.getDatum(), t.getDatum());
+        if (!datumShift->isIdentity()) {
+            shift = datumShift;
+        }
+    }
+};
+
+namespace {
+
+typedef std::tuple<int32_t, int32_t, unsigned int> PipelineKey;
+
+/*
+ * The pipeline cache for one coordinate type.
+ */
+template <typename P>
+struct PipelineCache {
+    std::mutex mutex;
+    std::map< PipelineKey, std::shared_ptr<const P> > pipelines;
+
+    static PipelineCache &instance() {
+        static PipelineCache cache;
+        return cache;
+    }
+};
+
+} // namespace
+
+template <typename T>
+aeCoordinateTransformT<T>::aeCoordinateTransformT(
+    aeWKID source,
+    aeWKID target,
+    unsigned int options
+) {
+    PipelineCache<Pipeline> &cache = PipelineCache<Pipeline>::instance();
+    PipelineKey key(int32_t(source), int32_t(target), options);
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    std::shared_ptr<const Pipeline> &pipeline = cache.pipelines[key];
+    if (!pipeline) {
+        pipeline = std::make_shared<Pipeline>(
+            aeProjectionT<T>(source), aeProjectionT<T>(target), options
+        );
+    }
+    mPipeline = pipeline;
+}
+
+template <typename T>
+aeCoordinateTransformT<T>::aeCoordinateTransformT(
+    const aeProjectionT<T> &source,
+    const aeProjectionT<T> &target,
+    unsigned int options
+): mPipeline(std::make_shared<Pipeline>(source, target, options)) {
+}
+
+template <typename T>
+const aeProjectionT<T> &aeCoordinateTransformT<T>::source() const {
+    return mPipeline->source;
+}
+
+template <typename T>
+const aeProjectionT<T> &aeCoordinateTransformT<T>::target() const {
+    return mPipeline->target;
+}
+
+template <typename T>
+aePointT<T> aeCoordinateTransformT<T>::apply(const aePointT<T> &p) const {
+    aePointT<T> q;
+    apply(&p, &q, 1);
+    return q;
+}
+
+template <typename T>
+void aeCoordinateTransformT<T>::apply(
+    const aePointT<T> *in,
+    aePointT<T> *out,
+    std::size_t count
+) const {
+    PointBuffer<T> buffer = { in, out };
+    runPipeline<T>(*mPipeline, buffer, count);
+}
+
+template <typename T>
+void aeCoordinateTransformT<T>::apply(
+    const T *xin, const T *yin,
+    T *xout, T *yout,
+    std::size_t count
+) const {
+    ArrayBuffer<T> buffer = { xin, yin, xout, yout };
+    runPipeline<T>(*mPipeline, buffer, count);
+}
+
+template <typename T>
+std::size_t aeCoordinateTransformT<T>::cacheSize() {
+    PipelineCache<Pipeline> &cache = PipelineCache<Pipeline>::instance();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.pipelines.size();
+}
+
+template <typename T>
+void aeCoordinateTransformT<T>::clearCache() {
+    PipelineCache<Pipeline> &cache = PipelineCache<Pipeline>::instance();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.pipelines.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+aeGridTransformT<T>::aeGridTransformT(
+    const aeCoordinateTransformT<T> &transform,
+    const aeExtentT<T> &extent,
+    unsigned int columns,
+    unsigned int rows
+): mTransform(transform), mColumns(columns), mRows(rows), mMaxError(0.0) {
+    double width = double(extent.max.x) - double(extent.min.x);
+    double height = double(extent.max.y) - double(extent.min.y);
+
+    if (columns == 0 || rows == 0 || !(width > 0.0) || !(height > 0.0)) {
+        throw aeArgumentError("aeGridTransform: empty grid");
+    }
+
+    mX0 = extent.min.x;
+    mY0 = extent.min.y;
+    mScaleX = columns / width;
+    mScaleY = rows / height;
+
+    // exact values at the nodes, then at the cell centres to measure the error
+    std::vector< aePointT<T> > nodes;
+    nodes.reserve((columns + 1) * (rows + 1));
+    for (unsigned int j = 0; j <= rows; ++j) {
+        for (unsigned int i = 0; i <= columns; ++i) {
+            nodes.push_back(aePointT<T>(mX0 + i / mScaleX, mY0 + j / mScaleY));
+        }
+    }
+
+    std::vector< aePointT<T> > projected(nodes.size());
+    mTransform.apply(nodes.data(), projected.data(), nodes.size());
+
+    mNodes.resize(3 * nodes.size());
+    for (std::size_t k = 0; k < nodes.size(); ++k) {
+        mNodes[3 * k + 0] = projected[k].x;
+        mNodes[3 * k + 1] = projected[k].y;
+        mNodes[3 * k + 2] = projected[k].z;
+    }
+
+    std::vector< aePointT<T> > centres;
+    centres.reserve(columns * rows);
+    for (unsigned int j = 0; j < rows; ++j) {
+        for (unsigned int i = 0; i < columns; ++i) {
+            centres.push_back(aePointT<T>(mX0 + (i + 0.5) / mScaleX, mY0 + (j + 0.5) / mScaleY));
+        }
+    }
+
+    projected.resize(centres.size());
+    mTransform.apply(centres.data(), projected.data(), centres.size());
+
+    for (std::size_t k = 0; k < centres.size(); ++k) {
+        double x, y, dz;
+        interpolate(centres[k].x, centres[k].y, x, y, dz);
+        mMaxError = std::max(mMaxError, std::hypot(x - projected[k].x, y - projected[k].y));
+    }
+}
+
+template <typename T>
+bool aeGridTransformT<T>::interpolate(
+    double x,
+    double y,
+    double &ox,
+    double &oy,
+    double &dz
+) const {
+    double u = (x - mX0) * mScaleX;
+    double v = (y - mY0) * mScaleY;
+
+    if (!(u >= 0.0 && u <= mColumns && v >= 0.0 && v <= mRows)) {
+        return false;
+    }
+
+    unsigned int i = std::min(unsigned(u), mColumns - 1);
+    unsigned int j = std::min(unsigned(v), mRows - 1);
+    double fu = u - i, fv = v - j;
+
+    const double *a = &mNodes[3 * (j * (mColumns + 1) + i)];
+    const double *b = a + 3 * (mColumns + 1);
+
+    double w00 = (1.0 - fu) * (1.0 - fv), w10 = fu * (1.0 - fv);
+    double w01 = (1.0 - fu) * fv, w11 = fu * fv;
+
+    ox = w00 * a[0] + w10 * a[3] + w01 * b[0] + w11 * b[3];
+    oy = w00 * a[1] + w10 * a[4] + w01 * b[1] + w11 * b[4];
+    dz = w00 * a[2] + w10 * a[5] + w01 * b[2] + w11 * b[5];
+    return true;
+}
+
+template <typename T>
+aePointT<T> aeGridTransformT<T>::apply(const aePointT<T> &p) const {
+    aePointT<T> q;
+    apply(&p, &q, 1);
+    return q;
+}
+
+template <typename T>
+void aeGridTransformT<T>::apply(
+    const aePointT<T> *in,
+    aePointT<T> *out,
+    std::size_t count
+) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        double x, y, dz;
+        if (interpolate(in[i].x, in[i].y, x, y, dz)) {
+            out[i] = aePointT<T>(x, y, in[i].z + dz, in[i].m);
+        } else {
+            mTransform.apply(in + i, out + i, 1);
+        }
+    }
+}
+
+template <typename T>
+void aeGridTransformT<T>::apply(
+    const T *xin, const T *yin,
+    T *xout, T *yout,
+    std::size_t count
+) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        double x, y, dz;
+        if (interpolate(xin[i], yin[i], x, y, dz)) {
+            xout[i] = x;
+            yout[i] = y;
+        } else {
+            mTransform.apply(xin + i, yin + i, xout + i, yout + i, 1);
+        }
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template class aeProjectionT<double>;
 template class aeProjectionT<float>;
+template class aeCoordinateTransformT<double>;
+template class aeCoordinateTransformT<float>;
+template class aeGridTransformT<double>;
+template class aeGridTransformT<float>;
 
 ////////////////////////////////////////////////////////////////////////////////
 // EOF
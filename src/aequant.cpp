@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aequant.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeQuantization aeQuantization::fromExtent(const aeExtent &extent, double resolution) {
+    if (!(resolution > 0.0)) {
+        throw aeArgumentError("aeQuantization: resolution must be positive");
+    }
+
+    aePoint centre = (extent.min + extent.max) / 2.0;
+    aePoint half = (extent.max - extent.min) / 2.0;
+
+    // Axes without data (NaN) are centred on zero
+    if (std::isnan(centre.x)) { centre.x = 0.0; half.x = 0.0; }
+    if (std::isnan(centre.y)) { centre.y = 0.0; half.y = 0.0; }
+    if (std::isnan(centre.z)) { centre.z = 0.0; half.z = 0.0; }
+    if (std::isnan(centre.m)) { centre.m = 0.0; half.m = 0.0; }
+
+    double limit = double(std::numeric_limits<int32_t>::max()) * resolution;
+
+    if (half.x > limit || half.y > limit || half.z > limit || half.m > limit) {
+        throw aeArgumentError("aeQuantization: extent too large for resolution");
+    }
+
+    return aeQuantization(aePoint(resolution, resolution, resolution, resolution), centre);
+}
+
+aeGeometryT<int32_t> aeQuantization::quantize(const aeGeometry &geometry) const {
+    aeGeometryT<int32_t> result(aeGeometryT<int32_t>::Type(geometry.type()));
+
+    result.parts() = geometry.parts();
+    result.partTypes().reserve(geometry.partTypes().size());
+    result.points().reserve(geometry.points().size());
+
+    for (aeGeometry::Type t : geometry.partTypes()) {
+        result.partTypes().push_back(aeGeometryT<int32_t>::Type(t));
+    }
+
+    for (const aePoint &p : geometry.points()) {
+        result.points().push_back(quantize(p));
+    }
+
+    return result;
+}
+
+aeGeometry aeQuantization::dequantize(const aeGeometryT<int32_t> &geometry) const {
+    aeGeometry result(aeGeometry::Type(geometry.type()));
+
+    result.parts() = geometry.parts();
+    result.partTypes().reserve(geometry.partTypes().size());
+    result.points().reserve(geometry.points().size());
+
+    for (aeGeometryT<int32_t>::Type t : geometry.partTypes()) {
+        result.partTypes().push_back(aeGeometry::Type(t));
+    }
+
+    for (const aeFixedPoint &q : geometry.points()) {
+        result.points().push_back(dequantize(q));
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
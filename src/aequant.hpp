@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AEQUANT_HPP_INCLUDE_GUARD
+#define AEQUANT_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aecoord.hpp"
+#include "aeextent.hpp"
+#include "aegeom.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aePointT<int32_t> aeFixedPoint;
+
+//  @note Maps real-world coordinates to 32-bit integers, one transform per
+//  layer: q = round((p - offset) / scale) for each of x, y, z and m.  With a
+//  1 mm scale, for example, an int32 covers some 4,000 km in each axis.
+
+class aeQuantization {
+public:
+    aeQuantization():
+        mScale(1.0, 1.0, 1.0, 1.0), mOffset() {}
+
+    aeQuantization(
+        const aePoint &scale,
+        const aePoint &offset
+    ): mScale(scale), mOffset(offset) {}
+
+    /**
+     * Returns a quantization centred on the given extent with the given
+     * resolution (coordinate units per integer step) for every axis.
+     * Throws aeArgumentError if the extent does not fit at that resolution.
+     */
+    static aeQuantization fromExtent(const aeExtent &extent, double resolution);
+
+    const aePoint &scale() const { return mScale; }
+    const aePoint &offset() const { return mOffset; }
+
+    aeFixedPoint quantize(const aePoint &p) const {
+        typedef aeCoordTraitsT<int32_t> Traits;
+        return aeFixedPoint(
+            Traits::fromReal((p.x - mOffset.x) / mScale.x),
+            Traits::fromReal((p.y - mOffset.y) / mScale.y),
+            Traits::fromReal((p.z - mOffset.z) / mScale.z),
+            Traits::fromReal((p.m - mOffset.m) / mScale.m)
+        );
+    }
+
+    aePoint dequantize(const aeFixedPoint &q) const {
+        return aePoint(
+            mOffset.x + q.x * mScale.x,
+            mOffset.y + q.y * mScale.y,
+            mOffset.z + q.z * mScale.z,
+            mOffset.m + q.m * mScale.m
+        );
+    }
+
+    aeGeometryT<int32_t> quantize(const aeGeometry &geometry) const;
+    aeGeometry dequantize(const aeGeometryT<int32_t> &geometry) const;
+
+private:
+    aePoint mScale;
+    aePoint mOffset;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AEQUANT_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,9 @@
 template class aeStatisticsT<double, unsigned long long>;
 template class aeStatisticsT<float, unsigned long long>;
 
+template class aeWindowStatisticsT<double, unsigned long long>;
+template class aeWindowStatisticsT<float, unsigned long long>;
+
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
 ////////////////////////////////////////////////////////////////////////////////
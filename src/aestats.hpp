@@ -8,19 +8,49 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "aeconst.hpp"
+#include "aeexcept.hpp"
+#include "aeparallel.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cmath>
+#include <cstddef>
+#include <deque>
+#include <type_traits>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
+//  @note Values can be added one at a time, by the Welford/Terriberry
+//  recurrences, or in bulk.  The bulk path cuts an array into cache-sized
+//  blocks, computes each block's moments with a two-pass formula that has
+//  no division in its loops (and splits them over several accumulators so
+//  that they vectorize), and combines the blocks with update(const
+//  aeStatisticsT &).  Large arrays are also split across threads and the
+//  threads' results combined the same way.
+//
+//  Values may also carry weights, which act as frequencies: update(x, 3)
+//  is the same as adding x three times.  count() is the number of values
+//  and weight() their total weight.  variance() is therefore the
+//  frequency-weighted sample variance M2 / (W - 1), which is NaN unless the
+//  total weight exceeds 1; popVariance() suits other weights, such as
+//  areas.  remove() undoes update(), so moments
+//  over a sliding window cost O(1) per value; see aeWindowStatisticsT.
+
 template <typename T, typename N=unsigned long long>
 class aeStatisticsT {
 private:
     static constexpr T mT2 = T(2), mT3 = T(3), mT4 = T(4), mT6 = T(6);
     static constexpr T mNaN = T(aeNaN);
 
+    // Values per block in the bulk path, and per thread below which
+    // splitting the work is not worthwhile
+    static constexpr std::size_t mBlock = 1024;
+    static constexpr std::size_t mGrain = 1 << 16;
+
+    // Independent accumulators per loop in the bulk path
+    static constexpr std::size_t mLanes = 4;
+
 public:
     aeStatisticsT() {
         clear();
@@ -32,8 +62,18 @@ public:
         update(i, j);
     }
 
+    /**
+     * Statistics of count values, summarized on the given number of threads
+     * (zero uses the hardware concurrency).
+     */
+    aeStatisticsT(const T *data, std::size_t count, unsigned int threads = 0) {
+        clear();
+        update(data, count, threads);
+    }
+
     void clear() {
         mN = N();
+        mW = T();
         mMin = mMax = T();
         mM4 = mM3 = mM2 = mM1 = T();
     }
@@ -42,6 +82,10 @@ public:
         return mN;
     }
 
+    T weight() const {
+        return mW;
+    }
+
     aeStatisticsT<T, N> &update(const T &x) {
         if (mN == 0) {
             mMin = mMax = x;
@@ -50,8 +94,9 @@ public:
             if (mMax < x) { mMax = x; }
         }
 
-        T n1(mN);
-        T n(++mN);
+        ++mN;
+        T n1(mW);
+        T n(mW += T(1));
         T d(x - mM1);
         T dn(d / n);
         T dn2(dn * dn);
@@ -63,33 +108,231 @@ public:
         return *this;
     }
 
+    /**
+     * Adds a value with a positive weight; other weights are ignored.
+     */
+    aeStatisticsT<T, N> &update(const T &x, const T &w) {
+        if (!(w > T())) {
+            return *this;
+        }
+
+        if (mN == 0) {
+            mMin = mMax = x;
+        } else {
+            if (mMin > x) { mMin = x; }
+            if (mMax < x) { mMax = x; }
+        }
+
+        // update(const aeStatisticsT &) with a single value of weight w
+        ++mN;
+        T an(mW), n(mW += w);
+        T d(x - mM1), dn(d / n), dw(dn * w), dn2(dn * dn);
+        T a(d * dw * an);
+        mM4 += a * dn2 * (an * an + w * w - an * w) + mT6 * dw * dw * mM2 - mT4 * dw * mM3;
+        mM3 += a * dn * (an - w) - mT3 * dw * mM2;
+        mM2 += a;
+        mM1 += dw;
+        return *this;
+    }
+
     aeStatisticsT<T, N> &update(const aeStatisticsT<T, N> &rhs) {
-        if (rhs.mN > 0) {
-            if (mMin > rhs.mMin) { mMin = rhs.mMin; }
-            if (mMax < rhs.mMax) { mMax = rhs.mMax; }
+        if (rhs.mN == 0) {
+            return *this;
+        }
+
+        if (mN == 0) {
+            return *this = rhs;
         }
 
+        if (mMin > rhs.mMin) { mMin = rhs.mMin; }
+        if (mMax < rhs.mMax) { mMax = rhs.mMax; }
+
         T d(rhs.mM1 - mM1), d2(d * d), d3(d2 * d), d4(d2 * d2);
-        T an(mN), bn(rhs.mN), an2(an * an), bn2(bn * bn), abn(an * bn);
+        T an(mW), bn(rhs.mW), an2(an * an), bn2(bn * bn), abn(an * bn);
         T n(an + bn), dn(an - bn), n2(n * n);
         mM4 += rhs.mM4 + d4 * abn * (an2 + bn2 - abn) / (n2 * n) +
                mT6 * d2 * (an2 * rhs.mM2 + bn2 * mM2) / n2 +
                mT4 * d * (an * rhs.mM3 - bn * mM3) / n;
         mM3 += rhs.mM3 + d3 * abn * dn / n2 +
                mT3 * d * (an * rhs.mM2 - bn * mM2) / n;
-        mM2 += rhs.mM2 + d2 * T(mN) * T(rhs.mN) / n;
-        mM1  = (mN * mM1 + rhs.mN * rhs.mM1) / n;
+        mM2 += rhs.mM2 + d2 * abn / n;
+        mM1  = (an * mM1 + bn * rhs.mM1) / n;
         mN += rhs.mN;
+        mW = n;
         return *this;
     }
 
+    /**
+     * Takes out a value previously added with the same weight, by running
+     * the update recurrences backwards.  min() and max() cannot be undone
+     * and keep their values until clear().
+     */
+    aeStatisticsT<T, N> &remove(const T &x, const T &w = T(1)) {
+        if (!(w > T())) {
+            return *this;
+        }
+
+        aeStatisticsT<T, N> value;
+        value.mN = 1;
+        value.mW = w;
+        value.mMin = value.mMax = value.mM1 = x;
+        return remove(value);
+    }
+
+    /**
+     * Takes out statistics previously merged in with update(const
+     * aeStatisticsT &): the inverse of that merge.  Removing everything
+     * clears the statistics.
+     */
+    aeStatisticsT<T, N> &remove(const aeStatisticsT<T, N> &rhs) {
+        if (rhs.mN == 0) {
+            return *this;
+        }
+
+        if (rhs.mN >= mN || !(rhs.mW < mW)) {
+            clear();
+            return *this;
+        }
+
+        T bn(rhs.mW), n(mW), an(n - bn), an2(an * an), bn2(bn * bn), abn(an * bn);
+        T n2(n * n);
+        mM1 = (n * mM1 - bn * rhs.mM1) / an;
+
+        T d(rhs.mM1 - mM1), d2(d * d), d3(d2 * d), d4(d2 * d2);
+        mM2 -= rhs.mM2 + d2 * abn / n;
+        mM3 -= rhs.mM3 + d3 * abn * (an - bn) / n2 +
+               mT3 * d * (an * rhs.mM2 - bn * mM2) / n;
+        mM4 -= rhs.mM4 + d4 * abn * (an2 + bn2 - abn) / (n2 * n) +
+               mT6 * d2 * (an2 * rhs.mM2 + bn2 * mM2) / n2 +
+               mT4 * d * (an * rhs.mM3 - bn * mM3) / n;
+        mN -= rhs.mN;
+        mW = an;
+        return *this;
+    }
+
+    /**
+     * Adds the values in [i, j); contiguous arrays of T take the bulk path.
+     */
     template <typename I>
     void update(const I &i, const I &j) {
+        updateRange(i, j, std::is_convertible<I, const T *>());
+    }
+
+    /**
+     * Adds count values in blocks, on the given number of threads (zero uses
+     * the hardware concurrency).
+     */
+    aeStatisticsT<T, N> &update(const T *data, std::size_t count, unsigned int threads = 0) {
+        return update(aeParallelReduce<aeStatisticsT<T, N> >(count, mGrain, threads,
+            [data](std::size_t begin, std::size_t end) {
+                aeStatisticsT<T, N> partial;
+                partial.updateBlocks(data + begin, end - begin);
+                return partial;
+            },
+            [](aeStatisticsT<T, N> &result, const aeStatisticsT<T, N> &partial) {
+                result.update(partial);
+            }
+        ));
+    }
+
+private:
+    template <typename I>
+    void updateRange(const I &i, const I &j, std::false_type) {
         for (I k(i); k != j; ++k) {
             update(*k);
         }
     }
 
+    template <typename I>
+    void updateRange(const I &i, const I &j, std::true_type) {
+        const T *first = i, *last = j;
+        updateBlocks(first, std::size_t(last - first));
+    }
+
+    void updateBlocks(const T *data, std::size_t count) {
+        for (std::size_t i = 0; i < count; i += mBlock) {
+            update(block(data + i, (count - i < mBlock) ? count - i : mBlock));
+        }
+    }
+
+    /*
+     * Moments of 0 < n <= mBlock values: the mean from a first pass, then
+     * the sums of powers of the deviations from it, corrected for the
+     * rounding error in the mean.
+     */
+    static aeStatisticsT<T, N> block(const T *x, std::size_t n) {
+        T sum[mLanes] = { }, lo[mLanes], hi[mLanes];
+        std::size_t i = 0, m = n - n % mLanes;
+
+        for (std::size_t k = 0; k < mLanes; ++k) {
+            lo[k] = hi[k] = x[0];
+        }
+
+        for (; i < m; i += mLanes) {
+            for (std::size_t k = 0; k < mLanes; ++k) {
+                T v = x[i + k];
+                sum[k] += v;
+                lo[k] = (v < lo[k]) ? v : lo[k];
+                hi[k] = (v > hi[k]) ? v : hi[k];
+            }
+        }
+
+        for (; i < n; ++i) {
+            T v = x[i];
+            sum[0] += v;
+            lo[0] = (v < lo[0]) ? v : lo[0];
+            hi[0] = (v > hi[0]) ? v : hi[0];
+        }
+
+        aeStatisticsT<T, N> s;
+        s.mN = N(n);
+        s.mW = T(n);
+        s.mMin = lo[0];
+        s.mMax = hi[0];
+        for (std::size_t k = 1; k < mLanes; ++k) {
+            if (s.mMin > lo[k]) { s.mMin = lo[k]; }
+            if (s.mMax < hi[k]) { s.mMax = hi[k]; }
+        }
+
+        const T count(n);
+        const T mean((sum[0] + sum[1] + sum[2] + sum[3]) / count);
+
+        T d1[mLanes] = { }, d2[mLanes] = { }, d3[mLanes] = { }, d4[mLanes] = { };
+
+        for (i = 0; i < m; i += mLanes) {
+            for (std::size_t k = 0; k < mLanes; ++k) {
+                T d = x[i + k] - mean, dd = d * d;
+                d1[k] += d;
+                d2[k] += dd;
+                d3[k] += dd * d;
+                d4[k] += dd * dd;
+            }
+        }
+
+        for (; i < n; ++i) {
+            T d = x[i] - mean, dd = d * d;
+            d1[0] += d;
+            d2[0] += dd;
+            d3[0] += dd * d;
+            d4[0] += dd * dd;
+        }
+
+        T S1 = (d1[0] + d1[1]) + (d1[2] + d1[3]);
+        T S2 = (d2[0] + d2[1]) + (d2[2] + d2[3]);
+        T S3 = (d3[0] + d3[1]) + (d3[2] + d3[3]);
+        T S4 = (d4[0] + d4[1]) + (d4[2] + d4[3]);
+
+        // move the moments to the corrected mean, mean + e
+        T e(S1 / count), e2(e * e);
+        s.mM1 = mean + e;
+        s.mM2 = S2 - e * S1;
+        s.mM3 = S3 - mT3 * e * S2 + mT2 * count * e2 * e;
+        s.mM4 = S4 - mT4 * e * S3 + mT6 * e2 * S2 - mT3 * count * e2 * e2;
+        return s;
+    }
+
+public:
+
     T min() const {
         return (mN > 0) ? mMin : mNaN;
     }
@@ -103,11 +346,11 @@ public:
     }
 
     T variance() const {
-        return (mN > 1) ? (mM2 / T(mN - 1)) : mNaN;
+        return (mN > 1 && mW > T(1)) ? (mM2 / (mW - T(1))) : mNaN;
     }
 
     T popVariance() const {
-        return (mN > 1) ? (mM2 / T(mN)) : mNaN;
+        return (mN > 1) ? (mM2 / mW) : mNaN;
     }
 
     T stdev() const {
@@ -119,11 +362,11 @@ public:
     }
 
     T skewness() const {
-        return mM3 * std::sqrt(T(mN) / (mM2 * mM2 * mM2));
+        return mM3 * std::sqrt(mW / (mM2 * mM2 * mM2));
     }
 
     T kurtosis() const {
-        return (T(mN) * mM4) / (mM2 * mM2) - mT3;
+        return (mW * mM4) / (mM2 * mM2) - mT3;
     }
 
     template <typename X>
@@ -139,6 +382,7 @@ public:
 
 private:
     N mN;
+    T mW;
     T mMin;
     T mMax;
     T mM1;
@@ -149,7 +393,147 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+//  @note Statistics of the last size() values added.  Once the window is
+//  full each update() takes the oldest value out again with
+//  aeStatisticsT::remove(), so the moments cost O(1) per value whatever the
+//  window size.  The minimum and maximum are kept in monotonic queues of
+//  the values that can still become the window's extreme.  Once per window
+//  the moments are recomputed from the buffer in bulk, which keeps the
+//  rounding error of remove() from building up.
+//
+//  Unlike aeMedianT, NaN and infinite values are counted: the moments are
+//  NaN (or infinite) exactly while such a value is in the window, and are
+//  rebuilt from the buffer when it leaves, since remove() cannot undo it.
+
+template <typename T, typename N=unsigned long long>
+class aeWindowStatisticsT {
+public:
+    explicit aeWindowStatisticsT(std::size_t size): mValues(size) {
+        if (size == 0) {
+            throw aeArgumentError("window size must be positive");
+        }
+        clear();
+    }
+
+    void clear() {
+        mStats.clear();
+        mNext = 0;
+        mIndex = N();
+        mSinceRebuild = 0;
+        mLows.clear();
+        mHighs.clear();
+    }
+
+    std::size_t size() const {
+        return mValues.size();
+    }
+
+    N count() const {
+        return mStats.count();
+    }
+
+    aeWindowStatisticsT<T, N> &update(const T &x) {
+        const std::size_t size = mValues.size();
+        const bool full = mStats.count() == N(size);
+
+        // a NaN or infinity cannot be taken back out of the moments, so
+        // they are rebuilt from the buffer once it leaves the window
+        bool rebuild = false;
+
+        if (full) {
+            const T &oldest = mValues[mNext];
+            if (std::isfinite(oldest)) {
+                mStats.remove(oldest);
+            } else {
+                rebuild = true;
+            }
+        }
+
+        mValues[mNext] = x;
+        mNext = (mNext + 1 == size) ? 0 : mNext + 1;
+
+        if (rebuild) {
+            mStats.clear();
+            mStats.update(mValues.data(), size, 1);
+            mSinceRebuild = 0;
+        } else {
+            mStats.update(x);
+        }
+
+        // NaN values never become the minimum or maximum
+        if (x == x) {
+            while (!mLows.empty() && !(mLows.back().value < x)) {
+                mLows.pop_back();
+            }
+            mLows.push_back(Entry { mIndex, x });
+
+            while (!mHighs.empty() && !(mHighs.back().value > x)) {
+                mHighs.pop_back();
+            }
+            mHighs.push_back(Entry { mIndex, x });
+        }
+
+        ++mIndex;
+
+        if (!mLows.empty() && mIndex - mLows.front().index > N(size)) {
+            mLows.pop_front();
+        }
+
+        if (!mHighs.empty() && mIndex - mHighs.front().index > N(size)) {
+            mHighs.pop_front();
+        }
+
+        if (full && !rebuild && ++mSinceRebuild >= size) {
+            mStats.clear();
+            mStats.update(mValues.data(), size, 1);
+            mSinceRebuild = 0;
+        }
+
+        return *this;
+    }
+
+    template <typename I>
+    void update(const I &i, const I &j) {
+        for (I k(i); k != j; ++k) {
+            update(*k);
+        }
+    }
+
+    T min() const {
+        return mLows.empty() ? T(aeNaN) : mLows.front().value;
+    }
+
+    T max() const {
+        return mHighs.empty() ? T(aeNaN) : mHighs.front().value;
+    }
+
+    T mean() const { return mStats.mean(); }
+    T variance() const { return mStats.variance(); }
+    T popVariance() const { return mStats.popVariance(); }
+    T stdev() const { return mStats.stdev(); }
+    T popStdev() const { return mStats.popStdev(); }
+    T skewness() const { return mStats.skewness(); }
+    T kurtosis() const { return mStats.kurtosis(); }
+
+private:
+    struct Entry {
+        N index;
+        T value;
+    };
+
+    aeStatisticsT<T, N> mStats;
+    std::vector<T> mValues;         // ring buffer of the window
+    std::size_t mNext;              // slot for the next value
+    N mIndex;                       // values added since clear()
+    std::size_t mSinceRebuild;
+    std::deque<Entry> mLows;        // increasing values, oldest first
+    std::deque<Entry> mHighs;       // decreasing values, oldest first
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 typedef aeStatisticsT<double, unsigned long long> aeStatistics;
+typedef aeWindowStatisticsT<double, unsigned long long> aeWindowStatistics;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -8,6 +8,15 @@
 
 #include <physfs.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class aePhysFS {
@@ -127,9 +136,13 @@ int64_t aeMemoryInputStream::read(void *data, int64_t size) {
     if (size > (mSize - mPosition)) {
         size = mSize - mPosition;
     }
-    const uint8_t *tData = static_cast<const uint8_t*>(mData);
+    if (size <= 0) {
+        return 0;
+    }
+    const uint8_t *tData = static_cast<const uint8_t*>(mData) + mPosition;
     std::copy(tData, tData + size, static_cast<uint8_t*>(data));
-    return mPosition += size;
+    mPosition += size;
+    return size;
 }
 
 int64_t aeMemoryInputStream::seek(int64_t position) {
@@ -149,6 +162,118 @@ int64_t aeMemoryInputStream::length() {
     return mSize;
 }
 
+const void *aeMemoryInputStream::map() {
+    return mData;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+aeMappedInputStream::aeMappedInputStream(
+    const std::string &filename
+): mData(), mSize(), mPosition() {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw aeStreamError("error opening file for mapping (\"" + filename + "\")");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw aeStreamError("error reading file size (\"" + filename + "\")");
+    }
+    mSize = size.QuadPart;
+
+    if (mSize > 0) {
+        // the view keeps the mapping open after its handles are closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            mData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw aeStreamError("error opening file for mapping (\"" + filename + "\")");
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw aeStreamError("error reading file size (\"" + filename + "\")");
+    }
+    mSize = info.st_size;
+
+    if (mSize > 0) {
+        // the mapping stays valid after the descriptor is closed
+        void *data = mmap(nullptr, size_t(mSize), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            posix_madvise(data, size_t(mSize), POSIX_MADV_RANDOM);
+            mData = data;
+        }
+    }
+    ::close(fd);
+#endif
+
+    if (mSize > 0 && !mData) {
+        throw aeStreamError("error mapping file (\"" + filename + "\")");
+    }
+}
+
+aeMappedInputStream::~aeMappedInputStream() {
+    close();
+}
+
+void aeMappedInputStream::close() {
+    if (mData) {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+#else
+        munmap(const_cast<void*>(mData), size_t(mSize));
+#endif
+    }
+    mData = nullptr;
+    mSize = 0;
+    mPosition = 0;
+}
+
+int64_t aeMappedInputStream::read(void *data, int64_t size) {
+    if (size > (mSize - mPosition)) {
+        size = mSize - mPosition;
+    }
+    if (size <= 0) {
+        return 0;
+    }
+    const uint8_t *tData = static_cast<const uint8_t*>(mData) + mPosition;
+    std::copy(tData, tData + size, static_cast<uint8_t*>(data));
+    mPosition += size;
+    return size;
+}
+
+int64_t aeMappedInputStream::seek(int64_t position) {
+    if (position < 0) {
+        position = 0;
+    } else if (position > mSize) {
+        position = mSize;
+    }
+    return mPosition = position;
+}
+
+int64_t aeMappedInputStream::tell() {
+    return mPosition;
+}
+
+int64_t aeMappedInputStream::length() {
+    return mSize;
+}
+
+const void *aeMappedInputStream::map() {
+    return mData;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 aeMemoryOutputStream::aeMemoryOutputStream(
@@ -163,9 +288,13 @@ int64_t aeMemoryOutputStream::write(const void *data, int64_t size) {
     if (size > (mSize - mPosition)) {
         size = mSize - mPosition;
     }
+    if (size <= 0) {
+        return 0;
+    }
     const uint8_t *tData = static_cast<const uint8_t*>(data);
-    std::copy(tData, tData + size, static_cast<uint8_t*>(mData));
-    return mPosition += size;
+    std::copy(tData, tData + size, static_cast<uint8_t*>(mData) + mPosition);
+    mPosition += size;
+    return size;
 }
 
 int64_t aeMemoryOutputStream::seek(int64_t position) {
@@ -12,6 +12,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cinttypes>
+#include <string>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -28,7 +29,7 @@ public:
 
     template <typename T>
     void read(T &data) {
-        if (read(&data, sizeof(T)) < sizeof(T)) {
+        if (read(&data, sizeof(T)) < int64_t(sizeof(T))) {
             throw aeStreamError("incomplete read");
         }
     }
@@ -37,6 +38,12 @@ public:
     virtual int64_t seek(int64_t position) = 0;
     virtual int64_t tell() = 0;
     virtual int64_t length() = 0;
+
+    /**
+     * The whole contents of the stream as one block of memory, or null if
+     * the stream is not held in (or mapped into) memory.
+     */
+    virtual const void *map() { return nullptr; }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,7 +57,7 @@ public:
 
     template <typename T>
     void write(const T &data) {
-        if (write(&data, sizeof(T)) < sizeof(T)) {
+        if (write(&data, sizeof(T)) < int64_t(sizeof(T))) {
             throw aeStreamError("incomplete write");
         }
     }
@@ -99,7 +106,7 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class aeMemoryInputStream {
+class aeMemoryInputStream : public aeInputStream {
 public:
     aeMemoryInputStream(const void *data, int64_t size);
     virtual ~aeMemoryInputStream();
@@ -108,8 +115,40 @@ public:
     virtual int64_t seek(int64_t position);
     virtual int64_t tell();
     virtual int64_t length();
+    virtual const void *map();
+
+private:
+    const void *mData;
+    int64_t mSize;
+    int64_t mPosition;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A read-only memory-mapped file, opened by its native path rather
+//  than through the virtual filesystem.  Nothing is read when the file is
+//  opened; the operating system pages the contents in as they are first
+//  touched, so a large file costs only the parts actually used.  Access is
+//  flagged as random, to keep read-ahead from pulling in whole regions
+//  around each touch.
+
+class aeMappedInputStream : public aeInputStream {
+public:
+    aeMappedInputStream(const std::string &filename);
+    virtual ~aeMappedInputStream();
+
+    void close();
+
+    virtual int64_t read(void *data, int64_t size);
+    virtual int64_t seek(int64_t position);
+    virtual int64_t tell();
+    virtual int64_t length();
+    virtual const void *map();
 
 private:
+    aeMappedInputStream(const aeMappedInputStream &) = delete;
+    aeMappedInputStream &operator = (const aeMappedInputStream &) = delete;
+
     const void *mData;
     int64_t mSize;
     int64_t mPosition;
@@ -117,7 +156,7 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class aeMemoryOutputStream {
+class aeMemoryOutputStream : public aeOutputStream {
 public:
     aeMemoryOutputStream(void *data, int64_t size);
     virtual ~aeMemoryOutputStream();
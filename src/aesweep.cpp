@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aesweep.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+template class aeSweepT<double>;
+template class aeSweepT<float>;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AESWEEP_HPP_INCLUDE_GUARD
+#define AESWEEP_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeextent.hpp"
+#include "aepoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Sweep-and-prune over the bounding boxes of a set of segments: boxes
+//  are visited in order of increasing x, and each is paired with the active
+//  boxes whose x and y intervals overlap it.  This is the candidate search
+//  shared by intersection detection and polygon overlay.
+
+template <typename T>
+class aeSweepT {
+public:
+    aeSweepT() {}
+
+    void clear() {
+        mBoxes.clear();
+    }
+
+    void reserve(unsigned int n) {
+        mBoxes.reserve(n);
+    }
+
+    unsigned int size() const {
+        return mBoxes.size();
+    }
+
+    /**
+     * Adds the bounding box of a segment, returning its id.
+     */
+    unsigned int insert(const aePointT<T> &a, const aePointT<T> &b) {
+        mBoxes.push_back(aeExtent2T<T>(a, b));
+        return mBoxes.size() - 1;
+    }
+
+    /**
+     * Calls f(i, j) for each pair of ids whose boxes overlap, where box i
+     * starts no later than box j.  Stops early, returning true, as soon as f
+     * returns true.
+     */
+    template <typename F>
+    bool run(F f) {
+        unsigned int n = mBoxes.size();
+
+        mOrder.resize(n);
+        for (unsigned int i = 0; i < n; ++i) {
+            mOrder[i] = i;
+        }
+
+        const std::vector< aeExtent2T<T> > &boxes = mBoxes;
+        std::sort(mOrder.begin(), mOrder.end(),
+            [&boxes](unsigned int i, unsigned int j) {
+                return (boxes[i].xmin == boxes[j].xmin) ? (i < j) :
+                       (boxes[i].xmin < boxes[j].xmin);
+            }
+        );
+
+        mActive.clear();
+
+        for (unsigned int j : mOrder) {
+            const aeExtent2T<T> &bj = mBoxes[j];
+            unsigned int kept = 0;
+
+            for (unsigned int i : mActive) {
+                const aeExtent2T<T> &bi = mBoxes[i];
+
+                if (bi.xmax < bj.xmin) {
+                    continue; // retired
+                }
+
+                mActive[kept++] = i;
+
+                if (bi.intersects(bj) && f(i, j)) {
+                    return true;
+                }
+            }
+
+            mActive.resize(kept);
+            mActive.push_back(j);
+        }
+
+        return false;
+    }
+
+private:
+    std::vector< aeExtent2T<T> > mBoxes;
+    std::vector<unsigned int> mOrder;
+    std::vector<unsigned int> mActive;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aeSweepT<double> aeSweep;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AESWEEP_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,600 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aetess.hpp"
+#include "aeexcept.hpp"
+#include "aepred.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+//! @see de Berg et al., "Computational Geometry: Algorithms and Applications",
+//! chapter 3 (polygon triangulation)
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    static const uint32_t None = std::numeric_limits<uint32_t>::max();
+
+    enum VertexKind {
+        Start,
+        End,
+        Split,
+        Merge,
+        Regular
+    };
+
+    template <typename T>
+    struct Sweep {
+        const std::vector< aePointT<T> > &points;
+        const std::vector<uint32_t> &point;
+        const std::vector<uint32_t> &next;
+
+        Sweep(
+            const std::vector< aePointT<T> > &points,
+            const std::vector<uint32_t> &point,
+            const std::vector<uint32_t> &next
+        ): points(points), point(point), next(next) {
+        }
+
+        const aePointT<T> &at(uint32_t v) const {
+            return points[point[v]];
+        }
+
+        // Sweep order: top to bottom, then left to right
+        bool above(uint32_t a, uint32_t b) const {
+            const aePointT<T> &p = at(a), &q = at(b);
+            if (p.y != q.y) { return p.y > q.y; }
+            if (p.x != q.x) { return p.x < q.x; }
+            return a < b;
+        }
+
+        uint32_t upper(uint32_t e) const {
+            return above(e, next[e]) ? e : next[e];
+        }
+
+        uint32_t lower(uint32_t e) const {
+            return above(e, next[e]) ? next[e] : e;
+        }
+
+        // Positive if vertex v lies left of edge e
+        double side(uint32_t e, uint32_t v) const {
+            return aeOrient2d(at(lower(e)), at(upper(e)), at(v));
+        }
+    };
+
+    // Orders the edges crossing the sweep line from left to right; the edge
+    // id None stands for the vertex currently being located.
+    template <typename T>
+    struct EdgeLess {
+        const Sweep<T> *sweep;
+        const uint32_t *probe;
+
+        EdgeLess(const Sweep<T> *sweep, const uint32_t *probe): sweep(sweep), probe(probe) {}
+
+        bool operator () (uint32_t e, uint32_t f) const {
+            if (e == f) {
+                return false;
+            }
+            if (e == None) {
+                return sweep->side(f, *probe) > 0.0;
+            }
+            if (f == None) {
+                return sweep->side(e, *probe) <= 0.0;
+            }
+
+            uint32_t eu = sweep->upper(e), fu = sweep->upper(f);
+
+            if (sweep->above(fu, eu)) {
+                double s = sweep->side(f, eu);
+                if (s == 0.0) {
+                    s = sweep->side(f, sweep->lower(e));
+                }
+                return s > 0.0;
+            } else {
+                double s = sweep->side(e, fu);
+                if (s == 0.0) {
+                    s = sweep->side(e, sweep->lower(f));
+                }
+                return s < 0.0;
+            }
+        }
+    };
+
+    template <typename T>
+    bool insideRing(
+        const Sweep<T> &sweep,
+        uint32_t begin,
+        uint32_t end,
+        const aePointT<T> &p
+    ) {
+        int winding = 0;
+        for (uint32_t i = begin, j = end - 1; i < end; j = i++) {
+            const aePointT<T> &a = sweep.at(j), &b = sweep.at(i);
+            if (a.y <= p.y) {
+                if (b.y > p.y && aeOrient2d(a, b, p) > 0.0) {
+                    ++winding;
+                }
+            } else {
+                if (b.y <= p.y && aeOrient2d(a, b, p) < 0.0) {
+                    --winding;
+                }
+            }
+        }
+        return winding != 0;
+    }
+
+    // Extent of one ring, for skipping rings that cannot contain a point
+    template <typename T>
+    struct RingBox {
+        T x0, y0, x1, y1;
+        unsigned int ring;
+
+        bool operator < (const RingBox &rhs) const {
+            return x0 < rhs.x0;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+void aeTessellatorT<T>::triangulate(
+    const aeGeometryT<T> &polygon,
+    Indices &triangles
+) {
+    typedef typename aeGeometryT<T>::Type Type;
+
+    Type base = polygon.baseType();
+
+    if (base != aeGeometryT<T>::Polygon &&
+        base != aeGeometryT<T>::MultiPolygon &&
+        base != aeGeometryT<T>::Triangle) {
+        throw aeArgumentError("aeTessellator::triangulate: not a polygon");
+    }
+
+    const std::vector< aePointT<T> > &points = polygon.points();
+    Sweep<T> sweep(points, mPoint, mNext);
+
+    // Collect rings, dropping repeated points and closing points
+
+    std::vector<uint32_t> rings;
+
+    mPoint.clear();
+
+    for (unsigned int i = 0, n = polygon.partCount(); i < n; ++i) {
+        unsigned int begin = polygon.partBegin(i), end = polygon.partEnd(i);
+        uint32_t first = mPoint.size();
+
+        for (unsigned int k = begin; k < end; ++k) {
+            const aePointT<T> &p = points[k];
+            if (mPoint.size() > first) {
+                const aePointT<T> &q = points[mPoint.back()];
+                if (p.x == q.x && p.y == q.y) {
+                    continue;
+                }
+            }
+            mPoint.push_back(k);
+        }
+
+        while (mPoint.size() > first + 1) {
+            const aePointT<T> &p = points[mPoint[first]];
+            const aePointT<T> &q = points[mPoint.back()];
+            if (p.x != q.x || p.y != q.y) {
+                break;
+            }
+            mPoint.pop_back();
+        }
+
+        if (mPoint.size() < first + 3) {
+            mPoint.resize(first);
+        } else {
+            rings.push_back(first);
+        }
+    }
+
+    rings.push_back(mPoint.size());
+
+    // A multipolygon ring is a hole if it lies inside an odd number of other
+    // rings; only rings whose extents contain its first vertex are tested,
+    // found by scanning the extents in order of their left edges
+
+    std::vector< RingBox<T> > boxes;
+
+    if (base == aeGeometryT<T>::MultiPolygon) {
+        boxes.resize(rings.size() - 1);
+        for (unsigned int r = 0; r + 1 < rings.size(); ++r) {
+            RingBox<T> &box = boxes[r];
+            box.x0 = box.x1 = sweep.at(rings[r]).x;
+            box.y0 = box.y1 = sweep.at(rings[r]).y;
+            box.ring = r;
+            for (uint32_t i = rings[r] + 1; i < rings[r + 1]; ++i) {
+                const aePointT<T> &p = sweep.at(i);
+                box.x0 = std::min(box.x0, p.x);
+                box.x1 = std::max(box.x1, p.x);
+                box.y0 = std::min(box.y0, p.y);
+                box.y1 = std::max(box.y1, p.y);
+            }
+        }
+        std::sort(boxes.begin(), boxes.end());
+    }
+
+    // Orient shells counterclockwise and holes clockwise, so the interior
+    // always lies to the left of each edge
+
+    for (unsigned int r = 0; r + 1 < rings.size(); ++r) {
+        uint32_t begin = rings[r], end = rings[r + 1];
+
+        bool hole = false;
+
+        if (base == aeGeometryT<T>::MultiPolygon) {
+            const aePointT<T> &p = points[mPoint[begin]];
+            for (const RingBox<T> &box : boxes) {
+                if (box.x0 > p.x) {
+                    break;
+                }
+                unsigned int s = box.ring;
+                if (s != r && box.x1 >= p.x && box.y0 <= p.y && box.y1 >= p.y &&
+                    insideRing(sweep, rings[s], rings[s + 1], p)) {
+                    hole = !hole;
+                }
+            }
+        } else {
+            hole = (r > 0);
+        }
+
+        double area = 0.0;
+        for (uint32_t i = begin, j = end - 1; i < end; j = i++) {
+            const aePointT<T> &a = points[mPoint[j]], &b = points[mPoint[i]];
+            area += (double(a.x) - double(b.x)) * (double(a.y) + double(b.y));
+        }
+
+        if ((area < 0.0) != hole) {
+            std::reverse(mPoint.begin() + begin, mPoint.begin() + end);
+        }
+    }
+
+    uint32_t count = mPoint.size();
+
+    mPrev.resize(count);
+    mNext.resize(count);
+
+    for (unsigned int r = 0; r + 1 < rings.size(); ++r) {
+        uint32_t begin = rings[r], end = rings[r + 1];
+        for (uint32_t i = begin; i < end; ++i) {
+            mPrev[i] = (i == begin) ? end - 1 : i - 1;
+            mNext[i] = (i + 1 == end) ? begin : i + 1;
+        }
+    }
+
+    // Classify vertices and sweep them from top to bottom, adding diagonals
+    // that split the polygon into y-monotone pieces
+
+    mKind.resize(count);
+
+    for (uint32_t v = 0; v < count; ++v) {
+        uint32_t u = mPrev[v], w = mNext[v];
+        bool uBelow = sweep.above(v, u), wBelow = sweep.above(v, w);
+        bool convex = aeOrient2d(sweep.at(u), sweep.at(v), sweep.at(w)) > 0.0;
+
+        if (uBelow && wBelow) {
+            mKind[v] = convex ? Start : Split;
+        } else if (!uBelow && !wBelow) {
+            mKind[v] = convex ? End : Merge;
+        } else {
+            mKind[v] = Regular;
+        }
+    }
+
+    mOrder.resize(count);
+    for (uint32_t v = 0; v < count; ++v) {
+        mOrder[v] = v;
+    }
+    std::sort(mOrder.begin(), mOrder.end(),
+        [&sweep](uint32_t a, uint32_t b) {
+            return sweep.above(a, b);
+        }
+    );
+
+    typedef std::multiset< uint32_t, EdgeLess<T> > Status;
+
+    uint32_t probe = None;
+    Status status(EdgeLess<T>(&sweep, &probe));
+    std::vector<typename Status::iterator> where(count, status.end());
+
+    mHelper.assign(count, None);
+    mDiagonals.clear();
+
+    auto insert = [&](uint32_t e, uint32_t helper) {
+        where[e] = status.insert(e);
+        mHelper[e] = helper;
+    };
+
+    auto retire = [&](uint32_t e, uint32_t v) {
+        if (where[e] != status.end()) {
+            if (mHelper[e] != None && mKind[mHelper[e]] == Merge) {
+                mDiagonals.push_back(v);
+                mDiagonals.push_back(mHelper[e]);
+            }
+            status.erase(where[e]);
+            where[e] = status.end();
+        }
+    };
+
+    auto leftOf = [&](uint32_t v) -> uint32_t {
+        probe = v;
+        typename Status::iterator i = status.lower_bound(None);
+        return (i == status.begin()) ? None : *--i;
+    };
+
+    for (uint32_t v : mOrder) {
+        switch (mKind[v]) {
+            case Start: {
+                insert(v, v);
+                break;
+            }
+
+            case End: {
+                retire(mPrev[v], v);
+                break;
+            }
+
+            case Split: {
+                uint32_t e = leftOf(v);
+                if (e != None) {
+                    mDiagonals.push_back(v);
+                    mDiagonals.push_back(mHelper[e]);
+                    mHelper[e] = v;
+                }
+                insert(v, v);
+                break;
+            }
+
+            case Merge: {
+                retire(mPrev[v], v);
+                uint32_t e = leftOf(v);
+                if (e != None) {
+                    if (mKind[mHelper[e]] == Merge) {
+                        mDiagonals.push_back(v);
+                        mDiagonals.push_back(mHelper[e]);
+                    }
+                    mHelper[e] = v;
+                }
+                break;
+            }
+
+            case Regular: {
+                if (sweep.above(mPrev[v], v)) {
+                    // interior lies to the right of v
+                    retire(mPrev[v], v);
+                    insert(v, v);
+                } else {
+                    uint32_t e = leftOf(v);
+                    if (e != None) {
+                        if (mKind[mHelper[e]] == Merge) {
+                            mDiagonals.push_back(v);
+                            mDiagonals.push_back(mHelper[e]);
+                        }
+                        mHelper[e] = v;
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    // Build outgoing edge lists: each vertex's ring successor, followed by
+    // the diagonals (in both directions)
+
+    mOffsets.assign(count + 1, 0);
+    for (uint32_t v = 0; v < count; ++v) {
+        ++mOffsets[v + 1];
+    }
+    for (uint32_t d : mDiagonals) {
+        ++mOffsets[d + 1];
+    }
+    for (uint32_t v = 0; v < count; ++v) {
+        mOffsets[v + 1] += mOffsets[v];
+    }
+
+    mTargets.resize(mOffsets[count]);
+    mOrder.assign(mOffsets.begin(), mOffsets.end() - 1);
+
+    for (uint32_t v = 0; v < count; ++v) {
+        mTargets[mOrder[v]++] = mNext[v];
+    }
+    for (std::size_t i = 0; i < mDiagonals.size(); i += 2) {
+        uint32_t a = mDiagonals[i], b = mDiagonals[i + 1];
+        mTargets[mOrder[a]++] = b;
+        mTargets[mOrder[b]++] = a;
+    }
+
+    // Trace each face, turning as far left as possible at each vertex, then
+    // triangulate the resulting monotone polygon
+
+    auto cwHalf = [&sweep](uint32_t b, uint32_t a, uint32_t c) -> int {
+        double o = aeOrient2d(sweep.at(b), sweep.at(a), sweep.at(c));
+        if (o < 0.0) {
+            return 0;
+        } else if (o > 0.0) {
+            return 1;
+        } else {
+            const aePointT<T> &pb = sweep.at(b), &pa = sweep.at(a), &pc = sweep.at(c);
+            double dot = (double(pa.x) - double(pb.x)) * (double(pc.x) - double(pb.x)) +
+                         (double(pa.y) - double(pb.y)) * (double(pc.y) - double(pb.y));
+            return (dot < 0.0) ? 1 : 2;
+        }
+    };
+
+    // Clockwise angle from (a - b) to (c - b) is less than to (d - b)
+    auto cwLess = [&](uint32_t b, uint32_t a, uint32_t c, uint32_t d) -> bool {
+        int hc = cwHalf(b, a, c), hd = cwHalf(b, a, d);
+        if (hc != hd) {
+            return hc < hd;
+        }
+        return aeOrient2d(sweep.at(b), sweep.at(c), sweep.at(d)) < 0.0;
+    };
+
+    auto emit = [&](uint32_t a, uint32_t b, uint32_t c) {
+        double o = aeOrient2d(sweep.at(a), sweep.at(b), sweep.at(c));
+        if (o > 0.0) {
+            triangles.push_back(mPoint[a]);
+            triangles.push_back(mPoint[b]);
+            triangles.push_back(mPoint[c]);
+        } else if (o < 0.0) {
+            triangles.push_back(mPoint[a]);
+            triangles.push_back(mPoint[c]);
+            triangles.push_back(mPoint[b]);
+        }
+    };
+
+    mUsed.assign(mTargets.size(), false);
+    mLeft.assign(count, false);
+
+    for (uint32_t v = 0; v < count; ++v) {
+        for (uint32_t s = mOffsets[v]; s < mOffsets[v + 1]; ++s) {
+            if (mUsed[s]) {
+                continue;
+            }
+
+            mFace.clear();
+
+            uint32_t a = v, slot = s;
+
+            do {
+                mUsed[slot] = true;
+                mFace.push_back(a);
+
+                uint32_t b = mTargets[slot], best = None;
+                uint32_t first = mOffsets[b], last = mOffsets[b + 1];
+
+                for (uint32_t t = first; t < last; ++t) {
+                    if (mTargets[t] == a && last - first > 1) {
+                        continue;
+                    }
+                    if (best == None || cwLess(b, a, mTargets[t], mTargets[best])) {
+                        best = t;
+                    }
+                }
+
+                a = b;
+                slot = best;
+            } while (slot != s && !mUsed[slot]);
+
+            uint32_t k = mFace.size();
+
+            if (k < 3) {
+                continue;
+            }
+
+            if (k == 3) {
+                emit(mFace[0], mFace[1], mFace[2]);
+                continue;
+            }
+
+            // Split the face into its left and right chains, and merge
+            // them into sweep order
+
+            uint32_t top = 0, bottom = 0;
+            for (uint32_t i = 1; i < k; ++i) {
+                if (sweep.above(mFace[i], mFace[top])) { top = i; }
+                if (sweep.above(mFace[bottom], mFace[i])) { bottom = i; }
+            }
+
+            mSorted.clear();
+            mSorted.push_back(mFace[top]);
+
+            uint32_t i = (top + 1) % k, j = (top + k - 1) % k;
+
+            while (i != bottom || j != bottom) {
+                if (j == bottom || (i != bottom && sweep.above(mFace[i], mFace[j]))) {
+                    mLeft[mFace[i]] = true;
+                    mSorted.push_back(mFace[i]);
+                    i = (i + 1) % k;
+                } else {
+                    mLeft[mFace[j]] = false;
+                    mSorted.push_back(mFace[j]);
+                    j = (j + k - 1) % k;
+                }
+            }
+
+            mSorted.push_back(mFace[bottom]);
+
+            mStack.clear();
+            mStack.push_back(mSorted[0]);
+            mStack.push_back(mSorted[1]);
+
+            for (uint32_t n = 2; n + 1 < k; ++n) {
+                uint32_t u = mSorted[n];
+
+                if (mLeft[u] != mLeft[mStack.back()]) {
+                    while (mStack.size() > 1) {
+                        uint32_t x = mStack.back();
+                        mStack.pop_back();
+                        emit(u, x, mStack.back());
+                    }
+                    mStack.clear();
+                    mStack.push_back(mSorted[n - 1]);
+                    mStack.push_back(u);
+                } else {
+                    uint32_t x = mStack.back();
+                    mStack.pop_back();
+
+                    while (!mStack.empty()) {
+                        double o = aeOrient2d(sweep.at(mStack.back()), sweep.at(x), sweep.at(u));
+                        if (mLeft[u] ? (o <= 0.0) : (o >= 0.0)) {
+                            break;
+                        }
+                        emit(u, x, mStack.back());
+                        x = mStack.back();
+                        mStack.pop_back();
+                    }
+
+                    mStack.push_back(x);
+                    mStack.push_back(u);
+                }
+            }
+
+            uint32_t u = mSorted[k - 1];
+            while (mStack.size() > 1) {
+                uint32_t x = mStack.back();
+                mStack.pop_back();
+                emit(u, x, mStack.back());
+            }
+        }
+    }
+}
+
+template <typename T>
+aeGeometryT<T> aeTessellatorT<T>::tessellate(const aeGeometryT<T> &polygon) {
+    typedef typename aeGeometryT<T>::Type Type;
+
+    Indices triangles;
+    triangulate(polygon, triangles);
+
+    Type dims = Type(polygon.type() & (aeGeometryT<T>::HasZ | aeGeometryT<T>::HasM));
+    aeGeometryT<T> tin(Type(aeGeometryT<T>::TIN | dims));
+
+    tin.points().reserve(triangles.size());
+    tin.parts().reserve(triangles.size() / 3);
+
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+        if (i % 3 == 0) {
+            tin.parts().push_back(i);
+        }
+        tin.points().push_back(polygon.points()[triangles[i]]);
+    }
+
+    return tin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template class aeTessellatorT<double>;
+template class aeTessellatorT<float>;
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AETESS_HPP_INCLUDE_GUARD
+#define AETESS_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aegeom.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Triangulates polygons (with holes) in O(n log n) time by sweeping the
+//  polygon into y-monotone pieces, then triangulating each piece in linear
+//  time.  Triangles are written as triples of indices into the source
+//  geometry's points, in counterclockwise order.  The tessellator keeps its
+//  working buffers between calls, so reusing one instance for many polygons
+//  avoids reallocation.
+//
+//  The rings of a MultiPolygon are told apart as shells or holes by testing
+//  each against the other rings whose extents contain it.  That is cheap for
+//  typical inputs, but many rings with overlapping extents (deeply nested
+//  rings, say) make this step O(R^2 n) for R rings.
+
+template <typename T>
+class aeTessellatorT {
+public:
+    typedef std::vector<uint32_t> Indices;
+
+public:
+    aeTessellatorT() {}
+
+    /**
+     * Appends the triangles covering the given polygon to an index buffer.
+     */
+    void triangulate(const aeGeometryT<T> &polygon, Indices &triangles);
+
+    /**
+     * Returns a TIN geometry with one triangle per part.
+     */
+    aeGeometryT<T> tessellate(const aeGeometryT<T> &polygon);
+
+private:
+    std::vector<uint32_t> mPoint;
+    std::vector<uint32_t> mPrev;
+    std::vector<uint32_t> mNext;
+    std::vector<uint8_t> mKind;
+    std::vector<uint32_t> mOrder;
+    std::vector<uint32_t> mHelper;
+    std::vector<uint32_t> mDiagonals;
+    std::vector<uint32_t> mOffsets;
+    std::vector<uint32_t> mTargets;
+    std::vector<bool> mUsed;
+    std::vector<uint32_t> mFace;
+    std::vector<uint32_t> mSorted;
+    std::vector<uint32_t> mStack;
+    std::vector<bool> mLeft;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef aeTessellatorT<double> aeTessellator;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AETESS_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
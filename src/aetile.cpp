@@ -0,0 +1,422 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aetile.hpp"
+#include "aeconst.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+static constexpr double degsToRads = aePi / 180.0;
+static constexpr double radsToDegs = 180.0 / aePi;
+static constexpr double mercatorMaxLatitude = 85.051128779806589;
+static constexpr double mercatorRadius = 6378137.0;
+
+static const std::size_t blockSize = 256;
+
+/*
+ * Maps WGS 84 degrees to fractional tile coordinates at one zoom level,
+ * clamped to the square; a NaN coordinate maps to zero.
+ */
+struct TileSpace {
+    double mScale;      // tiles across the square
+    double mLast;       // index of the last tile
+    double mKx;
+    double mKy;
+    double mMaxSin;
+
+    TileSpace(uint32_t zoom) {
+        if (zoom > aeTile::maxZoom) {
+            throw aeArgumentError("aeTile: zoom level out of range");
+        }
+        mScale = std::ldexp(1.0, zoom);
+        mLast = mScale - 1.0;
+        mKx = mScale / 360.0;
+        mKy = mScale / (4.0 * aePi);
+        mMaxSin = std::sin(degsToRads * mercatorMaxLatitude);
+    }
+
+    double clamp(double f) const {
+        f = (f > 0.0) ? f : 0.0;
+        return (f < mScale) ? f : mScale;
+    }
+
+    void operator()(double lon, double lat, double &fx, double &fy) const {
+        double s = std::sin(degsToRads * lat);
+        s = (s < mMaxSin) ? s : mMaxSin;
+        s = (s > -mMaxSin) ? s : -mMaxSin;
+        fx = clamp((lon + 180.0) * mKx);
+        fy = clamp(0.5 * mScale - mKy * std::log((1.0 + s) / (1.0 - s)));
+    }
+
+    uint32_t index(double f) const {
+        return uint32_t((f < mLast) ? f : mLast);
+    }
+};
+
+struct Edge {
+    double x0, y0, x1, y1;
+};
+
+/*
+ * Collects Morton codes of the tiles touched by points, segments and
+ * polygon interiors in tile coordinates.
+ */
+class Cover {
+public:
+    Cover(const TileSpace &space): mSpace(space) {}
+
+    void add(uint32_t x, uint32_t y) {
+        mCodes.push_back(aeMortonEncode(x, y));
+    }
+
+    /*
+     * Steps through the tiles crossed by a segment, one tile boundary at a
+     * time (Amanatides and Woo).  The step count is fixed by the end tiles,
+     * so rounding can never run the walk past them.
+     */
+    void walk(double x0, double y0, double x1, double y1) {
+        int64_t ix = mSpace.index(x0), iy = mSpace.index(y0);
+        int64_t ex = mSpace.index(x1), ey = mSpace.index(y1);
+        int64_t sx = (ex > ix) ? 1 : -1, sy = (ey > iy) ? 1 : -1;
+
+        const double inf = std::numeric_limits<double>::infinity();
+        double dx = x1 - x0, dy = y1 - y0;
+        double tx = (dx != 0.0) ? (double((sx > 0) ? ix + 1 : ix) - x0) / dx : inf;
+        double ty = (dy != 0.0) ? (double((sy > 0) ? iy + 1 : iy) - y0) / dy : inf;
+        double ux = (dx != 0.0) ? std::fabs(1.0 / dx) : inf;
+        double uy = (dy != 0.0) ? std::fabs(1.0 / dy) : inf;
+
+        add(uint32_t(ix), uint32_t(iy));
+
+        for (int64_t n = std::abs(ex - ix) + std::abs(ey - iy); n > 0; --n) {
+            if (iy == ey || (ix != ex && tx < ty)) {
+                ix += sx;
+                tx += ux;
+            } else {
+                iy += sy;
+                ty += uy;
+            }
+            add(uint32_t(ix), uint32_t(iy));
+        }
+    }
+
+    /*
+     * Adds the tiles whose centres are inside the edges by the even-odd
+     * rule, scanning each row of tiles between the first and last.
+     */
+    void fill(const std::vector<Edge> &edges, uint32_t first, uint32_t last) {
+        std::vector<double> xs;
+
+        for (uint32_t row = first; row <= last; ++row) {
+            double yc = row + 0.5;
+            xs.clear();
+            for (const Edge &e : edges) {
+                if ((e.y0 <= yc) != (e.y1 <= yc)) {
+                    xs.push_back(e.x0 + (yc - e.y0) * (e.x1 - e.x0) / (e.y1 - e.y0));
+                }
+            }
+            std::sort(xs.begin(), xs.end());
+
+            for (std::size_t i = 0; i + 1 < xs.size(); i += 2) {
+                double c0 = std::max(std::ceil(xs[i] - 0.5), 0.0);
+                double c1 = std::min(std::floor(xs[i + 1] - 0.5), mSpace.mLast);
+                for (double c = c0; c <= c1; c += 1.0) {
+                    add(uint32_t(c), row);
+                }
+            }
+        }
+    }
+
+    std::vector<aeTile> tiles(uint32_t zoom) {
+        std::sort(mCodes.begin(), mCodes.end());
+        mCodes.erase(std::unique(mCodes.begin(), mCodes.end()), mCodes.end());
+
+        std::vector<aeTile> result;
+        result.reserve(mCodes.size());
+        for (uint64_t code : mCodes) {
+            result.push_back(aeTile::fromMorton(code, zoom));
+        }
+        return result;
+    }
+
+private:
+    const TileSpace &mSpace;
+    std::vector<uint64_t> mCodes;
+};
+
+bool isAreal(int type) {
+    switch (type) {
+        case aeGeometry::Polygon:
+        case aeGeometry::MultiPolygon:
+        case aeGeometry::CurvePolygon:
+        case aeGeometry::MultiSurface:
+        case aeGeometry::Surface:
+        case aeGeometry::PolyhedralSurface:
+        case aeGeometry::TIN:
+        case aeGeometry::Triangle:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isPuntal(int type) {
+    return type == aeGeometry::Point || type == aeGeometry::MultiPoint;
+}
+
+/*
+ * Runs a batch in blocks: tile indices first, into small buffers, then the
+ * bit interleaving as a separate loop of pure integer operations.
+ */
+template <typename Load>
+void tileIDs(const Load &load, std::size_t count, uint32_t zoom, uint64_t *ids) {
+    const TileSpace space(zoom);
+    uint32_t xs[blockSize], ys[blockSize];
+
+    for (std::size_t base = 0; base < count; base += blockSize) {
+        std::size_t n = std::min(blockSize, count - base);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            double fx, fy;
+            space(load.lon(base + i), load.lat(base + i), fx, fy);
+            xs[i] = space.index(fx);
+            ys[i] = space.index(fy);
+        }
+
+        uint64_t *out = ids + base;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = aeMortonEncode(xs[i], ys[i]);
+        }
+    }
+}
+
+template <typename T>
+struct LoadPoints {
+    const aePointT<T> *points;
+    double lon(std::size_t i) const { return points[i].x; }
+    double lat(std::size_t i) const { return points[i].y; }
+};
+
+template <typename T>
+struct LoadArrays {
+    const T *xs;
+    const T *ys;
+    double lon(std::size_t i) const { return xs[i]; }
+    double lat(std::size_t i) const { return ys[i]; }
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t aeTile::maxZoom;
+
+aeTile aeTile::at(double lon, double lat, uint32_t zoom) {
+    const TileSpace space(zoom);
+    double fx, fy;
+    space(lon, lat, fx, fy);
+    return aeTile(space.index(fx), space.index(fy), zoom);
+}
+
+aeTile aeTile::fromQuadkey(const std::string &quadkey) {
+    if (quadkey.size() > maxZoom) {
+        throw aeArgumentError("aeTile: quadkey too long");
+    }
+
+    uint64_t code = 0;
+    for (char c : quadkey) {
+        if (c < '0' || c > '3') {
+            throw aeArgumentError("aeTile: invalid quadkey");
+        }
+        code = (code << 2) | uint64_t(c - '0');
+    }
+    return fromMorton(code, quadkey.size());
+}
+
+std::string aeTile::quadkey() const {
+    std::string result(zoom, '0');
+    uint64_t code = morton();
+    for (uint32_t i = zoom; i > 0; --i) {
+        result[i - 1] = char('0' + (code & 3));
+        code >>= 2;
+    }
+    return result;
+}
+
+aeExtent aeTile::extent(aeWKID wkid) const {
+    // bounds in pixels of the zoom level 0 tile
+    double size = std::ldexp(256.0, -int(zoom));
+    double x0 = x * size, x1 = x0 + size;
+    double y0 = y * size, y1 = y0 + size;
+
+    switch (wkid) {
+        case aeWKID::WebMercatorPixels:
+            return aeExtent(aePoint(x0, y0), aePoint(x1, y1));
+
+        case aeWKID::WebMercator: {
+            double k = 2.0 * aePi * mercatorRadius / 256.0;
+            return aeExtent(aePoint((x0 - 128.0) * k, (128.0 - y1) * k),
+                            aePoint((x1 - 128.0) * k, (128.0 - y0) * k));
+        }
+
+        case aeWKID::WGS84:
+        case aeWKID::NullTransform: {
+            double k = aePi / 128.0;
+            return aeExtent(
+                aePoint(x0 * 360.0 / 256.0 - 180.0,
+                        radsToDegs * std::atan(std::sinh(aePi - y1 * k))),
+                aePoint(x1 * 360.0 / 256.0 - 180.0,
+                        radsToDegs * std::atan(std::sinh(aePi - y0 * k))));
+        }
+
+        default:
+            throw aeArgumentError("aeTile: unsupported coordinate system");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+std::vector<aeTile> aeTileCover(const aeExtentT<T> &extent, uint32_t zoom) {
+    const TileSpace space(zoom);
+    Cover cover(space);
+
+    if (std::isnan(double(extent.min.x)) || std::isnan(double(extent.min.y)) ||
+        std::isnan(double(extent.max.x)) || std::isnan(double(extent.max.y)) ||
+        extent.min.x > extent.max.x || extent.min.y > extent.max.y) {
+        return cover.tiles(zoom);
+    }
+
+    // y runs down, so the north-west corner has the smallest indices
+    double fx0, fy0, fx1, fy1;
+    space(extent.min.x, extent.max.y, fx0, fy0);
+    space(extent.max.x, extent.min.y, fx1, fy1);
+
+    for (uint32_t ty = space.index(fy0), ly = space.index(fy1); ty <= ly; ++ty) {
+        for (uint32_t tx = space.index(fx0), lx = space.index(fx1); tx <= lx; ++tx) {
+            cover.add(tx, ty);
+        }
+    }
+    return cover.tiles(zoom);
+}
+
+template <typename T>
+std::vector<aeTile> aeTileCover(const aeGeometryT<T> &geometry, uint32_t zoom) {
+    const TileSpace space(zoom);
+    Cover cover(space);
+
+    // a quarter of a pixel at the equator
+    std::shared_ptr<const aeGeometryT<T> > linear =
+        geometry.linearize(90.0 / (256.0 * space.mScale));
+    const aeGeometryT<T> &g = *linear;
+
+    const typename aeGeometryT<T>::Points &points = g.points();
+    const int type = g.baseType();
+    const bool areal = isAreal(type);
+
+    if (isPuntal(type)) {
+        for (const aePointT<T> &p : points) {
+            double fx, fy;
+            space(p.x, p.y, fx, fy);
+            cover.add(space.index(fx), space.index(fy));
+        }
+        return cover.tiles(zoom);
+    }
+
+    std::vector<Edge> edges;
+    double minY = space.mScale, maxY = 0.0;
+
+    for (unsigned int i = 0, n = g.partCount(); i < n; ++i) {
+        unsigned int begin = g.partBegin(i), end = g.partEnd(i);
+        if (begin >= end) {
+            continue;
+        }
+
+        double fx0, fy0, fx, fy;
+        space(points[begin].x, points[begin].y, fx0, fy0);
+        Edge e = { fx0, fy0, fx0, fy0 };
+
+        // a lone point still touches its tile
+        cover.add(space.index(fx0), space.index(fy0));
+
+        for (unsigned int j = begin + 1; j <= end; ++j) {
+            if (j == end) {
+                if (!areal) {
+                    break;
+                }
+                fx = fx0;
+                fy = fy0;
+            } else {
+                space(points[j].x, points[j].y, fx, fy);
+            }
+
+            e.x0 = e.x1;
+            e.y0 = e.y1;
+            e.x1 = fx;
+            e.y1 = fy;
+            cover.walk(e.x0, e.y0, e.x1, e.y1);
+
+            if (areal) {
+                edges.push_back(e);
+                minY = std::min(minY, fy);
+                maxY = std::max(maxY, fy);
+            }
+        }
+    }
+
+    if (!edges.empty() && minY <= maxY) {
+        cover.fill(edges, space.index(minY), space.index(maxY));
+    }
+    return cover.tiles(zoom);
+}
+
+template <typename T>
+void aeTileIDs(
+    const aePointT<T> *points,
+    std::size_t count,
+    uint32_t zoom,
+    uint64_t *ids
+) {
+    LoadPoints<T> load = { points };
+    tileIDs(load, count, zoom, ids);
+}
+
+template <typename T>
+void aeTileIDs(
+    const T *lon,
+    const T *lat,
+    std::size_t count,
+    uint32_t zoom,
+    uint64_t *ids
+) {
+    LoadArrays<T> load = { lon, lat };
+    tileIDs(load, count, zoom, ids);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template std::vector<aeTile> aeTileCover(const aeExtentT<double> &, uint32_t);
+template std::vector<aeTile> aeTileCover(const aeExtentT<float> &, uint32_t);
+
+template std::vector<aeTile> aeTileCover(const aeGeometryT<double> &, uint32_t);
+template std::vector<aeTile> aeTileCover(const aeGeometryT<float> &, uint32_t);
+
+template void aeTileIDs(const aePointT<double> *, std::size_t, uint32_t, uint64_t *);
+template void aeTileIDs(const aePointT<float> *, std::size_t, uint32_t, uint64_t *);
+
+template void aeTileIDs(const double *, const double *, std::size_t, uint32_t, uint64_t *);
+template void aeTileIDs(const float *, const float *, std::size_t, uint32_t, uint64_t *);
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
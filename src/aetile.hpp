@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AETILE_HPP_INCLUDE_GUARD
+#define AETILE_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aeextent.hpp"
+#include "aegeom.hpp"
+#include "aemorton.hpp"
+#include "aepoint.hpp"
+#include "aeproj.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cinttypes>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note A tile in the XYZ ("slippy map") pyramid over WebMercator: zoom
+//  level z divides the square into 2**z by 2**z tiles, numbered from the
+//  north-west corner with y down, as in aeWKID::WebMercatorPixels.  Zoom
+//  levels run from 0 to maxZoom.
+//
+//  A tile's Morton code interleaves its x and y (x in the even bits), which
+//  is also its quadkey read as a base 4 number, so sorting tiles of one zoom
+//  level by Morton code orders them along the Z-order curve and keeps each
+//  parent's children together.
+
+struct aeTile {
+    static constexpr uint32_t maxZoom = 31;
+
+    uint32_t x;
+    uint32_t y;
+    uint32_t zoom;
+
+    aeTile(): x(0), y(0), zoom(0) {}
+    aeTile(uint32_t x, uint32_t y, uint32_t zoom): x(x), y(y), zoom(zoom) {}
+
+    /**
+     * The tile containing a WGS 84 longitude and latitude, in degrees.
+     * Points outside the square are assigned to the nearest tile on its
+     * edge.  Throws aeArgumentError if the zoom level is out of range.
+     */
+    static aeTile at(double lon, double lat, uint32_t zoom);
+
+    /**
+     * Parses a quadkey, throwing aeArgumentError if it has characters other
+     * than 0 to 3 or is longer than maxZoom.
+     */
+    static aeTile fromQuadkey(const std::string &quadkey);
+
+    static aeTile fromMorton(uint64_t code, uint32_t zoom) {
+        aeTile tile(0, 0, zoom);
+        aeMortonDecode(code, tile.x, tile.y);
+        return tile;
+    }
+
+    std::string quadkey() const;
+
+    uint64_t morton() const { return aeMortonEncode(x, y); }
+
+    aeTile parent() const {
+        return zoom ? aeTile(x >> 1, y >> 1, zoom - 1) : *this;
+    }
+
+    /**
+     * Child quadrant 0 to 3, numbered as the last digit of its quadkey.
+     */
+    aeTile child(unsigned int quadrant) const {
+        return aeTile((x << 1) | (quadrant & 1), (y << 1) | ((quadrant >> 1) & 1), zoom + 1);
+    }
+
+    /**
+     * Bounds of the tile in WGS84, WebMercator or WebMercatorPixels
+     * coordinates.  Throws aeArgumentError for any other WKID.
+     */
+    aeExtent extent(aeWKID wkid = aeWKID::WebMercator) const;
+
+    bool operator == (const aeTile &rhs) const {
+        return x == rhs.x && y == rhs.y && zoom == rhs.zoom;
+    }
+
+    bool operator != (const aeTile &rhs) const {
+        return !(*this == rhs);
+    }
+
+    /**
+     * Orders by zoom level, then by Morton code.
+     */
+    bool operator < (const aeTile &rhs) const {
+        return (zoom != rhs.zoom) ? (zoom < rhs.zoom) : (morton() < rhs.morton());
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Tiles at a zoom level intersecting an extent in WGS 84 degrees, in Morton
+ * order.  An empty extent covers no tiles.
+ */
+template <typename T>
+std::vector<aeTile> aeTileCover(const aeExtentT<T> &extent, uint32_t zoom);
+
+/**
+ * Tiles at a zoom level touched by a geometry in WGS 84 degrees, in Morton
+ * order: the tiles holding its points, those crossed by its segments and,
+ * for polygons, those whose centres lie inside it.  Curves are linearized
+ * to a tolerance well under a pixel first.
+ */
+template <typename T>
+std::vector<aeTile> aeTileCover(const aeGeometryT<T> &geometry, uint32_t zoom);
+
+/**
+ * Assigns each of count WGS 84 points to the Morton code of the tile
+ * containing it at a zoom level, as aeTile::at() would.  The per-point work
+ * is a fixed sequence of arithmetic with every constant of the zoom level
+ * computed once, so large batches run without branches in the inner loops.
+ */
+template <typename T>
+void aeTileIDs(
+    const aePointT<T> *points,
+    std::size_t count,
+    uint32_t zoom,
+    uint64_t *ids
+);
+
+template <typename T>
+void aeTileIDs(
+    const T *lon,
+    const T *lat,
+    std::size_t count,
+    uint32_t zoom,
+    uint64_t *ids
+);
+
+template <typename T>
+std::vector<uint64_t> aeTileIDs(
+    const std::vector< aePointT<T> > &points,
+    uint32_t zoom
+) {
+    std::vector<uint64_t> ids(points.size());
+    aeTileIDs(points.data(), points.size(), zoom, ids.data());
+    return ids;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AETILE_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
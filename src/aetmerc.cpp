@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "aetmerc.hpp"
+#include "aeconst.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+static constexpr double degsToRads = aePi / 180.0;
+static constexpr double radsToDegs = 180.0 / aePi;
+
+/*
+ * Sums c[1] sin(2 zeta) + ... + c[6] sin(12 zeta) for the complex argument
+ * zeta = xi + i eta by Clenshaw's recurrence, returning the real and
+ * imaginary parts.  Only sin(2 xi), cos(2 xi), sinh(2 eta) and cosh(2 eta)
+ * are evaluated.
+ */
+void clenshaw(const double *c, double xi, double eta, double &re, double &im) {
+    double s0 = std::sin(2.0 * xi), c0 = std::cos(2.0 * xi);
+    double sh = std::sinh(2.0 * eta), ch = std::cosh(2.0 * eta);
+
+    // a = 2 cos(2 zeta)
+    double ar = 2.0 * c0 * ch, ai = -2.0 * s0 * sh;
+    double y1r = 0.0, y1i = 0.0, y2r = 0.0, y2i = 0.0;
+
+    for (int j = 6; j >= 1; --j) {
+        double yr = ar * y1r - ai * y1i - y2r + c[j];
+        double yi = ar * y1i + ai * y1r - y2i;
+        y2r = y1r; y2i = y1i;
+        y1r = yr;  y1i = yi;
+    }
+
+    // y1 * sin(2 zeta)
+    re = y1r * (s0 * ch) - y1i * (c0 * sh);
+    im = y1r * (c0 * sh) + y1i * (s0 * ch);
+}
+
+/*
+ * Conformal latitude: tan(chi) as a function of tan(phi).
+ */
+double taupf(double tau, double e) {
+    double tau1 = std::hypot(1.0, tau);
+    double sig = std::sinh(e * std::atanh(e * tau / tau1));
+    return std::hypot(1.0, sig) * tau - sig * tau1;
+}
+
+/*
+ * Inverse of taupf by Newton's method; converges in two or three steps.
+ */
+double tauf(double taup, double e, double e2m) {
+    static const double tol = std::sqrt(aeEpsilon) / 10.0;
+    double tau = taup / e2m;
+    double stol = tol * std::max(1.0, std::abs(taup));
+
+    for (int i = 0; i < 5; ++i) {
+        double taupa = taupf(tau, e);
+        double dtau = (taup - taupa) * (1.0 + e2m * tau * tau) /
+                      (e2m * std::hypot(1.0, tau) * std::hypot(1.0, taupa));
+        tau += dtau;
+        if (!(std::abs(dtau) >= stol)) {
+            break;
+        }
+    }
+
+    return tau;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+constexpr double aeTransverseMercator::wgs84A;
+constexpr double aeTransverseMercator::wgs84F;
+
+aeTransverseMercator::aeTransverseMercator(
+    double a,
+    double f,
+    double lon0,
+    double lat0,
+    double k0,
+    double falseEasting,
+    double falseNorthing
+): mLon0(lon0), mK0(k0), mFalseEasting(falseEasting), mFalseNorthing(0.0) {
+    if (!(a > 0.0) || !(f >= 0.0 && f < 1.0) || !(k0 > 0.0)) {
+        throw aeArgumentError();
+    }
+
+    double n = f / (2.0 - f);
+    double n2 = n * n, n3 = n2 * n, n4 = n3 * n, n5 = n4 * n, n6 = n5 * n;
+
+    mE = std::sqrt(f * (2.0 - f));
+    mE2m = 1.0 - mE * mE;
+    mScale = k0 * a / (1.0 + n) * (1.0 + n2 / 4.0 + n4 / 64.0 + n6 / 256.0);
+
+    mAlpha[0] = 0.0;
+    mAlpha[1] = n / 2.0 - 2.0 * n2 / 3.0 + 5.0 * n3 / 16.0 + 41.0 * n4 / 180.0
+              - 127.0 * n5 / 288.0 + 7891.0 * n6 / 37800.0;
+    mAlpha[2] = 13.0 * n2 / 48.0 - 3.0 * n3 / 5.0 + 557.0 * n4 / 1440.0
+              + 281.0 * n5 / 630.0 - 1983433.0 * n6 / 1935360.0;
+    mAlpha[3] = 61.0 * n3 / 240.0 - 103.0 * n4 / 140.0 + 15061.0 * n5 / 26880.0
+              + 167603.0 * n6 / 181440.0;
+    mAlpha[4] = 49561.0 * n4 / 161280.0 - 179.0 * n5 / 168.0
+              + 6601661.0 * n6 / 7257600.0;
+    mAlpha[5] = 34729.0 * n5 / 80640.0 - 3418889.0 * n6 / 1995840.0;
+    mAlpha[6] = 212378941.0 * n6 / 319334400.0;
+
+    mBeta[0] = 0.0;
+    mBeta[1] = n / 2.0 - 2.0 * n2 / 3.0 + 37.0 * n3 / 96.0 - n4 / 360.0
+             - 81.0 * n5 / 512.0 + 96199.0 * n6 / 604800.0;
+    mBeta[2] = n2 / 48.0 + n3 / 15.0 - 437.0 * n4 / 1440.0 + 46.0 * n5 / 105.0
+             - 1118711.0 * n6 / 3870720.0;
+    mBeta[3] = 17.0 * n3 / 480.0 - 37.0 * n4 / 840.0 - 209.0 * n5 / 4480.0
+             + 5569.0 * n6 / 90720.0;
+    mBeta[4] = 4397.0 * n4 / 161280.0 - 11.0 * n5 / 504.0
+             - 830251.0 * n6 / 7257600.0;
+    mBeta[5] = 4583.0 * n5 / 161280.0 - 108847.0 * n6 / 3991680.0;
+    mBeta[6] = 20648693.0 * n6 / 638668800.0;
+
+    // northing of the origin, so that (lon0, lat0) maps to the false origin
+    double x0, y0;
+    forward(lon0, lat0, x0, y0);
+    mFalseNorthing = falseNorthing - y0;
+}
+
+aeTransverseMercator aeTransverseMercator::utm(int zone, bool north, double a, double f) {
+    if (zone < 1 || zone > 60) {
+        throw aeArgumentError();
+    }
+
+    return aeTransverseMercator(
+        a, f,
+        6.0 * zone - 183.0, 0.0,
+        0.9996,
+        500000.0, north ? 0.0 : 10000000.0
+    );
+}
+
+int aeTransverseMercator::utmZone(double lon) {
+    double x = std::fmod(lon + 180.0, 360.0);
+    if (x < 0.0) {
+        x += 360.0;
+    }
+    return std::min(60, int(x / 6.0) + 1);
+}
+
+void aeTransverseMercator::forward(double lon, double lat, double &x, double &y) const {
+    double lam = degsToRads * std::remainder(lon - mLon0, 360.0);
+    double phi = degsToRads * lat;
+
+    double taup = taupf(std::tan(phi), mE);
+    double cl = std::cos(lam);
+    double xip = std::atan2(taup, cl);
+    double etap = std::asinh(std::sin(lam) / std::hypot(taup, cl));
+
+    double dxi, deta;
+    clenshaw(mAlpha, xip, etap, dxi, deta);
+
+    x = mFalseEasting + mScale * (etap + deta);
+    y = mFalseNorthing + mScale * (xip + dxi);
+}
+
+void aeTransverseMercator::inverse(double x, double y, double &lon, double &lat) const {
+    double xi = (y - mFalseNorthing) / mScale;
+    double eta = (x - mFalseEasting) / mScale;
+
+    double dxi, deta;
+    clenshaw(mBeta, xi, eta, dxi, deta);
+
+    double xip = xi - dxi, etap = eta - deta;
+    double s = std::sinh(etap), c = std::cos(xip);
+    double taup = std::sin(xip) / std::hypot(s, c);
+
+    lat = radsToDegs * std::atan(tauf(taup, mE, mE2m));
+    lon = mLon0 + radsToDegs * std::atan2(s, c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef AETMERC_HPP_INCLUDE_GUARD
+#define AETMERC_HPP_INCLUDE_GUARD 1
+
+////////////////////////////////////////////////////////////////////////////////
+
+//  @note Ellipsoidal Transverse Mercator using Krüger's series to sixth order
+//  in the third flattening n, as given by Karney (2011), "Transverse Mercator
+//  with an accuracy of a few nanometers".  The series is accurate to well
+//  under a millimetre within 4000 km of the central meridian.  Everything that
+//  depends only on the ellipsoid and the zone is computed by the constructor;
+//  each series is summed by Clenshaw's method, so a point costs one set of
+//  sin, cos, sinh and cosh calls regardless of the order.
+//
+//  Angles are in degrees, longitude first; distances are in the units of the
+//  semi-major axis.
+
+class aeTransverseMercator {
+public:
+    static constexpr double wgs84A = 6378137.0;
+    static constexpr double wgs84F = 1.0 / 298.257223563;
+
+public:
+    /**
+     * Projection on the ellipsoid with semi-major axis a and flattening f,
+     * centred on (lon0, lat0) with scale factor k0 on the central meridian.
+     */
+    aeTransverseMercator(
+        double a,
+        double f,
+        double lon0,
+        double lat0,
+        double k0,
+        double falseEasting = 0.0,
+        double falseNorthing = 0.0
+    );
+
+    /**
+     * UTM zone 1 to 60, on the WGS 84 ellipsoid unless another is given;
+     * southern zones have a false northing of 10000 km.  Throws
+     * aeArgumentError for other zones.
+     */
+    static aeTransverseMercator utm(
+        int zone,
+        bool north,
+        double a = wgs84A,
+        double f = wgs84F
+    );
+
+    /**
+     * Standard UTM zone (1 to 60) containing a longitude.  The Norway and
+     * Svalbard exceptions are not applied.
+     */
+    static int utmZone(double lon);
+
+    void forward(double lon, double lat, double &x, double &y) const;
+    void inverse(double x, double y, double &lon, double &lat) const;
+
+    double centralMeridian() const { return mLon0; }
+    double scaleFactor() const { return mK0; }
+
+private:
+    double mLon0;
+    double mK0;
+    double mFalseEasting;
+    double mFalseNorthing;
+    double mE;          // eccentricity
+    double mE2m;        // 1 - e^2
+    double mScale;      // k0 * A, A being the rectifying radius
+    double mAlpha[7];   // forward series, [1] to [6]
+    double mBeta[7];    // inverse series, [1] to [6]
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // AETMERC_HPP_INCLUDE_GUARD
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
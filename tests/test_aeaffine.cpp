@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aeaffine.hpp"
+#include "aeexcept.hpp"
+#include "aepacked.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("affine transforms", "[aeAffineTransform]") {
+    aeAffineTransform t = aeAffineTransform::translation(10.0, 20.0);
+    aeAffineTransform s = aeAffineTransform::scaling(2.0, 3.0);
+    aeAffineTransform r = aeAffineTransform::rotation(aePi / 2.0);
+
+    SECTION("single points") {
+        CHECK(t(aePoint(1.0, 2.0)) == aePoint(11.0, 22.0));
+        CHECK(s(aePoint(1.0, 2.0, 5.0, 7.0)) == aePoint(2.0, 6.0, 5.0, 7.0));
+
+        aePoint p = r(aePoint(1.0, 0.0));
+        CHECK(p.x == Approx(0.0).epsilon(1e-12));
+        CHECK(p.y == Approx(1.0));
+
+        CHECK(t.is2D());
+        CHECK(!aeAffineTransform::translation(0.0, 0.0, 1.0).is2D());
+    }
+
+    SECTION("composition") {
+        // Scale first, then translate
+        aeAffineTransform st = s.then(t);
+        CHECK(st(aePoint(1.0, 1.0)) == aePoint(12.0, 23.0));
+        CHECK((t * s)(aePoint(1.0, 1.0)) == aePoint(12.0, 23.0));
+        CHECK((s * t)(aePoint(1.0, 1.0)) == aePoint(22.0, 63.0));
+
+        aeAffineTransform u = t;
+        u *= s;
+        CHECK(u(aePoint(1.0, 1.0)) == aePoint(12.0, 23.0));
+    }
+
+    SECTION("inverse") {
+        const double m[12] = {
+            2.0, 1.0, 0.5, 4.0,
+            0.0, 3.0, 1.0, -2.0,
+            1.0, 0.0, 1.0, 7.0
+        };
+        aeAffineTransform a(m);
+        const aeAffineTransform &inv = a.inverse();
+        CHECK(&a.inverse() == &inv);
+
+        aePoint p(1.5, -2.0, 3.0, 9.0);
+        aePoint q = inv(a(p));
+        CHECK(q.x == Approx(p.x));
+        CHECK(q.y == Approx(p.y));
+        CHECK(q.z == Approx(p.z));
+        CHECK(q.m == 9.0);
+
+        CHECK_THROWS_AS(aeAffineTransform::scaling(0.0, 1.0).inverse(), aeArgumentError);
+    }
+
+    SECTION("shared inverse") {
+        const aeAffineTransform shared = aeAffineTransform::rotation(0.3).then(t);
+        std::vector<const aeAffineTransform*> seen(4);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < seen.size(); ++i) {
+            threads.emplace_back([&shared, &seen, i]() {
+                aeAffineTransform copy = shared;
+                seen[i] = &shared.inverse();
+                copy.inverse();
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        for (const aeAffineTransform *inv : seen) {
+            CHECK(inv == &shared.inverse());
+        }
+    }
+
+    SECTION("batches") {
+        aeAffineTransform a = r.then(t);
+
+        std::vector<aePoint> points;
+        for (int i = 0; i < 100; ++i) {
+            points.push_back(aePoint(i, -i, 0.5 * i, i));
+        }
+
+        std::vector<aePoint> out(points.size());
+        a.apply(points.data(), out.data(), points.size());
+
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            aePoint e = a(points[i]);
+            CHECK(out[i].x == e.x);
+            CHECK(out[i].y == e.y);
+            CHECK(out[i].z == points[i].z);
+        }
+
+        // In place
+        a.apply(points);
+        CHECK(points == out);
+    }
+
+    SECTION("packed coordinates") {
+        aeGeometry g = { aeGeometry::Type(aeGeometry::LineString | aeGeometry::HasM) };
+        g.points().push_back({1.0, 2.0, 0.0, 5.0});
+        g.points().push_back({3.0, 4.0, 0.0, 6.0});
+
+        aePackedPoints p(g);
+        std::vector<double> out(p.size() * p.stride());
+
+        t.apply(p.data(), out.data(), p.size(), p.stride(), p.hasZ());
+        CHECK(out[0] == 11.0);
+        CHECK(out[1] == 22.0);
+        CHECK(out[2] == 5.0);
+        CHECK(out[5] == 6.0);
+
+        std::vector<double> xy = { 1.0, 2.0, 3.0, 4.0 };
+        s.apply(xy.data(), xy.data(), 2, 2, false);
+        CHECK(xy[2] == 6.0);
+        CHECK(xy[3] == 12.0);
+
+        CHECK_THROWS_AS(s.apply(xy.data(), xy.data(), 2, 2, true), aeArgumentError);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
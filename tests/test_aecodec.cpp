@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aecodec.hpp"
+#include "aeexcept.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("varints", "[aeGeometryCodec]") {
+    std::vector<int64_t> values = {
+        0, 1, -1, 63, -64, 64, 300, -300, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+        INT64_MAX, INT64_MIN, 123456789012LL
+    };
+
+    std::vector<uint8_t> buffer;
+    aeEncodeVarints(values.data(), values.size(), buffer);
+
+    CHECK(buffer[0] == 0);
+    CHECK(buffer[1] == 2);
+    CHECK(buffer[2] == 1);
+
+    std::vector<int64_t> decoded(values.size());
+    CHECK(aeDecodeVarints(buffer.data(), buffer.size(), decoded.data(), decoded.size()) == buffer.size());
+    CHECK(decoded == values);
+
+    CHECK_THROWS_AS(aeDecodeVarints(buffer.data(), buffer.size() - 1, decoded.data(), decoded.size()),
+                    aeStreamError);
+}
+
+TEST_CASE("geometry codec", "[aeGeometryCodec]") {
+    aeGeometryCodec codec(1e-6);
+
+    aeGeometry g = { aeGeometry::Type(aeGeometry::MultiLineString | aeGeometry::HasM) };
+    for (int i = 0; i < 1000; ++i) {
+        g.points().push_back({10.0 + i * 1e-4, 50.0 + std::sin(i * 0.01) * 1e-2, 0.0, double(i)});
+    }
+    g.parts().push_back(0);
+    g.parts().push_back(400);
+
+    SECTION("buffer round trip") {
+        std::vector<uint8_t> buffer;
+        codec.encode(g, buffer);
+
+        // Well under the 24 bytes per point of raw xym doubles
+        CHECK(buffer.size() < 8 * g.points().size());
+
+        aeGeometry r(aeGeometry::Geometry);
+        CHECK(codec.decode(buffer.data(), buffer.size(), r) == buffer.size());
+
+        CHECK(r.type() == g.type());
+        CHECK(r.parts() == g.parts());
+        REQUIRE(r.points().size() == g.points().size());
+
+        for (std::size_t i = 0; i < g.points().size(); ++i) {
+            CHECK(std::abs(r.points()[i].x - g.points()[i].x) <= 0.5e-6);
+            CHECK(std::abs(r.points()[i].y - g.points()[i].y) <= 0.5e-6);
+            CHECK(r.points()[i].z == 0.0);
+            CHECK(r.points()[i].m == Approx(g.points()[i].m));
+        }
+
+        CHECK_THROWS_AS(codec.decode(buffer.data(), buffer.size() - 1, r), aeStreamError);
+    }
+
+    SECTION("stream round trip") {
+        aeGeometry c = { aeGeometry::CurvePolygon };
+        c.partTypes().push_back(aeGeometry::CircularString);
+        c.points().push_back({1.0, 0.0});
+        c.points().push_back({-1.0, 0.0});
+        c.points().push_back({1.0, 0.0});
+
+        std::vector<uint8_t> memory(1 << 16);
+        aeMemoryOutputStream out(memory.data(), memory.size());
+        codec.encode(g, out);
+        codec.encode(c, out);
+
+        aeMemoryInputStream in(memory.data(), out.tell());
+        aeGeometry r1 = codec.decode(in);
+        aeGeometry r2 = codec.decode(in);
+
+        CHECK(r1.points().size() == g.points().size());
+        CHECK(r2.type() == aeGeometry::CurvePolygon);
+        CHECK(r2.partType(0) == aeGeometry::CircularString);
+        CHECK(r2.area() == Approx(aePi));
+        CHECK(in.tell() == out.tell());
+
+        CHECK_THROWS_AS(codec.decode(in), aeStreamError);
+    }
+
+    SECTION("corrupt records") {
+        // Records are built by hand: a length, then the type, part offsets,
+        // part types, point count and point deltas, all small enough to be
+        // single-byte varints unless noted
+        auto decode = [&codec](std::vector<uint8_t> body) {
+            body.insert(body.begin(), uint8_t(body.size()));
+            aeGeometry r(aeGeometry::Geometry);
+            return codec.decode(body.data(), body.size(), r);
+        };
+
+        const uint8_t line = aeGeometry::LineString, curve = aeGeometry::CurvePolygon;
+
+        CHECK(decode({ line, 0, 0, 2, 0, 0, 0, 0 }) == 9);
+
+        // a part starting past the last point
+        CHECK_THROWS_AS(decode({ line, 2, 0, 5, 0, 2, 0, 0, 0, 0 }), aeStreamError);
+
+        // a part type that is neither linear nor circular
+        CHECK_THROWS_AS(decode({ curve, 0, 1, 99, 3, 0, 0, 0, 0, 0, 0 }), aeStreamError);
+
+        // deltas that would overflow the running coordinate
+        const int64_t huge[] = { std::numeric_limits<int64_t>::max(), 0,
+                                 std::numeric_limits<int64_t>::max(), 0 };
+        std::vector<uint8_t> body = { line, 0, 0, 2 };
+        aeEncodeVarints(huge, 4, body);
+        CHECK_THROWS_AS(decode(body), aeStreamError);
+    }
+
+    SECTION("invalid precision") {
+        CHECK_THROWS_AS(aeGeometryCodec(0.0), aeArgumentError);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aedatum.hpp"
+#include "aeexcept.hpp"
+#include "aeproj.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("datums", "[aeDatum]") {
+    const aeDatum &wgs84 = aeDatum::wgs84();
+    double x, y, z, lon, lat, h;
+
+    SECTION("geocentric coordinates") {
+        wgs84.toGeocentric(0.0, 0.0, 0.0, x, y, z);
+        REQUIRE(x == Approx(6378137.0));
+        REQUIRE(std::abs(y) < 1e-6);
+        REQUIRE(std::abs(z) < 1e-6);
+
+        wgs84.toGeocentric(90.0, 0.0, 100.0, x, y, z);
+        REQUIRE(std::abs(x) < 1e-6);
+        REQUIRE(y == Approx(6378237.0));
+
+        wgs84.toGeocentric(0.0, 90.0, 0.0, x, y, z);
+        REQUIRE(z == Approx(6356752.314245));
+
+        for (double la = -89.5; la <= 90.0; la += 7.5) {
+            for (double hh = -1000.0; hh <= 20000.0; hh += 3000.0) {
+                wgs84.toGeocentric(-123.25, la, hh, x, y, z);
+                wgs84.fromGeocentric(x, y, z, lon, lat, h);
+                REQUIRE(std::abs(lon + 123.25) < 1e-10);
+                REQUIRE(std::abs(lat - la) < 1e-10);
+                REQUIRE(std::abs(h - hh) < 1e-6);
+            }
+        }
+    }
+
+    SECTION("helmert shifts") {
+        REQUIRE(wgs84.isWGS84());
+        REQUIRE(!aeDatum::osgb36().isWGS84());
+        REQUIRE(!aeDatum::etrs89().isWGS84());
+        REQUIRE(aeDatumShift(wgs84, wgs84).isIdentity());
+        REQUIRE_THROWS_AS(aeDatum("bad", -1.0, 0.0), aeArgumentError);
+
+        // the OSGB 1936 prime meridian lies about 100 m west of WGS 84's
+        aeDatumShift toWGS84(aeDatum::osgb36(), wgs84);
+        lon = 0.0; lat = 51.4778; h = 0.0;
+        toWGS84.apply(lon, lat, h);
+        REQUIRE(lon < -0.0014);
+        REQUIRE(lon > -0.0018);
+        REQUIRE(h > 40.0);
+        REQUIRE(h < 50.0);
+
+        aeDatumShift fromWGS84(wgs84, aeDatum::osgb36());
+        fromWGS84.apply(lon, lat, h);
+        REQUIRE(std::abs(lon) < 1e-10);
+        REQUIRE(std::abs(lat - 51.4778) < 1e-10);
+        REQUIRE(std::abs(h) < 1e-6);
+    }
+
+    SECTION("batch shifts") {
+        aeDatumShift shift(wgs84, aeDatum::ed50());
+        std::vector<aePoint> points, out;
+        for (int i = 0; i < 40; ++i) {
+            points.push_back(aePoint(-10.0 + i, 35.0 + 0.5 * i, 10.0 * i, i));
+        }
+
+        out.resize(points.size());
+        shift.apply(points.data(), out.data(), points.size());
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            REQUIRE(out[i] == shift.apply(points[i]));
+            REQUIRE(out[i].m == points[i].m);
+        }
+    }
+
+    SECTION("projections on other datums") {
+        aeProjection utm(aeUTM(30, true));
+        utm.setDatum(aeDatum::ed50());
+        REQUIRE(&utm.getDatum() == &aeDatum::ed50());
+
+        aeTransverseMercator tm = aeTransverseMercator::utm(30, true, 6378388.0, 1.0 / 297.0);
+        aeDatumShift shift(wgs84, aeDatum::ed50());
+
+        aePoint p(-3.7, 40.4, 650.0);
+        aePoint q = utm.project(p);
+        aePoint s = shift.apply(p);
+        tm.forward(s.x, s.y, x, y);
+        REQUIRE(std::abs(q.x - x) < 1e-6);
+        REQUIRE(std::abs(q.y - y) < 1e-6);
+        REQUIRE(std::abs(q.z - s.z) < 1e-6);
+
+        aePoint r = utm.unproject(q);
+        REQUIRE(std::abs(r.x - p.x) < 1e-9);
+        REQUIRE(std::abs(r.y - p.y) < 1e-9);
+        REQUIRE(std::abs(r.z - p.z) < 1e-4);
+
+        aeVerticalDatum geoid("local", 50.0);
+        utm.setVerticalDatum(&geoid);
+        REQUIRE(std::abs(utm.project(p).z - (s.z - 50.0)) < 1e-6);
+        REQUIRE(std::abs(utm.unproject(utm.project(p)).z - p.z) < 1e-4);
+
+        std::vector<double> xs(1, p.x), ys(1, p.y);
+        utm.project(xs.data(), ys.data(), xs.data(), ys.data(), 1);
+        REQUIRE(std::abs(xs[0] - utm.project(aePoint(p.x, p.y)).x) < 1e-9);
+        // heights are dropped between the steps, which costs a few mm
+        utm.unproject(xs.data(), ys.data(), xs.data(), ys.data(), 1);
+        REQUIRE(std::abs(xs[0] - p.x) < 1e-7);
+        REQUIRE(std::abs(ys[0] - p.y) < 1e-7);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aeepsg.hpp"
+#include "aeproj.hpp"
+#include "aetmerc.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("EPSG registry", "[aeEPSG]") {
+    aeEPSGDefinition d;
+
+    SECTION("lookup") {
+        REQUIRE(aeEPSG::lookup(4326, d));
+        REQUIRE(d.name() == "WGS 84");
+        REQUIRE(d.method == aeEPSGDefinition::Geographic);
+        REQUIRE(d.datum == &aeDatum::wgs84());
+
+        REQUIRE(aeEPSG::lookup(32631, d));
+        REQUIRE(d.name() == "WGS 84 / UTM zone 31N");
+        REQUIRE(std::string(d.baseName) == "WGS 84");
+        REQUIRE(d.zone == 31);
+        REQUIRE(d.north);
+        REQUIRE(d.method == aeEPSGDefinition::TransverseMercator);
+        REQUIRE(d.centralMeridian == 3.0);
+        REQUIRE(d.falseNorthing == 0.0);
+
+        REQUIRE(aeEPSG::lookup(32760, d));
+        REQUIRE(d.name() == "WGS 84 / UTM zone 60S");
+        REQUIRE(d.centralMeridian == 177.0);
+        REQUIRE(d.falseNorthing == 10000000.0);
+
+        REQUIRE(aeEPSG::lookup(25832, d));
+        REQUIRE(d.name() == "ETRS89 / UTM zone 32N");
+        REQUIRE(d.centralMeridian == 9.0);
+        REQUIRE(d.datum == &aeDatum::etrs89());
+
+        REQUIRE(aeEPSG::lookup(26918, d));
+        REQUIRE(d.name() == "NAD83 / UTM zone 18N");
+        REQUIRE(d.centralMeridian == -75.0);
+
+        REQUIRE(aeEPSG::lookup(23030, d));
+        REQUIRE(d.datum == &aeDatum::ed50());
+
+        REQUIRE(!aeEPSG::lookup(32600, d));
+        REQUIRE(!aeEPSG::lookup(32661, d));
+        REQUIRE(!aeEPSG::lookup(25827, d));
+        REQUIRE(!aeEPSG::lookup(99999, d));
+        REQUIRE(aeEPSG::toWKT(99999).empty());
+    }
+
+    SECTION("WKT") {
+        REQUIRE(aeEPSG::toWKT(4326) ==
+            "GEOGCS[\"WGS 84\",DATUM[\"WGS_1984\","
+            "SPHEROID[\"WGS 84\",6378137,298.257223563,AUTHORITY[\"EPSG\",\"7030\"]],"
+            "AUTHORITY[\"EPSG\",\"6326\"]],"
+            "PRIMEM[\"Greenwich\",0,AUTHORITY[\"EPSG\",\"8901\"]],"
+            "UNIT[\"degree\",0.0174532925199433,AUTHORITY[\"EPSG\",\"9122\"]],"
+            "AUTHORITY[\"EPSG\",\"4326\"]]");
+
+        std::string utm = aeEPSG::toWKT(32631);
+        REQUIRE(utm.find("PROJCS[\"WGS 84 / UTM zone 31N\",GEOGCS[\"WGS 84\"") == 0);
+        REQUIRE(utm.find("PROJECTION[\"Transverse_Mercator\"]") != std::string::npos);
+        REQUIRE(utm.find("PARAMETER[\"central_meridian\",3]") != std::string::npos);
+        REQUIRE(utm.find("PARAMETER[\"scale_factor\",0.9996]") != std::string::npos);
+        REQUIRE(utm.find("PARAMETER[\"false_easting\",500000]") != std::string::npos);
+        REQUIRE(utm.find("AUTHORITY[\"EPSG\",\"32631\"]]") == utm.size() - 26);
+
+        REQUIRE(aeEPSG::toWKT(3857).find("PROJECTION[\"Mercator_1SP\"]") != std::string::npos);
+    }
+
+    SECTION("British National Grid") {
+        // Ordnance Survey's worked example, in OSGB 1936 coordinates
+        REQUIRE(aeEPSG::lookup(27700, d));
+        aeTransverseMercator tm(
+            d.datum->semiMajorAxis(), d.datum->flattening(),
+            d.centralMeridian, d.latitudeOfOrigin, d.scaleFactor,
+            d.falseEasting, d.falseNorthing
+        );
+
+        double x, y;
+        tm.forward(1.0 + 43.0 / 60.0 + 4.5177 / 3600.0,
+                   52.0 + 39.0 / 60.0 + 27.2531 / 3600.0, x, y);
+        REQUIRE(std::abs(x - 651409.903) < 1e-3);
+        REQUIRE(std::abs(y - 313177.270) < 1e-3);
+    }
+
+    SECTION("projections") {
+        aeProjection bng(aeWKID(27700));
+        REQUIRE(&bng.getDatum() == &aeDatum::osgb36());
+        REQUIRE(bng.toString().find("PROJCS[\"OSGB 1936 / British National Grid\"") == 0);
+
+        aePoint p(-0.1275, 51.5072);
+        aePoint q = bng.unproject(bng.project(p));
+        REQUIRE(std::abs(q.x - p.x) < 1e-9);
+        REQUIRE(std::abs(q.y - p.y) < 1e-9);
+
+        REQUIRE(aeProjection().toString() == aeEPSG::toWKT(4326));
+        REQUIRE(aeProjection(aeWKID::WebMercatorPixels).toString().empty());
+        REQUIRE(aeProjection(aeUTM(31, true)).toString() == aeEPSG::toWKT(32631));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -45,6 +45,134 @@ TEST_CASE("extent operations", "[aeExtent][extent]") {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("compact extent operations", "[aeExtent2][extent]") {
+    aeExtent2 e1(0.0, 0.0, 1.0, 1.0);
+    aeExtent2 e2(1.0, 1.0, 2.0, 2.0);
+
+    SECTION("empty extent") {
+        aeExtent2 e;
+        CHECK(e.isEmpty());
+        CHECK(e.area() == 0.0);
+        CHECK(!e.intersects(e1));
+        CHECK(!e1.intersects(e));
+        CHECK(e1.contains(e));
+
+        e |= aePoint(aeNaN, 2.0);
+        CHECK(e.isEmpty());
+
+        e |= aePoint(3.0, 2.0);
+        CHECK(!e.isEmpty());
+        CHECK(e.xmin == 3.0);
+        CHECK(e.ymax == 2.0);
+        CHECK(e.area() == 0.0);
+
+        CHECK(aeExtent2(aeExtent()).isEmpty());
+        CHECK(aeExtent2().toExtent().isEmpty());
+    }
+
+    SECTION("union") {
+        aeExtent2 e = e1 | e2;
+        CHECK(e.xmin == 0.0);
+        CHECK(e.ymin == 0.0);
+        CHECK(e.xmax == 2.0);
+        CHECK(e.ymax == 2.0);
+        CHECK(e.area() == 4.0);
+        CHECK(e.contains(e1));
+        CHECK(e.contains(aePoint(2.0, 0.5)));
+        CHECK(!e1.contains(e));
+    }
+
+    SECTION("intersection") {
+        CHECK(e1.intersects(e2));
+        CHECK((e1 & e2).area() == 0.0);
+        CHECK(!(e1 & e2).isEmpty());
+
+        aeExtent2 e3(0.5, 0.5, 1.5, 1.5);
+        aeExtent2 e = e1 & e3;
+        CHECK(e.xmin == 0.5);
+        CHECK(e.xmax == 1.0);
+        CHECK(e.area() == Approx(0.25));
+
+        aeExtent2 e4(3.0, 0.0, 4.0, 1.0);
+        CHECK(!e1.intersects(e4));
+        CHECK((e1 & e4).isEmpty());
+        CHECK((e1 & e4).area() == 0.0);
+    }
+
+    SECTION("conversion") {
+        aeExtent e = { aePoint(0.0, 1.0, 5.0, 6.0), aePoint(2.0, 3.0, 7.0, 8.0) };
+        aeExtent2 c(e);
+        CHECK(c.xmin == 0.0);
+        CHECK(c.ymin == 1.0);
+        CHECK(c.xmax == 2.0);
+        CHECK(c.ymax == 3.0);
+        CHECK(c.toExtent().max.y == 3.0);
+    }
+
+    SECTION("integer coordinates") {
+        aeExtent2T<int32_t> e;
+        CHECK(e.isEmpty());
+        CHECK(e.area() == 0.0);
+
+        e |= aePointT<int32_t>(-2000000000, 0);
+        e |= aePointT<int32_t>(2000000000, 3);
+        CHECK(e.width() == 4e9);
+        CHECK(e.area() == 12e9);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("bulk extent computation", "[aeExtent][extent]") {
+    std::vector<aePoint> points;
+
+    SECTION("empty") {
+        aeExtent e = aeComputeExtent(points);
+        CHECK(std::isnan(e.min.x));
+        CHECK(std::isnan(e.max.y));
+    }
+
+    SECTION("matches serial union") {
+        for (int i = 0; i < 300000; ++i) {
+            double t = i * 0.001;
+            points.push_back(aePoint(std::sin(t) * t, std::cos(t * 1.3) * 50.0, t, -t));
+        }
+        points[1234].x = aeNaN;
+
+        aeExtent serial;
+        for (const aePoint &p : points) {
+            if (!std::isnan(p.x)) {
+                serial |= p;
+            }
+        }
+
+        for (unsigned int threads : { 1u, 3u, 0u }) {
+            aeExtent e = aeComputeExtent(points, threads);
+            CHECK(e.min.x == serial.min.x);
+            CHECK(e.min.y == serial.min.y);
+            CHECK(e.min.z == serial.min.z);
+            CHECK(e.min.m == serial.min.m);
+            CHECK(e.max.x == serial.max.x);
+            CHECK(e.max.y == serial.max.y);
+            CHECK(e.max.z == serial.max.z);
+            CHECK(e.max.m == serial.max.m);
+        }
+    }
+
+    SECTION("integer coordinates") {
+        std::vector< aePointT<int32_t> > fixed;
+        fixed.push_back(aePointT<int32_t>(5, -7));
+        fixed.push_back(aePointT<int32_t>(-3, 9));
+
+        aeExtentT<int32_t> e = aeComputeExtent(fixed);
+        CHECK(e.min.x == -3);
+        CHECK(e.max.y == 9);
+        CHECK(aeComputeExtent(std::vector< aePointT<int32_t> >()).isEmpty());
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
 ////////////////////////////////////////////////////////////////////////////////
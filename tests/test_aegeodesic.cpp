@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aeconst.hpp"
+#include "aeexcept.hpp"
+#include "aegeodesic.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+// reference values from GeographicLib 2.1
+
+TEST_CASE("Geodesic inverse problem", "[aeGeodesic]") {
+    const aeGeodesic &g = aeGeodesic::wgs84();
+
+    struct Case {
+        double lon1, lat1, lon2, lat2, s12, azi1, azi2;
+    };
+
+    const Case cases[] = {
+        // Wellington to Salamanca
+        { 174.81, -41.32, -5.50, 40.96, 19959679.26735382, 161.06766998616015, 18.825195123247063 },
+        // nearly antipodal
+        { 0.0, 0.0, 179.5, 0.5, 19936288.578965314, 25.67187286829188, 154.3270854699416 },
+        // antipodal on the equator: along a meridian
+        { 0.0, 0.0, 180.0, 0.0, 20003931.458625447, 0.0, 180.0 },
+        // pole to pole
+        { 10.0, 90.0, 20.0, -90.0, 20003931.458625447, 170.0, 180.0 },
+        // along the equator
+        { 0.0, 0.0, 90.0, 0.0, 10018754.171394622, 90.0, 90.0 },
+        // London to Paris
+        { -0.1276, 51.5072, 2.3522, 48.8566, 343896.8912667699, 148.0460854772808, 149.9514061980973 },
+        // along a meridian
+        { 0.0, 30.0, 0.0, 31.0, 110860.92556607969, 0.0, 0.0 },
+    };
+
+    for (const Case &c : cases) {
+        double azi1, azi2;
+        double s12 = g.inverse(c.lon1, c.lat1, c.lon2, c.lat2, azi1, azi2);
+        REQUIRE(std::fabs(s12 - c.s12) < 1e-8);
+        REQUIRE(std::fabs(azi1 - c.azi1) < 1e-12);
+        REQUIRE(std::fabs(azi2 - c.azi2) < 1e-12);
+        REQUIRE(g.inverse(c.lon1, c.lat1, c.lon2, c.lat2) == s12);
+    }
+
+    REQUIRE(g.inverse(12.0, 34.0, 12.0, 34.0) == 0.0);
+    REQUIRE(std::isnan(g.inverse(0.0, 91.0, 0.0, 0.0)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Geodesic direct problem", "[aeGeodesic]") {
+    const aeGeodesic &g = aeGeodesic::wgs84();
+    double lon2, lat2, azi2;
+
+    g.direct(-73.8, 40.6, 45.0, 10000000.0, lon2, lat2, azi2);
+    REQUIRE(std::fabs(lon2 - 49.0110395832242) < 1e-12);
+    REQUIRE(std::fabs(lat2 - 32.642844327605516) < 1e-12);
+    REQUIRE(std::fabs(azi2 - 140.36623046535098) < 1e-12);
+
+    // round trips through the inverse solution
+    std::mt19937 rng(45);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0), lat(-90.0, 90.0);
+
+    for (int i = 0; i < 1000; ++i) {
+        double lon1 = lon(rng), lat1 = lat(rng), lon3 = lon(rng), lat3 = lat(rng);
+        double azi1, azi3;
+        double s13 = g.inverse(lon1, lat1, lon3, lat3, azi1, azi3);
+
+        g.direct(lon1, lat1, azi1, s13, lon2, lat2, azi2);
+        REQUIRE(g.inverse(lon2, lat2, lon3, lat3) < 1e-6);
+    }
+
+    aeGeodesic sphere(6371000.0, 0.0);
+    sphere.direct(0.0, 0.0, 90.0, aePi * 6371000.0 / 2.0, lon2, lat2, azi2);
+    REQUIRE(std::fabs(lon2 - 90.0) < 1e-12);
+    REQUIRE(std::fabs(lat2) < 1e-12);
+
+    REQUIRE_THROWS_AS(aeGeodesic(0.0, 0.0), aeArgumentError);
+    REQUIRE_THROWS_AS(aeGeodesic(6378137.0, 1.0), aeArgumentError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Geodesic arrays", "[aeGeodesic]") {
+    const aeGeodesic &g = aeGeodesic::wgs84();
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0), lat(-90.0, 90.0);
+
+    std::vector<aePoint> a(500), b(500);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i] = aePoint(lon(rng), lat(rng));
+        b[i] = aePoint(lon(rng), lat(rng));
+    }
+
+    SECTION("pairwise") {
+        std::vector<double> s12(a.size()), azi1(a.size()), azi2(a.size());
+        g.inverse(a.data(), b.data(), a.size(), s12.data(), azi1.data(), azi2.data());
+
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            double x1, x2;
+            REQUIRE(g.inverse(a[i].x, a[i].y, b[i].x, b[i].y, x1, x2) == s12[i]);
+            REQUIRE(x1 == azi1[i]);
+            REQUIRE(x2 == azi2[i]);
+        }
+
+        std::vector<aePoint> c(a.size());
+        std::vector<double> back(a.size());
+        g.direct(a.data(), azi1.data(), s12.data(), c.data(), a.size(), back.data());
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            REQUIRE(g.inverse(c[i].x, c[i].y, b[i].x, b[i].y) < 1e-6);
+            REQUIRE(std::fabs(std::remainder(back[i] - azi2[i], 360.0)) < 1e-6);
+        }
+    }
+
+    SECTION("consecutive") {
+        std::vector<double> segments(a.size() - 1);
+        double total = g.length(a.data(), a.size(), segments.data());
+
+        double sum = 0.0;
+        for (std::size_t i = 1; i < a.size(); ++i) {
+            REQUIRE(segments[i - 1] == g.inverse(a[i - 1].x, a[i - 1].y, a[i].x, a[i].y));
+            sum += segments[i - 1];
+        }
+        REQUIRE(total == Approx(sum));
+        REQUIRE(g.length(a.data(), 1) == 0.0);
+
+        std::vector<aePointT<float> > floats(1, aePointT<float>(0.0f, 0.0f));
+        floats.push_back(aePointT<float>(90.0f, 0.0f));
+        REQUIRE(std::fabs(g.length(floats.data(), floats.size()) - 10018754.171394622) < 1e-8);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Geodesic areas", "[aeGeodesic]") {
+    const aeGeodesic &g = aeGeodesic::wgs84();
+
+    REQUIRE(g.ellipsoidArea() == Approx(510065621724088.5));
+
+    SECTION("rings") {
+        std::vector<aePoint> square;
+        square.push_back(aePoint(0.0, 0.0));
+        square.push_back(aePoint(1.0, 0.0));
+        square.push_back(aePoint(1.0, 1.0));
+        square.push_back(aePoint(0.0, 1.0));
+
+        REQUIRE(g.area(square.data(), square.size()) == Approx(12308778361.469452).epsilon(1e-12));
+
+        // explicitly closed, or running clockwise
+        square.push_back(square[0]);
+        REQUIRE(g.area(square.data(), square.size()) == Approx(12308778361.469452).epsilon(1e-12));
+        std::reverse(square.begin(), square.end());
+        REQUIRE(g.area(square.data(), square.size()) == Approx(-12308778361.469452).epsilon(1e-12));
+
+        // around the north pole
+        std::vector<aePoint> cap;
+        cap.push_back(aePoint(0.0, 78.0));
+        cap.push_back(aePoint(90.0, 78.0));
+        cap.push_back(aePoint(180.0, 78.0));
+        cap.push_back(aePoint(-90.0, 78.0));
+        REQUIRE(g.area(cap.data(), cap.size()) == Approx(3618178601264.8438).epsilon(1e-12));
+    }
+
+    SECTION("geometries") {
+        aeGeometry polygon(aeGeometry::Polygon);
+        polygon.points().push_back(aePoint(-63.1, -9.0));
+        polygon.points().push_back(aePoint(-67.1, -12.2));
+        polygon.points().push_back(aePoint(-70.2, -10.5));
+        polygon.points().push_back(aePoint(-69.2, -6.8));
+        polygon.points().push_back(aePoint(-64.9, -7.1));
+
+        REQUIRE(g.area(polygon) == Approx(-298795699774.85223).epsilon(1e-12));
+        REQUIRE(g.length(polygon) == Approx(2139084.320375256).epsilon(1e-12));
+        REQUIRE((g.area(polygon) < 0.0) == (polygon.area() < 0.0));
+
+        // a hole running the other way offsets it
+        polygon.parts().push_back(0);
+        polygon.parts().push_back(5);
+        polygon.points().push_back(aePoint(-66.0, -9.0));
+        polygon.points().push_back(aePoint(-67.0, -9.0));
+        polygon.points().push_back(aePoint(-67.0, -10.0));
+        polygon.points().push_back(aePoint(-66.0, -10.0));
+
+        std::vector<aePoint> hole(polygon.points().begin() + 5, polygon.points().end());
+        REQUIRE(g.area(polygon) ==
+                Approx(-298795699774.85223 + g.area(hole.data(), hole.size())).epsilon(1e-12));
+
+        aeGeometry line(aeGeometry::LineString);
+        line.points().push_back(aePoint(0.0, 0.0));
+        line.points().push_back(aePoint(1.0, 0.0));
+        line.points().push_back(aePoint(1.0, 1.0));
+        REQUIRE(g.length(line) == Approx(221893.87935107236).epsilon(1e-12));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,12 @@
 
 #include "catch.hpp"
 #include "aegeom.hpp"
+#include "aeexcept.hpp"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -262,6 +268,242 @@ TEST_CASE("simple polygons", "[aeGeometry][simple]") {
 
         REQUIRE(g.points().size() == 4);
         CHECK(g.findIntersections());
+
+        aeGeometry::Points intersections;
+        REQUIRE(g.findIntersections(intersections));
+        REQUIRE(intersections.size() == 1);
+        CHECK(intersections[0].x == Approx(0.5));
+        CHECK(intersections[0].y == Approx(0.5));
+    }
+
+    SECTION("touching vertex") {
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({2.0, 0.0});
+        g.points().push_back({1.0, 1.0});
+        g.points().push_back({2.0, 2.0});
+        g.points().push_back({0.0, 2.0});
+        g.points().push_back({1.0, 1.0});
+
+        aeGeometry::Points intersections;
+        REQUIRE(g.findIntersections(intersections));
+        REQUIRE(intersections.size() == 1);
+        CHECK(intersections[0].x == Approx(1.0));
+        CHECK(intersections[0].y == Approx(1.0));
+    }
+
+    SECTION("near-degenerate vertex") {
+        // The last vertex lies a hair off the line through the first three,
+        // so the polygon is simple even though it is nearly degenerate.
+        double x = 0.5 - std::ldexp(1.0, -53);
+
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({12.0, 12.0});
+        g.points().push_back({24.0, 24.0});
+        g.points().push_back({24.0, 30.0});
+        g.points().push_back({x, 0.5});
+
+        REQUIRE(g.points().size() == 5);
+        CHECK(!g.findIntersections());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("integer coordinates", "[aeGeometry][fixed]") {
+    aeFixedGeometry g = { aeFixedGeometry::Polygon };
+
+    SECTION("empty polygon") {
+        CHECK(g.area() == Approx(0.0));
+        CHECK(g.extent().isEmpty());
+    }
+
+    SECTION("half-unit triangle far from the origin") {
+        // The cross products here exceed 2^53, so summing them in double
+        // precision would lose the result entirely
+        const int32_t k = 2000000000;
+        g.points().push_back({k, k});
+        g.points().push_back({k + 1, k});
+        g.points().push_back({-k, -k + 1});
+
+        CHECK(g.area() == 0.5 - k);
+        CHECK(g.extent().min.x == -k);
+        CHECK(g.extent().max.x == k + 1);
+        CHECK_FALSE(g.extent().isEmpty());
+    }
+
+    SECTION("square centroid") {
+        g.points().push_back({0, 0});
+        g.points().push_back({3, 0});
+        g.points().push_back({3, 3});
+        g.points().push_back({0, 3});
+
+        CHECK(g.area() == 9.0);
+        CHECK(g.centroid().x == 1.5);
+        CHECK(g.centroid().y == 1.5);
+    }
+
+    SECTION("crossing is rounded to the grid") {
+        g.points().push_back({0, 0});
+        g.points().push_back({10, 10});
+        g.points().push_back({10, 0});
+        g.points().push_back({0, 9});
+
+        aeFixedGeometry::Points p;
+        REQUIRE(g.findIntersections(p));
+        REQUIRE(p.size() == 1);
+        CHECK(p[0].x == 5);
+        CHECK(p[0].y == 5);
+    }
+
+    SECTION("collinear fold-back") {
+        // The dot product of the two segments overflows 32 bits
+        aeFixedGeometry line = { aeFixedGeometry::LineString };
+        line.points().push_back({0, 0});
+        line.points().push_back({51151, 0});
+        line.points().push_back({1, 0});
+        CHECK(line.findIntersections());
+
+        line.points().clear();
+        line.points().push_back({-2000000000, 7});
+        line.points().push_back({2000000000, 7});
+        line.points().push_back({-1999999999, 7});
+        CHECK(line.findIntersections());
+
+        // continuing straight on is not a fold-back
+        line.points().clear();
+        line.points().push_back({-2000000000, 0});
+        line.points().push_back({0, 0});
+        line.points().push_back({2000000000, 0});
+        CHECK_FALSE(line.findIntersections());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("curve geometry", "[aeGeometry][curve]") {
+    SECTION("full circle") {
+        aeGeometry g = { aeGeometry::CurvePolygon };
+        g.partTypes().push_back(aeGeometry::CircularString);
+        g.points().push_back({3.0, 2.0});
+        g.points().push_back({1.0, 2.0});
+        g.points().push_back({3.0, 2.0});
+
+        CHECK(g.area() == Approx(aePi));
+        CHECK(g.centroid().x == Approx(2.0));
+        CHECK(g.centroid().y == Approx(2.0));
+        CHECK(g.extent().min.x == Approx(1.0));
+        CHECK(g.extent().min.y == Approx(1.0));
+        CHECK(g.extent().max.x == Approx(3.0));
+        CHECK(g.extent().max.y == Approx(3.0));
+    }
+
+    SECTION("clockwise circle from two arcs") {
+        aeGeometry g = { aeGeometry::CurvePolygon };
+        g.partTypes().push_back(aeGeometry::CircularString);
+        g.points().push_back({1.0, 0.0});
+        g.points().push_back({0.0, -1.0});
+        g.points().push_back({-1.0, 0.0});
+        g.points().push_back({0.0, 1.0});
+        g.points().push_back({1.0, 0.0});
+
+        CHECK(g.area() == Approx(-aePi));
+    }
+
+    SECTION("half disc as a compound curve") {
+        aeGeometry g = { aeGeometry::CompoundCurve };
+        g.partTypes().push_back(aeGeometry::CircularString);
+        g.partTypes().push_back(aeGeometry::LineString);
+        g.parts().push_back(0);
+        g.parts().push_back(3);
+        g.points().push_back({1.0, 0.0});
+        g.points().push_back({0.0, 1.0});
+        g.points().push_back({-1.0, 0.0});
+        g.points().push_back({-1.0, 0.0});
+        g.points().push_back({1.0, 0.0});
+
+        CHECK(g.area() == Approx(aePi / 2.0));
+        CHECK(std::abs(g.centroid().x) < 1e-12);
+        CHECK(g.centroid().y == Approx(4.0 / (3.0 * aePi)));
+        CHECK(g.extent().min.y == Approx(0.0));
+        CHECK(g.extent().max.y == Approx(1.0));
+
+        std::shared_ptr<const aeGeometry> line = g.linearize(0.01);
+        CHECK(line->type() == aeGeometry::LineString);
+        CHECK(line->points().front().x == 1.0);
+        CHECK(line->points().back().x == 1.0);
+    }
+
+    SECTION("linearization") {
+        aeGeometry g = { aeGeometry::CircularString };
+        g.points().push_back({10.0, 0.0});
+        g.points().push_back({0.0, 10.0});
+        g.points().push_back({-10.0, 0.0});
+
+        std::shared_ptr<const aeGeometry> line = g.linearize(0.01);
+        REQUIRE(line->points().size() > 3);
+        CHECK(line->points().size() ==
+              std::ceil(aePi / (2.0 * std::acos(1.0 - 0.01 / 10.0))) + 1);
+
+        for (std::size_t i = 0; i + 1 < line->points().size(); ++i) {
+            const aePoint &a = line->points()[i], &b = line->points()[i + 1];
+            aePoint mid = (a + b) / 2.0;
+            CHECK(std::hypot(a.x, a.y) == Approx(10.0));
+            CHECK(10.0 - std::hypot(mid.x, mid.y) <= 0.01);
+        }
+
+        // Cached per tolerance
+        CHECK(g.linearize(0.01) == line);
+        CHECK(g.linearize(1.0) != line);
+        CHECK(g.linearize(1.0)->points().size() < line->points().size());
+
+        // Results outlive their cache entries
+        std::size_t count = line->points().size();
+        for (double tolerance : { 0.1, 0.2, 0.3, 0.4, 0.5 }) {
+            g.linearize(tolerance);
+        }
+        g.points().push_back({-10.0, -10.0});
+        CHECK(line->points().size() == count);
+        CHECK(g.linearize(0.01) != line);
+
+        CHECK_THROWS_AS(g.linearize(0.0), aeArgumentError);
+    }
+
+    SECTION("linear geometry") {
+        aeGeometry g = { aeGeometry::LineString };
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({1.0, 0.0});
+
+        CHECK(g.linearize(0.01).get() == &g);
+    }
+
+    SECTION("concurrent linearization") {
+        aeGeometry g = { aeGeometry::CircularString };
+        g.points().push_back({10.0, 0.0});
+        g.points().push_back({0.0, 10.0});
+        g.points().push_back({-10.0, 0.0});
+
+        std::vector< std::shared_ptr<const aeGeometry> > results(8);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            threads.push_back(std::thread([&g, &results, i]() {
+                for (int k = 0; k < 100; ++k) {
+                    results[i] = g.linearize(0.001 * (1 + (i + k) % 6));
+                    if (i % 2) {
+                        // copies read the cache that others are filling
+                        const aeGeometry copy(g);
+                        results[i] = copy.linearize(0.001 * (1 + (i + k) % 6));
+                    }
+                }
+            }));
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            CHECK(results[i]->points().size() ==
+                  g.linearize(0.001 * (1 + (i + 99) % 6))->points().size());
+        }
     }
 }
 
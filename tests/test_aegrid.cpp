@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aedatum.hpp"
+#include "aeexcept.hpp"
+#include "aegrid.hpp"
+#include "aestream.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/*
+ * Builds grid files in memory, in either byte order.
+ */
+class GridWriter {
+public:
+    GridWriter(bool bigEndian): mBigEndian(bigEndian) {}
+
+    void bytes(const void *data, std::size_t size) {
+        const uint8_t *p = static_cast<const uint8_t*>(data);
+        std::size_t at = mData.size();
+        mData.insert(mData.end(), p, p + size);
+        if (mBigEndian != hostBigEndian()) {
+            std::reverse(mData.begin() + at, mData.end());
+        }
+    }
+
+    void label(const char *name) {
+        char s[8];
+        std::memset(s, ' ', 8);
+        std::memcpy(s, name, std::min<std::size_t>(std::strlen(name), 8));
+        mData.insert(mData.end(), s, s + 8);
+    }
+
+    void text(const char *name, const char *value) { label(name); label(value); }
+    void integer(const char *name, int32_t value) { label(name); bytes(&value, 4); pad(4); }
+    void real(const char *name, double value) { label(name); bytes(&value, 8); }
+    void value(float v) { bytes(&v, 4); }
+    void value(double v) { bytes(&v, 8); }
+    void value(int32_t v) { bytes(&v, 4); }
+    void pad(std::size_t n) { mData.insert(mData.end(), n, 0); }
+
+    std::shared_ptr<aeInputStream> stream() {
+        return std::make_shared<aeMemoryInputStream>(mData.data(), mData.size());
+    }
+
+    const std::vector<uint8_t> &data() const { return mData; }
+
+private:
+    static bool hostBigEndian() {
+        const uint16_t probe = 1;
+        return *reinterpret_cast<const uint8_t*>(&probe) == 0;
+    }
+
+    bool mBigEndian;
+    std::vector<uint8_t> mData;
+};
+
+// root grid: 0..2 degrees east and north at 1 degree, with shifts linear in
+// position; child grid: 0.5..1.5 at 0.5 degrees, with a constant shift
+double rootLatShift(double lon, double lat) { return 1.0 + 0.5 * lat + 0.25 * lon; }
+double rootLonShift(double /*lon*/, double lat) { return 2.0 + 0.1 * lat; }
+
+void subGrid(
+    GridWriter &w, const char *name, const char *parent,
+    double south, double north, double east, double west, double step,
+    double (*latShift)(double, double), double (*lonShift)(double, double)
+) {
+    int rows = int((north - south) / step + 0.5) + 1;
+    int columns = int((east - west) / step + 0.5) + 1;
+
+    w.text("SUB_NAME", name);
+    w.text("PARENT", parent);
+    w.text("CREATED", "");
+    w.text("UPDATED", "");
+    w.real("S_LAT", south * 3600.0);
+    w.real("N_LAT", north * 3600.0);
+    w.real("E_LONG", -east * 3600.0);
+    w.real("W_LONG", -west * 3600.0);
+    w.real("LAT_INC", step * 3600.0);
+    w.real("LONG_INC", step * 3600.0);
+    w.integer("GS_COUNT", rows * columns);
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            double lon = east - c * step, lat = south + r * step;
+            w.value(float(latShift(lon, lat)));
+            w.value(float(-lonShift(lon, lat)));
+            w.value(0.0f);
+            w.value(0.0f);
+        }
+    }
+}
+
+double childLatShift(double, double) { return 10.0; }
+double childLonShift(double, double) { return 0.0; }
+
+void overview(GridWriter &w, int32_t files) {
+    w.integer("NUM_OREC", 11);
+    w.integer("NUM_SREC", 11);
+    w.integer("NUM_FILE", files);
+    w.text("GS_TYPE", "SECONDS");
+    w.text("VERSION", "NTv2.0");
+    w.text("SYSTEM_F", "TEST");
+    w.text("SYSTEM_T", "WGS84");
+    w.real("MAJOR_F", 6378137.0);
+    w.real("MINOR_F", 6356752.314);
+    w.real("MAJOR_T", 6378137.0);
+    w.real("MINOR_T", 6356752.314);
+}
+
+GridWriter ntv2(bool bigEndian) {
+    GridWriter w(bigEndian);
+    overview(w, 2);
+    subGrid(w, "ROOT", "NONE", 0.0, 2.0, 2.0, 0.0, 1.0, rootLatShift, rootLonShift);
+    subGrid(w, "CHILD", "ROOT", 0.5, 1.5, 1.5, 0.5, 0.5, childLatShift, childLonShift);
+    w.text("END", "");
+    return w;
+}
+
+// 3 by 3 geoid from (-5, 50) at 1 degree, with one missing node
+GridWriter gtx() {
+    GridWriter w(true);
+    w.value(50.0);
+    w.value(-5.0);
+    w.value(1.0);
+    w.value(1.0);
+    w.value(int32_t(3));
+    w.value(int32_t(3));
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            w.value((r == 2 && c == 2) ? -88.8888f : float(40.0 + r + 0.5 * c));
+        }
+    }
+    return w;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("NTv2 grid shifts", "[aeGrid]") {
+    for (bool bigEndian : { false, true }) {
+        GridWriter w = ntv2(bigEndian);
+        aeGridShift grid(w.stream());
+
+        REQUIRE(grid.gridCount() == 2);
+        REQUIRE(grid.sourceName() == "TEST");
+        REQUIRE(grid.targetName() == "WGS84");
+        REQUIRE(grid.extent().min.x == Approx(0.0));
+        REQUIRE(grid.extent().max.y == Approx(2.0));
+
+        // bilinear interpolation is exact for shifts linear in position, up
+        // to the single precision of the stored shifts
+        double lon = 0.25, lat = 0.3;
+        REQUIRE(grid.apply(lon, lat));
+        REQUIRE(std::fabs(lat - (0.3 + rootLatShift(0.25, 0.3) / 3600.0)) < 1e-10);
+        REQUIRE(std::fabs(lon - (0.25 + rootLonShift(0.25, 0.3) / 3600.0)) < 1e-10);
+
+        REQUIRE(grid.inverse(lon, lat));
+        REQUIRE(std::fabs(lon - 0.25) < 1e-11);
+        REQUIRE(std::fabs(lat - 0.3) < 1e-11);
+
+        // the finer child grid takes precedence
+        lon = 1.0;
+        lat = 1.0;
+        REQUIRE(grid.apply(lon, lat));
+        REQUIRE(lat == Approx(1.0 + 10.0 / 3600.0).epsilon(1e-12));
+        REQUIRE(lon == 1.0);
+
+        lon = 5.0;
+        lat = 5.0;
+        REQUIRE_FALSE(grid.apply(lon, lat));
+        REQUIRE(lon == 5.0);
+
+        std::vector<aePoint> points = {
+            aePoint(0.25, 0.3, 7.0, 8.0), aePoint(1.0, 1.0), aePoint(5.0, 5.0), aePoint(1.9, 0.1)
+        };
+        std::vector<aePoint> shifted(points.size());
+        REQUIRE(grid.apply(points.data(), shifted.data(), points.size()) == 3);
+        REQUIRE(shifted[0].z == 7.0);
+        REQUIRE(shifted[0].m == 8.0);
+        REQUIRE(shifted[1].y == Approx(1.0 + 10.0 / 3600.0));
+        REQUIRE(shifted[2].x == 5.0);
+
+        REQUIRE(grid.inverse(shifted.data(), shifted.data(), shifted.size()) == 3);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            REQUIRE(std::fabs(shifted[i].x - points[i].x) < 1e-11);
+            REQUIRE(std::fabs(shifted[i].y - points[i].y) < 1e-11);
+        }
+    }
+
+    SECTION("invalid files") {
+        std::vector<uint8_t> junk(256, 0);
+        REQUIRE_THROWS_AS(
+            aeGridShift(std::make_shared<aeMemoryInputStream>(junk.data(), junk.size())),
+            aeArgumentError);
+
+        GridWriter w = ntv2(false);
+        std::vector<uint8_t> truncated(w.data().begin(), w.data().end() - 300);
+        REQUIRE_THROWS_AS(
+            aeGridShift(std::make_shared<aeMemoryInputStream>(truncated.data(), truncated.size())),
+            aeArgumentError);
+
+        REQUIRE_THROWS_AS(aeGridShift("no such grid.gsb"), aeStreamError);
+    }
+
+    SECTION("malformed sub-grids") {
+        // a single row: 1" of latitude at 3" spacing, which cannot be
+        // interpolated
+        GridWriter thin(false);
+        overview(thin, 1);
+        subGrid(thin, "THIN", "NONE", 0.0, 1.0 / 3600.0, 0.01, 0.0, 3.0 / 3600.0,
+                rootLatShift, rootLonShift);
+        thin.text("END", "");
+        REQUIRE_THROWS_AS(aeGridShift(thin.stream()), aeArgumentError);
+
+        // a latitude spacing so fine the row count does not fit any integer
+        GridWriter w(false);
+        overview(w, 1);
+        subGrid(w, "ROOT", "NONE", 0.0, 2.0, 2.0, 0.0, 1.0, rootLatShift, rootLonShift);
+        w.text("END", "");
+
+        std::vector<uint8_t> data = w.data();
+        const double tiny = 1e-300;
+        std::size_t latInc = 11 * 16 + 8 * 16 + 8;
+        REQUIRE(data.size() > latInc + 8);
+        for (int k = 0; k < 8; ++k) {
+            // stored little-endian
+            uint64_t bits;
+            std::memcpy(&bits, &tiny, 8);
+            data[latInc + k] = uint8_t(bits >> (8 * k));
+        }
+        REQUIRE_THROWS_AS(
+            aeGridShift(std::make_shared<aeMemoryInputStream>(data.data(), data.size())),
+            aeArgumentError);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("GTX geoid grids", "[aeGrid]") {
+    GridWriter w = gtx();
+    aeGeoidGrid geoid(w.stream());
+
+    REQUIRE(geoid.height(-5.0, 50.0) == Approx(40.0));
+    REQUIRE(geoid.height(-4.5, 51.5) == Approx(41.75));
+    REQUIRE(geoid.height(355.5, 51.5) == Approx(41.75));
+    REQUIRE(std::isnan(geoid.height(0.0, 50.0)));
+    REQUIRE(std::isnan(geoid.height(-4.0, 49.0)));
+    REQUIRE(std::isnan(geoid.height(-3.5, 51.5)));
+
+    std::vector<aePoint> points = { aePoint(-4.5, 51.5), aePoint(-4.0, 50.0) };
+    double heights[2];
+    geoid.height(points.data(), heights, 2);
+    REQUIRE(heights[0] == Approx(41.75));
+    REQUIRE(heights[1] == Approx(40.5));
+
+    SECTION("invalid headers") {
+        std::vector<uint8_t> truncated(w.data().begin(), w.data().end() - 4);
+        REQUIRE_THROWS_AS(
+            aeGeoidGrid(std::make_shared<aeMemoryInputStream>(truncated.data(), truncated.size())),
+            aeArgumentError);
+
+        // 2^31 rows and columns, whose byte count wraps to zero in 64 bits
+        GridWriter huge(true);
+        huge.value(50.0);
+        huge.value(-5.0);
+        huge.value(1.0);
+        huge.value(1.0);
+        huge.value(std::numeric_limits<int32_t>::min());
+        huge.value(std::numeric_limits<int32_t>::min());
+        REQUIRE_THROWS_AS(aeGeoidGrid(huge.stream()), aeArgumentError);
+    }
+
+    SECTION("memory-mapped files") {
+        const char *filename = "test_aegrid.gtx";
+        {
+            std::ofstream out(filename, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(w.data().data()), w.data().size());
+        }
+
+        {
+            aeGeoidGrid mapped(filename);
+            REQUIRE(mapped.height(-4.5, 51.5) == Approx(41.75));
+            REQUIRE(mapped.extent().max.x == Approx(-3.0));
+        }
+
+        aeMappedInputStream stream(filename);
+        REQUIRE(stream.length() == int64_t(w.data().size()));
+        REQUIRE(stream.map() != nullptr);
+        uint8_t first[8];
+        REQUIRE(stream.read(first, 8) == 8);
+        REQUIRE(std::memcmp(first, w.data().data(), 8) == 0);
+        stream.close();
+
+        std::remove(filename);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("grid-based datums", "[aeGrid]") {
+    GridWriter n = ntv2(false);
+    std::shared_ptr<const aeGridShift> grid = std::make_shared<aeGridShift>(n.stream());
+    aeDatum datum("Test", 6378137.0, 1.0 / 298.257223563, grid);
+    const aeDatum &wgs84 = aeDatum::wgs84();
+
+    REQUIRE_FALSE(datum.isWGS84());
+    REQUIRE(aeDatumShift(datum, datum).isIdentity());
+
+    double lon = 0.25, lat = 0.3, h = 12.0;
+    aeDatumShift(datum, wgs84).apply(lon, lat, h);
+    REQUIRE(std::fabs(lat - (0.3 + rootLatShift(0.25, 0.3) / 3600.0)) < 1e-10);
+    REQUIRE(h == 12.0);
+
+    aeDatumShift(wgs84, datum).apply(lon, lat, h);
+    REQUIRE(std::fabs(lon - 0.25) < 1e-11);
+    REQUIRE(std::fabs(lat - 0.3) < 1e-11);
+
+    // through a Helmert datum, and in batches
+    std::vector<aePoint> points = { aePoint(0.25, 0.3), aePoint(1.0, 1.0) };
+    std::vector<aePoint> shifted(points.size());
+    aeDatumShift(datum, aeDatum::ed50()).apply(points.data(), shifted.data(), points.size());
+    aeDatumShift(aeDatum::ed50(), datum).apply(shifted.data(), shifted.data(), shifted.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        REQUIRE(std::fabs(shifted[i].x - points[i].x) < 1e-9);
+        REQUIRE(std::fabs(shifted[i].y - points[i].y) < 1e-9);
+        REQUIRE(std::fabs(shifted[i].z) < 1e-3);
+    }
+
+    GridWriter g = gtx();
+    aeVerticalDatum vdatum("Test geoid", std::make_shared<aeGeoidGrid>(g.stream()), 1.0);
+    REQUIRE(vdatum.offset(-4.5, 51.5) == Approx(41.75));
+    REQUIRE(vdatum.offset(10.0, 10.0) == 1.0);
+
+    REQUIRE_THROWS_AS(aeDatum("Test", 6378137.0, 0.0, nullptr), aeArgumentError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -8,6 +8,66 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 TEST_CASE("layers", "[aeLayer]") {
+    aeLayer layer;
+
+    SECTION("empty layer extent") {
+        CHECK(layer.extent().isEmpty());
+    }
+
+    SECTION("layer extent") {
+        std::vector<aeGeometry> geometries(5000, aeGeometry(aeGeometry::LineString));
+
+        for (std::size_t i = 0; i < geometries.size(); ++i) {
+            geometries[i].points().push_back({double(i), 0.0});
+            geometries[i].points().push_back({0.0, -double(i)});
+            layer.features().push_back({aeObjectID(i), &geometries[i], nullptr});
+        }
+
+        // Shared geometries are only measured once
+        layer.features().push_back({aeObjectID(5000), &geometries[0], nullptr});
+
+        for (unsigned int threads : { 1u, 4u }) {
+            aeExtent e = layer.extent(threads);
+            CHECK(e.min.x == 0.0);
+            CHECK(e.max.x == 4999.0);
+            CHECK(e.min.y == -4999.0);
+            CHECK(e.max.y == 0.0);
+        }
+    }
+
+    SECTION("packed geometries") {
+        aeGeometry *line = new aeGeometry(aeGeometry::LineString);
+        line->points().push_back({1.0, 2.0});
+        line->points().push_back({3.0, -4.0});
+
+        aeGeometry point(aeGeometry::Type(aeGeometry::Point | aeGeometry::HasZ));
+        point.points().push_back({-5.0, 6.0, 7.0});
+
+        layer.features().push_back({aeObjectID(1), line, nullptr});
+        layer.features().push_back({aeObjectID(2), line, nullptr});
+        layer.features().push_back({aeObjectID(3), nullptr, nullptr});
+        layer.pack();
+        delete line;
+
+        REQUIRE(layer.packedGeometry(0) != nullptr);
+        CHECK(layer.packedGeometry(0) == layer.packedGeometry(1));
+        CHECK(layer.packedGeometry(0)->points().stride() == 2);
+        CHECK(layer.packedGeometry(2) == nullptr);
+        CHECK(layer.features()[0].geometry == nullptr);
+        CHECK(layer.geometry(1).points()[1] == aePoint(3.0, -4.0));
+        CHECK(layer.geometry(2).points().empty());
+
+        // packed and unpacked features mix
+        layer.features().push_back({aeObjectID(4), &point, nullptr});
+        aeExtent e = layer.extent();
+        CHECK(e.min.x == -5.0);
+        CHECK(e.max.y == 6.0);
+        CHECK(e.max.z == 7.0);
+
+        layer.pack();
+        CHECK(layer.packedGeometry(3)->points().stride() == 3);
+        CHECK(layer.extent().max.z == 7.0);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3,7 +3,16 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "catch.hpp"
+#include "aeexcept.hpp"
 #include "aemedian.hpp"
+#include "aestream.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -355,6 +364,257 @@ TEST_CASE("median calculation", "[aeMedian]") {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("median bulk update", "[aeMedian]") {
+    std::vector<double> data(200000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = double(i);
+    }
+    std::shuffle(data.begin(), data.end(), std::mt19937(49));
+
+    aeMedian single;
+    for (double x : data) {
+        single.update(x);
+    }
+
+    // uneven runs straddle the level boundaries
+    aeMedian bulk;
+    std::size_t i = 0;
+    for (std::size_t run = 1; i < data.size(); run = run * 3 % 29 + 1) {
+        std::size_t n = std::min(run, data.size() - i);
+        bulk.update(data.data() + i, n);
+        i += n;
+    }
+
+    REQUIRE(bulk.count() == data.size());
+    REQUIRE(bulk.median() == single.median());
+    REQUIRE(std::fabs(bulk.median() / data.size() - 0.5) < 0.05);
+
+    // copies carry on from the same levels
+    aeMedian copied(single), assigned;
+    assigned = single;
+    copied.update(data.data(), data.size());
+    assigned.update(data.begin(), data.end());
+    REQUIRE(copied.count() == 2 * data.size());
+    REQUIRE(assigned.count() == copied.count());
+    REQUIRE(assigned.median() == copied.median());
+
+    // pointer ranges dispatch to the bulk path
+    aeMedian range(data.data(), data.data() + data.size());
+    REQUIRE(range.count() == data.size());
+    REQUIRE(range.median() == single.median());
+
+    aeMedianT<double, unsigned long long, 5> md5(data.begin(), data.end());
+    REQUIRE(md5.count() == data.size());
+    REQUIRE(std::fabs(md5.median() / data.size() - 0.5) < 0.1);
+
+    aeMedianT<float, unsigned long long, 2> md2;
+    md2.update(3.0f).update(1.0f).update(2.0f);
+    REQUIRE(md2.median() == 3.0f);
+
+    // large bases sort their levels without unrolling
+    aeMedianT<double, unsigned long long, 45> md45(data.begin(), data.end());
+    aeMedianT<double, unsigned long long, 51> md51;
+    md51.update(data.data(), data.size());
+    REQUIRE(md45.count() == data.size());
+    REQUIRE(md51.count() == data.size());
+    REQUIRE(std::fabs(md45.median() / data.size() - 0.5) < 0.05);
+    REQUIRE(std::fabs(md51.median() / data.size() - 0.5) < 0.05);
+
+    // NaN values are skipped by every update path
+    std::vector<double> gappy;
+    for (int i = 0; i < 13; ++i) {
+        gappy.push_back((i % 3 == 0) ? aeNaN : double(i));
+    }
+    aeMedian single13(gappy.begin(), gappy.end()), bulk13;
+    bulk13.update(gappy.data(), gappy.size());
+    REQUIRE(single13.count() == 8);
+    REQUIRE(bulk13.count() == 8);
+    REQUIRE(single13.median() == 7.0);
+    REQUIRE(bulk13.median() == 7.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("median merging", "[aeMedian]") {
+    // a shuffled permutation of 0 .. n - 1, so each value is its own rank
+    const std::size_t n = 300000;
+    std::vector<double> data(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        data[i] = double(i);
+    }
+    std::shuffle(data.begin(), data.end(), std::mt19937(50));
+
+    // five full levels of base 11: at least 6^5 values either side
+    const double bound = 6.0 * 6.0 * 6.0 * 6.0 * 6.0;
+
+    aeMedian single(data.begin(), data.end());
+
+    SECTION("pieces") {
+        aeMedian merged;
+        std::size_t begin = 0;
+        for (std::size_t size = 7; begin < n; size = size * 5 % 40009 + 1) {
+            std::size_t end = std::min(begin + size, n);
+            merged.merge(aeMedian(data.begin() + begin, data.begin() + end));
+            begin = end;
+        }
+
+        REQUIRE(merged.count() == n);
+        REQUIRE(merged.median() >= bound);
+        REQUIRE(merged.median() <= n - 1 - bound);
+        REQUIRE(std::fabs(merged.median() / n - 0.5) < 0.05);
+
+        aeMedian empty;
+        REQUIRE(empty.merge(aeMedian()).count() == 0);
+        REQUIRE(std::isnan(empty.median()));
+        REQUIRE(empty.merge(single).median() == single.median());
+
+        empty.merge(empty);
+        REQUIRE(empty.count() == 2 * n);
+        REQUIRE(std::fabs(empty.median() / n - 0.5) < 0.05);
+    }
+
+    SECTION("threads") {
+        aeMedian one(data.begin(), data.end(), 1);
+        REQUIRE(one.count() == n);
+        REQUIRE(one.median() == single.median());
+
+        aeMedian four(data.data(), data.data() + n, 4);
+        REQUIRE(four.count() == n);
+        REQUIRE(four.median() >= bound);
+        REQUIRE(four.median() <= n - 1 - bound);
+        REQUIRE(std::fabs(four.median() / n - 0.5) < 0.05);
+
+        // the bulk path over pointers matches the per-value path chunk by chunk
+        aeMedian iterated(data.begin(), data.end(), 4);
+        REQUIRE(iterated.count() == n);
+        REQUIRE(iterated.median() == four.median());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("quantile sketch", "[aeQuantileSketch]") {
+    // a shuffled permutation of 0 .. n - 1, so the exact rank of a value is
+    // the value itself
+    const std::size_t n = 1000000;
+    std::vector<double> data(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        data[i] = double(i);
+    }
+    std::shuffle(data.begin(), data.end(), std::mt19937(48));
+
+    const double q[] = { 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99 };
+    const std::size_t nq = sizeof(q) / sizeof(q[0]);
+
+    SECTION("empty sketch") {
+        aeQuantileSketch qs;
+
+        REQUIRE(qs.count() == 0);
+        CHECK(std::isnan(qs.quantile(0.5)));
+        CHECK(std::isnan(qs.cdf(1.0)));
+        CHECK(std::isnan(qs.min()));
+
+        REQUIRE_THROWS_AS(aeQuantileSketch(4), aeArgumentError);
+        REQUIRE_THROWS_AS(qs.quantile(1.5), aeArgumentError);
+    }
+
+    SECTION("small data set is exact") {
+        double values[] = { 9, 7, 5, 5, 4, 4, 4, 2 };
+        aeQuantileSketch qs(std::begin(values), std::end(values));
+
+        REQUIRE(qs.count() == 8);
+        CHECK(qs.quantile(0.0) == 2.0);
+        CHECK(qs.quantile(0.5) == 4.0);
+        CHECK(qs.quantile(1.0) == 9.0);
+        CHECK(qs.cdf(4.0) == Approx(0.5));
+        CHECK(qs.cdf(1.0) == 0.0);
+
+        qs.update(aeNaN);
+        CHECK(qs.count() == 8);
+    }
+
+    SECTION("rank error on a million values") {
+        aeQuantileSketch qs;
+        for (double x : data) {
+            qs.update(x);
+        }
+
+        REQUIRE(qs.count() == n);
+        CHECK(qs.min() == 0.0);
+        CHECK(qs.max() == double(n - 1));
+        CHECK(qs.size() < 1000);
+
+        double values[nq];
+        qs.quantiles(q, values, nq);
+        for (std::size_t i = 0; i < nq; ++i) {
+            CAPTURE(q[i]);
+            REQUIRE(std::fabs(values[i] / n - q[i]) < 0.02);
+            REQUIRE(values[i] == qs.quantile(q[i]));
+            REQUIRE(std::fabs(qs.cdf(values[i]) - q[i]) < 0.02);
+        }
+
+        aeQuantileSketch bulk(200);
+        bulk.update(data.data(), data.size());
+        REQUIRE(bulk.count() == n);
+        for (std::size_t i = 0; i < nq; ++i) {
+            REQUIRE(std::fabs(bulk.quantile(q[i]) / n - q[i]) < 0.02);
+        }
+    }
+
+    SECTION("merged sketches") {
+        aeQuantileSketch merged;
+        const std::size_t parts = 8;
+
+        for (std::size_t p = 0; p < parts; ++p) {
+            aeQuantileSketch part;
+            part.update(data.data() + p * n / parts, n / parts);
+            merged.merge(part);
+        }
+
+        REQUIRE(merged.count() == n);
+        CHECK(merged.min() == 0.0);
+        CHECK(merged.max() == double(n - 1));
+        for (std::size_t i = 0; i < nq; ++i) {
+            CAPTURE(q[i]);
+            REQUIRE(std::fabs(merged.quantile(q[i]) / n - q[i]) < 0.02);
+        }
+
+        merged.merge(merged);
+        REQUIRE(merged.count() == 2 * n);
+        REQUIRE(std::fabs(merged.quantile(0.5) / n - 0.5) < 0.02);
+    }
+
+    SECTION("encoding") {
+        aeQuantileSketch qs;
+        qs.update(data.data(), 100000);
+
+        std::vector<uint8_t> buffer;
+        qs.encode(buffer);
+
+        aeQuantileSketch copy(8);
+        REQUIRE(copy.decode(buffer.data(), buffer.size()) == buffer.size());
+        REQUIRE(copy.k() == qs.k());
+        REQUIRE(copy.count() == qs.count());
+        REQUIRE(copy.size() == qs.size());
+        for (std::size_t i = 0; i < nq; ++i) {
+            REQUIRE(copy.quantile(q[i]) == qs.quantile(q[i]));
+        }
+
+        // the copy carries on like the original
+        copy.update(data.data() + 100000, 100000);
+        REQUIRE(copy.count() == 200000);
+        REQUIRE(std::fabs(copy.quantile(0.5) / n - 0.5) < 0.02);
+
+        REQUIRE_THROWS_AS(copy.decode(buffer.data(), buffer.size() - 1), aeStreamError);
+        REQUIRE_THROWS_AS(copy.decode(buffer.data(), 3), aeStreamError);
+
+        aeQuantileSketchT<float> floats;
+        REQUIRE_THROWS_AS(floats.decode(buffer.data(), buffer.size()), aeStreamError);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aeoverlay.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    void addSquare(aeGeometry &g, double x, double y, double size) {
+        g.parts().push_back(g.points().size());
+        g.points().push_back({x, y});
+        g.points().push_back({x + size, y});
+        g.points().push_back({x + size, y + size});
+        g.points().push_back({x, y + size});
+    }
+
+    aeGeometry square(double x, double y, double size) {
+        aeGeometry g = { aeGeometry::Polygon };
+        addSquare(g, x, y, size);
+        return g;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("polygon overlay", "[aeOverlay]") {
+    aeOverlay overlay;
+
+    SECTION("overlapping squares") {
+        aeGeometry a = square(0.0, 0.0, 2.0);
+        aeGeometry b = square(1.0, 1.0, 2.0);
+
+        aeGeometry u = overlay.unite(a, b);
+        CHECK(u.type() == aeGeometry::MultiPolygon);
+        CHECK(u.partCount() == 1);
+        CHECK(u.points().size() == 8);
+        CHECK(u.area() == Approx(7.0));
+
+        aeGeometry i = overlay.intersect(a, b);
+        CHECK(i.partCount() == 1);
+        CHECK(i.points().size() == 4);
+        CHECK(i.area() == Approx(1.0));
+
+        aeGeometry d = overlay.subtract(a, b);
+        CHECK(d.partCount() == 1);
+        CHECK(d.points().size() == 6);
+        CHECK(d.area() == Approx(3.0));
+
+        aeGeometry x = overlay.compute(a, b, aeOverlay::SymmetricDifference);
+        CHECK(x.partCount() == 2);
+        CHECK(x.area() == Approx(6.0));
+    }
+
+    SECTION("disjoint squares") {
+        aeGeometry a = square(0.0, 0.0, 1.0);
+        aeGeometry b = square(3.0, 0.0, 1.0);
+
+        CHECK(overlay.unite(a, b).partCount() == 2);
+        CHECK(overlay.intersect(a, b).points().empty());
+        CHECK(overlay.subtract(a, b).area() == Approx(1.0));
+    }
+
+    SECTION("shared edge") {
+        aeGeometry a = square(0.0, 0.0, 1.0);
+        aeGeometry b = square(1.0, 0.0, 1.0);
+
+        aeGeometry u = overlay.unite(a, b);
+        CHECK(u.partCount() == 1);
+        CHECK(u.points().size() == 4);
+        CHECK(u.area() == Approx(2.0));
+
+        CHECK(overlay.intersect(a, b).points().empty());
+        CHECK(overlay.subtract(a, b).area() == Approx(1.0));
+    }
+
+    SECTION("touching at a vertex") {
+        aeGeometry a = square(0.0, 0.0, 1.0);
+        aeGeometry b = square(1.0, 1.0, 1.0);
+
+        aeGeometry u = overlay.unite(a, b);
+        CHECK(u.partCount() == 2);
+        CHECK(u.area() == Approx(2.0));
+    }
+
+    SECTION("hole") {
+        aeGeometry a = square(0.0, 0.0, 4.0);
+        aeGeometry b = square(1.0, 1.0, 2.0);
+
+        aeGeometry d = overlay.subtract(a, b);
+        REQUIRE(d.partCount() == 2);
+        CHECK(d.area() == Approx(12.0));
+
+        // Filling the hole again restores the square
+        aeGeometry u = overlay.unite(d, b);
+        CHECK(u.partCount() == 1);
+        CHECK(u.area() == Approx(16.0));
+
+        // A square straddling the hole boundary
+        aeGeometry c = square(2.0, 2.0, 4.0);
+        CHECK(overlay.intersect(d, c).area() == Approx(3.0));
+        CHECK(overlay.unite(d, c).area() == Approx(12.0 + 16.0 - 3.0));
+    }
+
+    SECTION("holes touching their shell") {
+        // the hole is listed first and touches each side of the square in
+        // turn; both its edges at the touching vertex are an ulp long, so
+        // neither that vertex nor their midpoints tell inside from outside
+        const double ulp = std::ldexp(1.0, -50);
+
+        for (int turns = 0; turns < 4; ++turns) {
+            aeGeometry g = { aeGeometry::MultiPolygon };
+            g.parts().push_back(0);
+            g.points().push_back({4.0, 6.0});
+            g.points().push_back({4.0 + ulp, 6.0 - ulp});
+            g.points().push_back({7.0, 5.0});
+            g.points().push_back({7.0, 7.0});
+            g.points().push_back({4.0 + ulp, 6.0 + ulp});
+            for (int k = 0; k < turns; ++k) {
+                for (aePoint &p : g.points()) {
+                    p = aePoint(12.0 - p.y, p.x);
+                }
+            }
+            addSquare(g, 4.0, 4.0, 4.0);
+
+            CHECK(overlay.normalize(g).area() == Approx(16.0 - 3.0));
+            CHECK(overlay.subtract(g, square(20.0, 20.0, 1.0)).area() == Approx(16.0 - 3.0));
+        }
+    }
+
+    SECTION("many holes") {
+        aeGeometry a = { aeGeometry::MultiPolygon };
+        addSquare(a, 0.0, 0.0, 10.0);
+        addSquare(a, 20.0, 0.0, 10.0);
+
+        aeGeometry b = { aeGeometry::MultiPolygon };
+        for (int i = 0; i < 4; ++i) {
+            addSquare(b, 1.0 + 2.0 * i, 1.0, 1.0);
+            addSquare(b, 21.0 + 2.0 * i, 5.0, 1.0);
+        }
+
+        aeGeometry d = overlay.subtract(a, b);
+        REQUIRE(d.partCount() == 10);
+        CHECK(d.area() == Approx(200.0 - 8.0));
+
+        // each shell is followed by the four holes inside it
+        for (unsigned int shell : { 0u, 5u }) {
+            double x0 = d.points()[d.partBegin(shell)].x;
+            for (unsigned int k = d.partBegin(shell); k < d.partEnd(shell); ++k) {
+                x0 = std::min(x0, d.points()[k].x);
+            }
+            for (unsigned int h = shell + 1; h < shell + 5; ++h) {
+                for (unsigned int k = d.partBegin(h); k < d.partEnd(h); ++k) {
+                    CHECK(d.points()[k].x > x0);
+                    CHECK(d.points()[k].x < x0 + 10.0);
+                }
+            }
+        }
+
+        // an island inside one of the holes becomes a shell of its own
+        aeGeometry u = overlay.unite(d, square(1.25, 1.25, 0.5));
+        CHECK(u.partCount() == 11);
+        CHECK(u.area() == Approx(200.0 - 8.0 + 0.25));
+    }
+
+    SECTION("clockwise input") {
+        aeGeometry a = { aeGeometry::Polygon };
+        a.points().push_back({0.0, 0.0});
+        a.points().push_back({0.0, 2.0});
+        a.points().push_back({2.0, 2.0});
+        a.points().push_back({2.0, 0.0});
+        a.points().push_back({0.0, 0.0});
+
+        CHECK(overlay.normalize(a).area() == Approx(4.0));
+        CHECK(overlay.intersect(a, square(1.0, 1.0, 2.0)).area() == Approx(1.0));
+    }
+
+    SECTION("not a polygon") {
+        aeGeometry line = { aeGeometry::LineString };
+        line.points().push_back({0.0, 0.0});
+        line.points().push_back({1.0, 1.0});
+
+        CHECK_THROWS_AS(overlay.unite(line, square(0.0, 0.0, 1.0)), aeArgumentError);
+    }
+}
+
+TEST_CASE("cascaded union", "[aeOverlay]") {
+    aeOverlay overlay;
+    std::vector<aeGeometry> squares;
+
+    SECTION("overlapping grid") {
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                squares.push_back(square(i * 1.0, j * 1.0, 1.5));
+            }
+        }
+
+        aeGeometry u = overlay.uniteAll(squares.begin(), squares.end());
+        CHECK(u.partCount() == 1);
+        CHECK(u.points().size() == 4);
+        CHECK(u.area() == Approx(8.5 * 8.5));
+    }
+
+    SECTION("disjoint squares") {
+        for (int i = 0; i < 16; ++i) {
+            squares.push_back(square(i * 2.0, (i % 4) * 2.0, 1.0));
+        }
+
+        aeGeometry u = overlay.uniteAll(squares);
+        CHECK(u.partCount() == 16);
+        CHECK(u.area() == Approx(16.0));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aepacked.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    struct Dimensions {
+        int xy = 0, xyz = 0, xym = 0, xyzm = 0;
+        double sum = 0.0;
+
+        void operator () (const aePointXY &p) { ++xy; sum += p.x + p.y; }
+        void operator () (const aePointXYZ &p) { ++xyz; sum += p.x + p.y + p.z; }
+        void operator () (const aePointXYM &p) { ++xym; sum += p.x + p.y + p.m; }
+        void operator () (const aePoint &p) { ++xyzm; sum += p.x + p.y + p.z + p.m; }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("packed points", "[aePackedPoints]") {
+    SECTION("plain 2D geometry") {
+        aeGeometry g = { aeGeometry::LineString };
+        g.points().push_back({1.0, 2.0});
+        g.points().push_back({3.0, 4.0});
+
+        aePackedPoints p(g);
+        CHECK(p.layout() == aePackedPoints::XY);
+        CHECK(p.stride() == 2);
+        CHECK(p.size() == 2);
+        CHECK(p.data()[3] == 4.0);
+        CHECK(p[1] == aePoint(3.0, 4.0));
+
+        Dimensions d;
+        p.forEach(d);
+        CHECK(d.xy == 2);
+        CHECK(d.xyzm == 0);
+        CHECK(d.sum == Approx(10.0));
+
+        // temporaries, including lambdas, are accepted too
+        double sum = 0.0;
+        p.forEach([&sum](const aePoint &q) { sum += q.x + q.y; });
+        CHECK(sum == Approx(10.0));
+        p.forEach(Dimensions());
+    }
+
+    SECTION("measured geometry") {
+        aeGeometry g = { aeGeometry::Type(aeGeometry::LineString | aeGeometry::HasM) };
+        g.points().push_back({1.0, 2.0, 0.0, 7.0});
+        g.points().push_back({3.0, 4.0, 0.0, 8.0});
+
+        aePackedPoints p(g);
+        CHECK(p.layout() == aePackedPoints::XYM);
+        CHECK(p.hasM());
+        CHECK(!p.hasZ());
+        CHECK(p[0] == aePoint(1.0, 2.0, 0.0, 7.0));
+
+        Dimensions d;
+        p.forEach(d);
+        CHECK(d.xym == 2);
+        CHECK(d.sum == Approx(25.0));
+
+        std::vector<aePoint> points;
+        p.unpack(points);
+        CHECK(points == g.points());
+    }
+
+    SECTION("building") {
+        aePackedPoints p(true, true);
+        p.push_back(aePoint(1.0, 2.0, 3.0, 4.0));
+        p.push_back(aePoint(5.0, 6.0, 7.0, 8.0));
+
+        CHECK(p.layout() == aePackedPoints::XYZM);
+        CHECK(p.size() == 2);
+        CHECK(p[1].m == 8.0);
+
+        aePackedPoints q(true, false);
+        q.push_back(aePoint(1.0, 2.0, 3.0, 4.0));
+        CHECK(q[0] == aePoint(1.0, 2.0, 3.0));
+    }
+
+    SECTION("packed geometries") {
+        aeGeometry g = { aeGeometry::MultiLineString };
+        g.points().push_back({1.0, 2.0});
+        g.points().push_back({3.0, -4.0});
+        g.parts().push_back(0);
+        g.points().push_back({-5.0, 6.0});
+        g.points().push_back({7.0, 8.0});
+        g.parts().push_back(2);
+
+        aePackedGeometry packed(g);
+        CHECK(packed.points().stride() == 2);
+        CHECK(packed.parts() == g.parts());
+        CHECK(packed.extent().min == g.extent().min);
+        CHECK(packed.extent().max == g.extent().max);
+
+        aeGeometry h = packed.unpack();
+        CHECK(h.type() == g.type());
+        CHECK(h.parts() == g.parts());
+        CHECK(h.points() == g.points());
+
+        // a curve's extent reaches beyond its points
+        aeGeometry arc = { aeGeometry::CircularString };
+        arc.points().push_back({1.0, 0.0});
+        arc.points().push_back({0.0, 1.0});
+        arc.points().push_back({-1.0, 0.0});
+        CHECK(aePackedGeometry(arc).extent().max.y == Approx(arc.extent().max.y));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aeparallel.hpp"
+
+#include <stdexcept>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("parallel reduction", "[aeParallel]") {
+    SECTION("thread count") {
+        CHECK(aeThreadCount(8, 100, 1000) == 1);
+        CHECK(aeThreadCount(8, 3000, 1000) == 3);
+        CHECK(aeThreadCount(2, 1000000, 1000) == 2);
+        CHECK(aeThreadCount(0, 1000000, 1000) >= 1);
+    }
+
+    SECTION("sum in order") {
+        auto sum = [](std::size_t begin, std::size_t end) {
+            unsigned long long s = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                s += i;
+            }
+            return s;
+        };
+        auto add = [](unsigned long long &a, const unsigned long long &b) {
+            a += b;
+        };
+
+        for (unsigned int threads = 1; threads <= 5; ++threads) {
+            CHECK(aeParallelReduce<unsigned long long>(100000, 10, threads, sum, add) ==
+                  100000ull * 99999ull / 2);
+        }
+        CHECK(aeParallelReduce<unsigned long long>(0, 10, 4, sum, add) == 0);
+    }
+
+    SECTION("exceptions") {
+        auto fail = [](std::size_t begin, std::size_t) -> int {
+            if (begin > 0) {
+                throw std::runtime_error("chunk");
+            }
+            return 0;
+        };
+        auto add = [](int &a, const int &b) { a += b; };
+
+        CHECK_THROWS_AS(aeParallelReduce<int>(100, 10, 4, fail, add), std::runtime_error);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,11 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cinttypes>
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 std::ostream &operator << (std::ostream &os, const aePointT<T> &p) {
     return os << '<' << p.x << ',' << p.y << ',' << p.z << ',' << p.m << '>';
@@ -33,6 +38,19 @@ TEST_CASE("point primitive", "[aePoint]") {
         CHECK(b.equals(a, 1.0));
     }
 
+    SECTION("integer equality at the limits") {
+        const int32_t lo = std::numeric_limits<int32_t>::lowest();
+        const int32_t hi = std::numeric_limits<int32_t>::max();
+        aePointT<int32_t> p(lo, 0), q(hi, 0), r(lo + 1, 0);
+
+        CHECK(p != q);
+        CHECK(q != p);
+        CHECK(!p.equals(q, hi));
+        CHECK(p.equals(r, 1));
+        CHECK(!p.equals(r, 0));
+        CHECK(!p.equals(p, -1));
+    }
+
     SECTION("scalar operations") {
         CHECK(a + b == b);
         CHECK(a + c == c);
@@ -58,6 +76,61 @@ TEST_CASE("point primitive", "[aePoint]") {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("compact points", "[aePoint]") {
+    SECTION("sizes") {
+        CHECK(sizeof(aePointXY) == 2 * sizeof(double));
+        CHECK(sizeof(aePointXYZ) == 3 * sizeof(double));
+        CHECK(sizeof(aePointXYM) == 3 * sizeof(double));
+    }
+
+    SECTION("arithmetic") {
+        aePointXY a(1.0, 2.0), b(3.0, 5.0);
+
+        CHECK((a + b) == aePointXY(4.0, 7.0));
+        CHECK((b - a) == aePointXY(2.0, 3.0));
+        CHECK((a * 2.0) == aePointXY(2.0, 4.0));
+        CHECK((2.0 * a) == aePointXY(2.0, 4.0));
+        CHECK((b / 2.0) == aePointXY(1.5, 2.5));
+        CHECK(-a == aePointXY(-1.0, -2.0));
+        CHECK(dot(a, b) == Approx(13.0));
+        CHECK(det(a, b) == Approx(-1.0));
+
+        aePointXYZ c(1.0, 2.0, 3.0);
+        c += aePointXYZ(1.0, 1.0, 1.0);
+        c *= 2.0;
+        CHECK(c == aePointXYZ(4.0, 6.0, 8.0));
+        CHECK(dot(c, c) == Approx(116.0));
+        CHECK(cross(aePointXYZ(1.0, 0.0, 0.0), aePointXYZ(0.0, 1.0, 0.0)) ==
+              aePointXYZ(0.0, 0.0, 1.0));
+        CHECK(aePoint(cross(c, aePointXYZ(1.0, 2.0, 3.0))) ==
+              cross(aePoint(c), aePoint(1.0, 2.0, 3.0)));
+
+        // M is a measure, not a dimension
+        aePointXYM m(1.0, 2.0, 10.0);
+        CHECK(dot(m, m) == Approx(5.0));
+        CHECK((m - m) == aePointXYM());
+    }
+
+    SECTION("conversions") {
+        aePoint p(1.0, 2.0, 3.0, 4.0);
+
+        aePointXY xy(p);
+        aePointXYZ xyz(p);
+        aePointXYM xym(p);
+        CHECK(xyz.z == 3.0);
+        CHECK(xym.m == 4.0);
+
+        aePoint q = xy;
+        CHECK(q == aePoint(1.0, 2.0));
+        q = xyz;
+        CHECK(q == aePoint(1.0, 2.0, 3.0));
+        q = xym;
+        CHECK(q == aePoint(1.0, 2.0, 0.0, 4.0));
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
 ////////////////////////////////////////////////////////////////////////////////
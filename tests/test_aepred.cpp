@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aepred.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("orientation predicate", "[aePredicates][orient2d]") {
+    SECTION("simple cases") {
+        aePoint a(0.0, 0.0), b(1.0, 0.0), c(0.0, 1.0), d(2.0, 0.0);
+
+        CHECK(aeOrient2d(a, b, c) > 0.0);
+        CHECK(aeOrient2d(a, c, b) < 0.0);
+        CHECK(aeOrient2d(a, b, d) == 0.0);
+    }
+
+    SECTION("near-collinear points") {
+        // Naive evaluation gets the sign wrong for many of these points; the
+        // exact sign is determined by which side of y = x the point lies on.
+        aePoint b(12.0, 12.0), c(24.0, 24.0);
+        double ulp = std::ldexp(1.0, -53);
+
+        for (int i = 0; i < 64; ++i) {
+            for (int j = 0; j < 64; ++j) {
+                aePoint a(0.5 + i * ulp, 0.5 + j * ulp);
+                double o = aeOrient2d(a, b, c);
+                int sign = (o > 0.0) - (o < 0.0);
+                CAPTURE(i);
+                CAPTURE(j);
+                REQUIRE(sign == (j > i) - (j < i));
+            }
+        }
+    }
+
+    SECTION("single precision") {
+        aePointT<float> a(0.0f, 0.0f), b(1.0f, 0.0f), c(0.0f, 1.0f);
+
+        CHECK(aeOrient2d(a, b, c) > 0.0);
+        CHECK(aeOrient2d(b, a, c) < 0.0);
+    }
+}
+
+TEST_CASE("in-circle predicate", "[aePredicates][incircle]") {
+    aePoint a(0.0, -1.0), b(1.0, 0.0), c(0.0, 1.0);
+
+    SECTION("simple cases") {
+        CHECK(aeInCircle(a, b, c, aePoint(0.0, 0.0)) > 0.0);
+        CHECK(aeInCircle(a, b, c, aePoint(2.0, 0.0)) < 0.0);
+        CHECK(aeInCircle(a, b, c, aePoint(-1.0, 0.0)) == 0.0);
+    }
+
+    SECTION("nearly cocircular points") {
+        double ulp = std::ldexp(1.0, -52);
+
+        CHECK(aeInCircle(a, b, c, aePoint(-1.0 + ulp, 0.0)) > 0.0);
+        CHECK(aeInCircle(a, b, c, aePoint(-1.0 - ulp, 0.0)) < 0.0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
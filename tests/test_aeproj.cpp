@@ -4,13 +4,354 @@
 
 #include "catch.hpp"
 #include "aeproj.hpp"
+#include "aedatum.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
 TEST_CASE("projections", "[aeProjection]") {
+    SECTION("web mercator") {
+        aeProjection mercator(aeWKID::WebMercator);
+
+        aePoint p = mercator.project(aePoint(-0.1275, 51.5072));
+        REQUIRE(p.x == Approx(-14193.235076));
+        REQUIRE(p.y == Approx(6711506.705401));
+
+        p = mercator.project(aePoint(180.0, 85.051128779806589));
+        REQUIRE(p.x == Approx(20037508.342789244));
+        REQUIRE(p.y == Approx(20037508.342789244));
+
+        p = mercator.project(aePoint(0.0, 90.0));
+        REQUIRE(p.y == Approx(20037508.342789244));
+
+        for (double lat = -85.0; lat <= 85.0; lat += 5.0) {
+            for (double lon = -180.0; lon <= 180.0; lon += 15.0) {
+                aePoint q = mercator.unproject(mercator.project(aePoint(lon, lat, 1, 2)));
+                REQUIRE(std::abs(q.x - lon) < 1e-9);
+                REQUIRE(std::abs(q.y - lat) < 1e-9);
+                REQUIRE(q.z == 1);
+                REQUIRE(q.m == 2);
+            }
+        }
+    }
+
+    SECTION("web mercator pixels") {
+        aeProjection pixels(aeWKID::WebMercatorPixels);
+
+        aePoint p = pixels.project(aePoint(0.0, 0.0));
+        REQUIRE(p.x == Approx(128.0));
+        REQUIRE(p.y == Approx(128.0));
+
+        p = pixels.project(aePoint(-180.0, 85.051128779806589));
+        REQUIRE(std::abs(p.x) < 1e-9);
+        REQUIRE(std::abs(p.y) < 1e-9);
+
+        p = pixels.unproject(aePoint(256.0, 256.0));
+        REQUIRE(p.x == Approx(180.0));
+        REQUIRE(p.y == Approx(-85.051128779806589));
+
+        p = pixels.unproject(pixels.project(aePoint(12.5, -33.25)));
+        REQUIRE(p.x == Approx(12.5));
+        REQUIRE(p.y == Approx(-33.25));
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//  EOF
+
+TEST_CASE("batch projection", "[aeProjection]") {
+    aeProjection mercator(aeWKID::WebMercator);
+
+    std::vector<aePoint> points;
+    for (int i = 0; i < 100; ++i) {
+        points.push_back(aePoint(-179.0 + 3.5 * i, -80.0 + 1.6 * i, i, -i));
+    }
+
+    SECTION("point arrays match single points") {
+        std::vector<aePoint> out(points.size());
+        mercator.project(points.data(), out.data(), points.size());
+
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            aePoint q = mercator.project(points[i]);
+            REQUIRE(out[i].x == q.x);
+            REQUIRE(out[i].y == q.y);
+            REQUIRE(out[i].z == points[i].z);
+            REQUIRE(out[i].m == points[i].m);
+        }
+
+        std::vector<aePoint> inPlace(points);
+        mercator.project(inPlace);
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            REQUIRE(inPlace[i] == out[i]);
+        }
+    }
+
+    SECTION("coordinate arrays match single points") {
+        std::vector<double> x, y;
+        for (const aePoint &p : points) {
+            x.push_back(p.x);
+            y.push_back(p.y);
+        }
+
+        std::vector<double> ox(x.size()), oy(y.size());
+        mercator.project(x.data(), y.data(), ox.data(), oy.data(), x.size());
+        mercator.project(x.data(), y.data(), x.data(), y.data(), x.size());
+
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            aePoint q = mercator.project(points[i]);
+            REQUIRE(ox[i] == q.x);
+            REQUIRE(oy[i] == q.y);
+            REQUIRE(x[i] == q.x);
+            REQUIRE(y[i] == q.y);
+        }
+    }
+
+    SECTION("inverse arrays match single points") {
+        std::vector<aePoint> projected(points.size()), out(points.size());
+        mercator.project(points.data(), projected.data(), points.size());
+        mercator.unproject(projected.data(), out.data(), points.size());
+
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            aePoint q = mercator.unproject(projected[i]);
+            REQUIRE(out[i].x == q.x);
+            REQUIRE(out[i].y == q.y);
+            REQUIRE(std::abs(out[i].x - points[i].x) < 1e-9);
+            REQUIRE(std::abs(out[i].y - points[i].y) < 1e-9);
+        }
+    }
+
+    SECTION("null transform copies") {
+        aeProjection identity;
+        std::vector<aePoint> out(points.size());
+        identity.project(points.data(), out.data(), points.size());
+        REQUIRE(out == points);
+        identity.unproject(out);
+        REQUIRE(out == points);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
+TEST_CASE("coordinate transforms", "[aeCoordinateTransform]") {
+    std::vector<aePoint> points;
+    for (int i = 0; i < 60; ++i) {
+        points.push_back(aePoint(400000.0 + 1000.0 * i, 4000000.0 + 50000.0 * i, i, -i));
+    }
+
+    SECTION("match chained projections") {
+        aeProjection utm(aeUTM(31, true)), mercator(aeWKID::WebMercator);
+        aeCoordinateTransform transform(aeUTM(31, true), aeWKID::WebMercator);
+
+        std::vector<aePoint> out(points.size());
+        transform.apply(points.data(), out.data(), points.size());
+
+        std::vector<double> x, y;
+        for (const aePoint &p : points) {
+            x.push_back(p.x);
+            y.push_back(p.y);
+        }
+        transform.apply(x.data(), y.data(), x.data(), y.data(), x.size());
+
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            aePoint q = mercator.project(utm.unproject(points[i]));
+            REQUIRE(std::abs(out[i].x - q.x) < 1e-6);
+            REQUIRE(std::abs(out[i].y - q.y) < 1e-6);
+            REQUIRE(out[i].z == points[i].z);
+            REQUIRE(out[i].m == points[i].m);
+            REQUIRE(transform(points[i]) == out[i]);
+            REQUIRE(x[i] == out[i].x);
+            REQUIRE(y[i] == out[i].y);
+        }
+    }
+
+    SECTION("datum shifts") {
+        aeProjection ed50(aeUTM(30, true)), wgs84(aeUTM(30, true));
+        ed50.setDatum(aeDatum::ed50());
+        aeCoordinateTransform transform(ed50, wgs84);
+
+        for (const aePoint &p : points) {
+            aePoint q = wgs84.project(ed50.unproject(p));
+            aePoint r = transform(p);
+            REQUIRE(std::abs(r.x - q.x) < 1e-6);
+            REQUIRE(std::abs(r.y - q.y) < 1e-6);
+            REQUIRE(std::abs(r.z - q.z) < 1e-6);
+        }
+    }
+
+    SECTION("axis order") {
+        aeCoordinateTransform transform(
+            aeWKID::NullTransform, aeWKID::WebMercator,
+            aeCoordinateTransform::SwapSourceAxes
+        );
+        aePoint p = transform(aePoint(51.5072, -0.1275));
+        REQUIRE(p.x == Approx(-14193.235076));
+        REQUIRE(p.y == Approx(6711506.705401));
+
+        aeCoordinateTransform back(
+            aeWKID::WebMercator, aeWKID::NullTransform,
+            aeCoordinateTransform::SwapTargetAxes
+        );
+        p = back(p);
+        REQUIRE(p.x == Approx(51.5072));
+        REQUIRE(p.y == Approx(-0.1275));
+    }
+
+    SECTION("cache") {
+        aeCoordinateTransform::clearCache();
+        REQUIRE(aeCoordinateTransform::cacheSize() == 0);
+
+        aeCoordinateTransform a(aeUTM(31, true), aeWKID::WebMercator);
+        aeCoordinateTransform b(aeUTM(31, true), aeWKID::WebMercator);
+        REQUIRE(aeCoordinateTransform::cacheSize() == 1);
+        REQUIRE(&a.source() == &b.source());
+
+        aeCoordinateTransform c(aeUTM(31, true), aeWKID::WebMercator,
+            aeCoordinateTransform::SwapTargetAxes);
+        REQUIRE(aeCoordinateTransform::cacheSize() == 2);
+
+        std::vector< std::vector<aePoint> > results(8, std::vector<aePoint>(points.size()));
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < results.size(); ++t) {
+            threads.push_back(std::thread([t, &points, &results]() {
+                aeCoordinateTransform transform(
+                    aeUTM(31 + t % 2, true), aeWKID::WebMercator
+                );
+                transform.apply(points.data(), results[t].data(), points.size());
+            }));
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(aeCoordinateTransform::cacheSize() == 3);
+        for (unsigned int t = 2; t < results.size(); ++t) {
+            REQUIRE(results[t] == results[t % 2]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("approximate projections", "[aeProjection]") {
+    aeProjection exact(aeWKID::WebMercator), approximate(aeWKID::WebMercator);
+    approximate.setApproximate(true);
+    REQUIRE(approximate.isApproximate());
+    REQUIRE(!exact.isApproximate());
+
+    SECTION("forward error") {
+        double worst = 0.0, worst80 = 0.0;
+        for (double lat = -85.06; lat <= 85.06; lat += 0.0037) {
+            aePoint p(12.25, lat);
+            aePoint a = approximate.project(p), e = exact.project(p);
+            REQUIRE(a.x == e.x);
+            worst = std::max(worst, std::abs(a.y - e.y));
+            if (std::abs(lat) < 80.0) {
+                worst80 = std::max(worst80, std::abs(a.y - e.y));
+            }
+        }
+        REQUIRE(worst < 2e-3);
+        REQUIRE(worst80 < 1e-4);
+    }
+
+    SECTION("inverse error") {
+        for (double y = -20037508.0; y <= 20037508.0; y += 9876.5) {
+            aePoint p(1000.0, y);
+            aePoint a = approximate.unproject(p), e = exact.unproject(p);
+            REQUIRE(a.x == e.x);
+            REQUIRE(std::abs(a.y - e.y) < 1e-9);
+        }
+    }
+
+    SECTION("non-finite input") {
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        aePoint a = approximate.project(aePoint(12.25, nan));
+        REQUIRE(std::isnan(a.y));
+        a = approximate.unproject(aePoint(1000.0, nan));
+        REQUIRE(std::isnan(a.y));
+
+        a = approximate.project(aePoint(12.25, inf));
+        aePoint e = exact.project(aePoint(12.25, inf));
+        REQUIRE(std::abs(a.y - e.y) < 2e-3);
+        a = approximate.unproject(aePoint(1000.0, -inf));
+        e = exact.unproject(aePoint(1000.0, -inf));
+        REQUIRE(std::abs(a.y - e.y) < 1e-9);
+    }
+
+    SECTION("pixels and transforms") {
+        aeProjection pixels(aeWKID::WebMercatorPixels);
+        pixels.setApproximate(true);
+        aePoint p = pixels.project(aePoint(-0.1275, 51.5072));
+        aePoint q = aeProjection(aeWKID::WebMercatorPixels).project(aePoint(-0.1275, 51.5072));
+        REQUIRE(std::abs(p.x - q.x) < 1e-9);
+        REQUIRE(std::abs(p.y - q.y) < 1e-8);
+
+        aeCoordinateTransform transform(aeProjection(), approximate);
+        p = transform(aePoint(-0.1275, 51.5072));
+        REQUIRE(p == approximate.project(aePoint(-0.1275, 51.5072)));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("grid transforms", "[aeGridTransform]") {
+    aeCoordinateTransform transform(aeUTM(31, true), aeWKID::WebMercator);
+    aeExtent extent(aePoint(400000.0, 4500000.0), aePoint(600000.0, 5500000.0));
+    aeGridTransform grid(transform, extent, 32, 64);
+
+    REQUIRE(grid.maxError() > 0.0);
+    REQUIRE(grid.maxError() < 20.0);
+
+    // bilinear error falls with the square of the cell size
+    aeGridTransform finer(transform, extent, 64, 128);
+    REQUIRE(finer.maxError() < grid.maxError() / 3.0);
+
+    std::vector<aePoint> points;
+    for (int i = 0; i < 500; ++i) {
+        points.push_back(aePoint(
+            400000.0 + 200000.0 * ((i * 37) % 101) / 100.0,
+            4500000.0 + 1000000.0 * ((i * 53) % 103) / 102.0,
+            i
+        ));
+    }
+
+    std::vector<aePoint> out(points.size());
+    grid.apply(points.data(), out.data(), points.size());
+
+    std::vector<double> x, y;
+    for (const aePoint &p : points) {
+        x.push_back(p.x);
+        y.push_back(p.y);
+    }
+    grid.apply(x.data(), y.data(), x.data(), y.data(), x.size());
+
+    for (unsigned int i = 0; i < points.size(); ++i) {
+        aePoint e = transform(points[i]);
+        REQUIRE(std::hypot(out[i].x - e.x, out[i].y - e.y) <= 1.5 * grid.maxError() + 1e-6);
+        REQUIRE(out[i].z == points[i].z);
+        REQUIRE(x[i] == out[i].x);
+        REQUIRE(y[i] == out[i].y);
+    }
+
+    // outside the grid the exact transformation is used
+    aePoint outside(300000.0, 5000000.0);
+    REQUIRE(grid(outside) == transform(outside));
+
+    // nodes are exact
+    aePoint node(400000.0 + 200000.0 * 5 / 32.0, 4500000.0 + 1000000.0 * 7 / 64.0);
+    REQUIRE(std::abs(grid(node).x - transform(node).x) < 1e-6);
+    REQUIRE(std::abs(grid(node).y - transform(node).y) < 1e-6);
+
+    REQUIRE_THROWS_AS(aeGridTransform(transform, extent, 0, 4), aeArgumentError);
+    REQUIRE_THROWS_AS(aeGridTransform(transform, aeExtent(), 4, 4), aeArgumentError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aequant.hpp"
+#include "aeexcept.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("coordinate quantization", "[aeQuantization]") {
+    SECTION("round trip") {
+        aeQuantization q(aePoint(0.001, 0.001, 0.01, 1.0), aePoint(500000.0, 4000000.0));
+
+        aePoint p(512345.6789, 4123456.7891, 12.346, 7.0);
+        aeFixedPoint f = q.quantize(p);
+
+        CHECK(f.x == 12345679);
+        CHECK(f.y == 123456789);
+        CHECK(f.z == 1235);
+        CHECK(f.m == 7);
+
+        aePoint r = q.dequantize(f);
+        CHECK(std::abs(r.x - p.x) <= 0.0005);
+        CHECK(std::abs(r.y - p.y) <= 0.0005);
+        CHECK(std::abs(r.z - p.z) <= 0.005);
+    }
+
+    SECTION("out of range coordinates saturate") {
+        aeQuantization q;
+
+        CHECK(q.quantize(aePoint(1e12, -1e12)).x == std::numeric_limits<int32_t>::max());
+        CHECK(q.quantize(aePoint(1e12, -1e12)).y == std::numeric_limits<int32_t>::lowest());
+    }
+
+    SECTION("from extent") {
+        aeExtent e(aePoint(-180.0, -90.0, 0.0, 0.0), aePoint(180.0, 90.0, 0.0, 0.0));
+        aeQuantization q = aeQuantization::fromExtent(e, 1e-7);
+
+        CHECK(q.offset().x == Approx(0.0));
+        CHECK(q.quantize(aePoint(180.0, 90.0)).x == 1800000000);
+        CHECK(q.quantize(aePoint(180.0, 90.0)).y == 900000000);
+
+        CHECK_THROWS_AS(aeQuantization::fromExtent(e, 1e-8), aeArgumentError);
+        CHECK_THROWS_AS(aeQuantization::fromExtent(e, 0.0), aeArgumentError);
+    }
+
+    SECTION("geometry") {
+        aeGeometry g = { aeGeometry::Polygon };
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({2.5, 0.0});
+        g.points().push_back({2.5, 2.5});
+        g.points().push_back({0.0, 2.5});
+
+        aeQuantization q(aePoint(0.5, 0.5, 1.0, 1.0), aePoint());
+        aeFixedGeometry f = q.quantize(g);
+
+        REQUIRE(f.points().size() == 4);
+        CHECK(f.type() == aeFixedGeometry::Polygon);
+        CHECK(f.points()[2].x == 5);
+        CHECK(f.area() == 25.0);
+
+        aeGeometry r = q.dequantize(f);
+        CHECK(r.area() == Approx(g.area()));
+    }
+
+    SECTION("compound curve keeps its part types") {
+        aeGeometry g = { aeGeometry::CompoundCurve };
+        g.partTypes().push_back(aeGeometry::CircularString);
+        g.partTypes().push_back(aeGeometry::LineString);
+        g.parts().push_back(0);
+        g.parts().push_back(3);
+        g.points().push_back({1.0, 0.0});
+        g.points().push_back({0.0, 1.0});
+        g.points().push_back({-1.0, 0.0});
+        g.points().push_back({-1.0, 0.0});
+        g.points().push_back({1.0, 0.0});
+
+        aeQuantization q(aePoint(0.001, 0.001, 1.0, 1.0), aePoint());
+        aeFixedGeometry f = q.quantize(g);
+
+        REQUIRE(f.partTypes().size() == 2);
+        CHECK(f.partType(0) == aeFixedGeometry::CircularString);
+        CHECK(f.partType(1) == aeFixedGeometry::LineString);
+
+        aeGeometry r = q.dequantize(f);
+
+        REQUIRE(r.partTypes().size() == 2);
+        CHECK(r.partType(0) == aeGeometry::CircularString);
+        CHECK(r.partType(1) == aeGeometry::LineString);
+        CHECK(r.area() == Approx(aePi / 2.0).epsilon(1e-3));
+
+        std::shared_ptr<const aeGeometry> a = g.linearize(0.01);
+        std::shared_ptr<const aeGeometry> b = r.linearize(0.01);
+        REQUIRE(b->points().size() == a->points().size());
+        CHECK(b->points().size() > 5);
+        CHECK(b->area() == Approx(a->area()).epsilon(1e-3));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,12 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
 TEST_CASE("statistics calculation", "[aeStatistics]") {
     static const double EPSILON = 0.0000000001;
 
@@ -423,6 +429,217 @@ TEST_CASE("statistics calculation", "[aeStatistics]") {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("bulk statistics", "[aeStatistics]") {
+    std::mt19937 rng(46);
+    std::normal_distribution<double> dist(1000.0, 3.0);
+
+    std::vector<double> data(300007);
+    for (double &x : data) {
+        x = dist(rng);
+    }
+
+    aeStatistics serial;
+    for (double x : data) {
+        serial.update(x);
+    }
+
+    SECTION("blocks") {
+        aeStatistics st(data.begin(), data.end());
+        aeStatistics bulk(data.data(), data.size(), 1);
+
+        REQUIRE(bulk.count() == data.size());
+        CHECK(bulk.min() == serial.min());
+        CHECK(bulk.max() == serial.max());
+        CHECK(bulk.mean() == Approx(serial.mean()).epsilon(1e-12));
+        CHECK(bulk.variance() == Approx(serial.variance()).epsilon(1e-9));
+        CHECK(bulk.skewness() == Approx(serial.skewness()).epsilon(1e-6));
+        CHECK(bulk.kurtosis() == Approx(serial.kurtosis()).epsilon(1e-6));
+        CHECK(st.variance() == Approx(serial.variance()).epsilon(1e-9));
+
+        // pointer ranges take the same path
+        aeStatistics range(data.data(), data.data() + data.size());
+        CHECK(range.mean() == bulk.mean());
+        CHECK(range.variance() == bulk.variance());
+    }
+
+    SECTION("threads") {
+        aeStatistics one(data.data(), data.size(), 1);
+        aeStatistics four(data.data(), data.size(), 4);
+
+        REQUIRE(four.count() == data.size());
+        CHECK(four.min() == one.min());
+        CHECK(four.max() == one.max());
+        CHECK(four.mean() == Approx(one.mean()).epsilon(1e-12));
+        CHECK(four.variance() == Approx(one.variance()).epsilon(1e-9));
+        CHECK(four.kurtosis() == Approx(one.kurtosis()).epsilon(1e-6));
+    }
+
+    SECTION("merging into empty statistics") {
+        aeStatistics st;
+        st.update(data.data() + 10, 5, 1);
+        CHECK(st.min() == *std::min_element(data.begin() + 10, data.begin() + 15));
+        CHECK(st.max() == *std::max_element(data.begin() + 10, data.begin() + 15));
+
+        aeStatistics empty;
+        st.update(empty);
+        CHECK(st.count() == 5);
+        empty.update(data.data(), 0);
+        CHECK(empty.count() == 0);
+        CHECK(std::isnan(empty.mean()));
+    }
+
+    SECTION("float") {
+        std::vector<float> floats(data.begin(), data.begin() + 5000);
+        aeStatisticsT<float> st(floats.data(), floats.size());
+        CHECK(st.mean() == Approx(serial.mean()).epsilon(1e-3));
+        CHECK(st.stdev() == Approx(3.0).epsilon(0.05));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("weighted and removable statistics", "[aeStatistics]") {
+    static const double EPSILON = 0.0000000001;
+
+    SECTION("weights act as frequencies") {
+        aeStatistics weighted, repeated;
+        double values[] = { 2, 4, 5, 7, 9 };
+        double weights[] = { 1, 3, 2, 1, 1 };
+
+        for (int i = 0; i < 5; ++i) {
+            weighted.update(values[i], weights[i]);
+            for (int k = 0; k < int(weights[i]); ++k) {
+                repeated.update(values[i]);
+            }
+        }
+
+        weighted.update(100.0, 0.0);
+        weighted.update(100.0, -1.0);
+
+        REQUIRE(weighted.count() == 5);
+        CHECK(weighted.weight() == 8.0);
+        CHECK(weighted.min() == 2.0);
+        CHECK(weighted.max() == 9.0);
+        CHECK(weighted.mean() == Approx(repeated.mean()).epsilon(EPSILON));
+        CHECK(weighted.popVariance() == Approx(4.0).epsilon(EPSILON));
+        CHECK(weighted.variance() == Approx(repeated.variance()).epsilon(EPSILON));
+        CHECK(weighted.skewness() == Approx(0.656250).epsilon(EPSILON));
+        CHECK(weighted.kurtosis() == Approx(-0.218750).epsilon(EPSILON));
+
+        // fractional weights scale out of the mean
+        aeStatistics halves;
+        for (int i = 0; i < 5; ++i) {
+            halves.update(values[i], weights[i] * 0.5);
+        }
+        CHECK(halves.mean() == Approx(5.0).epsilon(EPSILON));
+        CHECK(halves.popVariance() == Approx(4.0).epsilon(EPSILON));
+
+        // the sample variance needs a total weight above 1
+        aeStatistics light;
+        light.update(1.0, 0.3);
+        light.update(2.0, 0.2);
+        CHECK(light.popVariance() == Approx(0.24).epsilon(EPSILON));
+        CHECK(std::isnan(light.variance()));
+        CHECK(std::isnan(light.stdev()));
+    }
+
+    SECTION("remove") {
+        std::mt19937 rng(47);
+        std::uniform_real_distribution<double> dist(-10.0, 30.0);
+
+        std::vector<double> data(200);
+        for (double &x : data) {
+            x = dist(rng);
+        }
+
+        aeStatistics st(data.data(), data.size(), 1);
+        for (std::size_t i = 0; i < 120; ++i) {
+            st.remove(data[i]);
+        }
+
+        aeStatistics rest(data.data() + 120, 80, 1);
+        REQUIRE(st.count() == 80);
+        CHECK(st.mean() == Approx(rest.mean()).epsilon(1e-10));
+        CHECK(st.variance() == Approx(rest.variance()).epsilon(1e-10));
+        CHECK(st.skewness() == Approx(rest.skewness()).epsilon(1e-8));
+        CHECK(st.kurtosis() == Approx(rest.kurtosis()).epsilon(1e-8));
+
+        // removing merged statistics undoes the merge
+        aeStatistics head(data.data(), 50, 1), all(data.data(), data.size(), 1);
+        all.remove(head);
+        aeStatistics tail(data.data() + 50, 150, 1);
+        CHECK(all.mean() == Approx(tail.mean()).epsilon(1e-12));
+        CHECK(all.variance() == Approx(tail.variance()).epsilon(1e-10));
+        CHECK(all.kurtosis() == Approx(tail.kurtosis()).epsilon(1e-8));
+
+        // weighted removal
+        aeStatistics w;
+        w.update(1.0, 2.0).update(4.0, 1.5).update(6.0, 0.5);
+        w.remove(4.0, 1.5);
+        CHECK(w.weight() == Approx(2.5));
+        CHECK(w.mean() == Approx(2.0));
+
+        w.remove(1.0, 2.0).remove(6.0, 0.5);
+        CHECK(w.count() == 0);
+        CHECK(std::isnan(w.mean()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("window statistics", "[aeStatistics]") {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+
+    const std::size_t size = 37;
+    aeWindowStatistics window(size);
+
+    CHECK(window.count() == 0);
+    CHECK(std::isnan(window.min()));
+    CHECK(std::isnan(window.mean()));
+
+    std::vector<double> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = dist(rng) + 1000.0 * std::sin(i * 0.01);
+        window.update(data[i]);
+
+        std::size_t first = (i + 1 > size) ? i + 1 - size : 0;
+        aeStatistics exact(data.data() + first, i + 1 - first, 1);
+
+        REQUIRE(window.count() == exact.count());
+        REQUIRE(window.min() == exact.min());
+        REQUIRE(window.max() == exact.max());
+        REQUIRE(window.mean() == Approx(exact.mean()).epsilon(1e-9));
+        if (i > 0) {
+            REQUIRE(window.variance() == Approx(exact.variance()).epsilon(1e-6));
+        }
+    }
+
+    window.clear();
+    window.update(5.0);
+    CHECK(window.count() == 1);
+    CHECK(window.max() == 5.0);
+
+    // a NaN spoils the moments only while it is in the window
+    window.clear();
+    window.update(aeNaN);
+    for (std::size_t i = 0; i + 1 < size; ++i) {
+        window.update(data[i]);
+        REQUIRE(std::isnan(window.mean()));
+    }
+    CHECK(window.min() == *std::min_element(data.begin(), data.begin() + size - 1));
+
+    window.update(data[size - 1]);
+    aeStatistics exact(data.data(), size, 1);
+    CHECK(window.count() == size);
+    CHECK(window.mean() == Approx(exact.mean()).epsilon(1e-9));
+    CHECK(window.variance() == Approx(exact.variance()).epsilon(1e-6));
+
+    REQUIRE_THROWS_AS(aeWindowStatistics(0), aeArgumentError);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //  EOF
 ////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,33 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 TEST_CASE("stream", "[aeStream]") {
+    SECTION("memory streams") {
+        uint8_t buffer[8] = { 0 };
+
+        aeMemoryOutputStream out(buffer, sizeof(buffer));
+        aeOutputStream &o = out;
+
+        o.write(uint16_t(0x0102));
+        o.write(uint16_t(0x0304));
+        CHECK(out.tell() == 4);
+        CHECK(out.write(buffer, 8) == 4);
+        CHECK_THROWS_AS(o.write(uint8_t(0)), aeStreamError);
+
+        aeMemoryInputStream in(buffer, sizeof(buffer));
+        aeInputStream &i = in;
+
+        uint16_t a = 0, b = 0;
+        i.read(a);
+        i.read(b);
+        CHECK(a == 0x0102);
+        CHECK(b == 0x0304);
+        CHECK(in.tell() == 4);
+
+        uint8_t rest[8];
+        CHECK(in.read(rest, 8) == 4);
+        CHECK(rest[0] == buffer[0]);
+        CHECK_THROWS_AS(i.read(a), aeStreamError);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aesweep.hpp"
+
+#include <set>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("sweep and prune", "[aeSweep]") {
+    aeSweep sweep;
+
+    sweep.insert({0.0, 0.0}, {2.0, 2.0});
+    sweep.insert({1.0, 3.0}, {3.0, 1.0});
+    sweep.insert({5.0, 5.0}, {6.0, 6.0});
+    sweep.insert({2.0, 2.0}, {4.0, 0.0});
+    REQUIRE(sweep.size() == 4);
+
+    SECTION("all overlapping pairs") {
+        std::set< std::pair<unsigned int, unsigned int> > pairs;
+
+        CHECK_FALSE(sweep.run([&](unsigned int i, unsigned int j) {
+            pairs.insert(std::make_pair(std::min(i, j), std::max(i, j)));
+            return false;
+        }));
+
+        CHECK(pairs.size() == 3);
+        CHECK(pairs.count(std::make_pair(0u, 1u)) == 1);
+        CHECK(pairs.count(std::make_pair(0u, 3u)) == 1);
+        CHECK(pairs.count(std::make_pair(1u, 3u)) == 1);
+    }
+
+    SECTION("early exit") {
+        unsigned int calls = 0;
+
+        CHECK(sweep.run([&](unsigned int, unsigned int) {
+            ++calls;
+            return true;
+        }));
+
+        CHECK(calls == 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
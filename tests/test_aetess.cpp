@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aetess.hpp"
+#include "aeexcept.hpp"
+#include "aepred.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    double triangleArea(const aeGeometry &g, const aeTessellator::Indices &t) {
+        double area = 0.0;
+        for (std::size_t i = 0; i < t.size(); i += 3) {
+            const aePoint &a = g.points()[t[i]];
+            const aePoint &b = g.points()[t[i+1]];
+            const aePoint &c = g.points()[t[i+2]];
+            area += 0.5 * det(b - a, c - a);
+        }
+        return area;
+    }
+
+    bool allCounterclockwise(const aeGeometry &g, const aeTessellator::Indices &t) {
+        for (std::size_t i = 0; i < t.size(); i += 3) {
+            if (aeOrient2d(g.points()[t[i]], g.points()[t[i+1]], g.points()[t[i+2]]) <= 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("polygon triangulation", "[aeTessellator]") {
+    aeTessellator tess;
+    aeTessellator::Indices t;
+    aeGeometry g = { aeGeometry::Polygon };
+
+    SECTION("unit square") {
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({1.0, 0.0});
+        g.points().push_back({1.0, 1.0});
+        g.points().push_back({0.0, 1.0});
+
+        tess.triangulate(g, t);
+        REQUIRE(t.size() == 6);
+        CHECK(allCounterclockwise(g, t));
+        CHECK(triangleArea(g, t) == Approx(1.0));
+    }
+
+    SECTION("clockwise closed ring") {
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({0.0, 2.0});
+        g.points().push_back({1.0, 1.0});
+        g.points().push_back({2.0, 2.0});
+        g.points().push_back({2.0, 0.0});
+        g.points().push_back({0.0, 0.0});
+
+        tess.triangulate(g, t);
+        REQUIRE(t.size() == 9);
+        CHECK(allCounterclockwise(g, t));
+        CHECK(triangleArea(g, t) == Approx(3.0));
+    }
+
+    SECTION("comb") {
+        // Teeth pointing up and down produce split and merge vertices
+        for (int i = 0; i < 8; ++i) {
+            g.points().push_back({double(2 * i), 0.0});
+            g.points().push_back({double(2 * i + 1), -3.0});
+        }
+        g.points().push_back({16.0, 0.0});
+        g.points().push_back({16.0, 4.0});
+        for (int i = 7; i >= 0; --i) {
+            g.points().push_back({double(2 * i + 1), 7.0});
+            g.points().push_back({double(2 * i), 4.0});
+        }
+
+        tess.triangulate(g, t);
+        REQUIRE(t.size() == 3 * (g.points().size() - 2));
+        CHECK(allCounterclockwise(g, t));
+        CHECK(triangleArea(g, t) == Approx(std::abs(g.area())));
+    }
+
+    SECTION("square with holes") {
+        g.points().push_back({0.0, 0.0});
+        g.points().push_back({10.0, 0.0});
+        g.points().push_back({10.0, 10.0});
+        g.points().push_back({0.0, 10.0});
+
+        g.parts().push_back(0);
+        g.parts().push_back(4);
+
+        g.points().push_back({2.0, 2.0});
+        g.points().push_back({4.0, 2.0});
+        g.points().push_back({4.0, 4.0});
+        g.points().push_back({2.0, 4.0});
+
+        g.parts().push_back(8);
+
+        g.points().push_back({6.0, 5.0});
+        g.points().push_back({8.0, 7.0});
+        g.points().push_back({6.0, 9.0});
+
+        tess.triangulate(g, t);
+        REQUIRE(t.size() == 3 * (11 - 2 + 2 * 2));
+        CHECK(allCounterclockwise(g, t));
+        CHECK(triangleArea(g, t) == Approx(100.0 - 4.0 - 4.0));
+    }
+
+    SECTION("multipolygon with nested rings") {
+        g = aeGeometry(aeGeometry::MultiPolygon);
+
+        const double squares[][4] = {
+            { 0.0, 0.0, 10.0, 10.0 },   // shell
+            { 3.0, 3.0, 7.0, 7.0 },     // hole in it
+            { 4.0, 4.0, 6.0, 6.0 },     // island in the hole
+            { 20.0, 0.0, 22.0, 2.0 },   // separate shell
+        };
+
+        for (const double *s : squares) {
+            g.parts().push_back(g.points().size());
+            g.points().push_back({s[0], s[1]});
+            g.points().push_back({s[2], s[1]});
+            g.points().push_back({s[2], s[3]});
+            g.points().push_back({s[0], s[3]});
+        }
+
+        tess.triangulate(g, t);
+        CHECK(allCounterclockwise(g, t));
+        CHECK(triangleArea(g, t) == Approx(100.0 - 16.0 + 4.0 + 4.0));
+    }
+
+    SECTION("star") {
+        for (int i = 0; i < 40; ++i) {
+            double a = 2.0 * aePi * i / 40.0;
+            double r = (i % 2) ? 1.0 : 3.0 + (i % 3);
+            g.points().push_back({r * std::cos(a), r * std::sin(a)});
+        }
+
+        tess.triangulate(g, t);
+        REQUIRE(t.size() == 3 * 38);
+        CHECK(allCounterclockwise(g, t));
+        CHECK(triangleArea(g, t) == Approx(g.area()));
+    }
+
+    SECTION("not a polygon") {
+        aeGeometry line = { aeGeometry::LineString };
+        CHECK_THROWS_AS(tess.triangulate(line, t), aeArgumentError);
+    }
+}
+
+TEST_CASE("TIN generation", "[aeTessellator][TIN]") {
+    aeTessellator tess;
+    aeGeometry g = { aeGeometry::Polygon };
+
+    g.points().push_back({0.0, 0.0});
+    g.points().push_back({3.0, 0.0});
+    g.points().push_back({3.0, 1.0});
+    g.points().push_back({2.0, 2.0});
+    g.points().push_back({1.0, 2.0});
+    g.points().push_back({0.0, 1.0});
+
+    aeGeometry tin = tess.tessellate(g);
+
+    REQUIRE(tin.type() == aeGeometry::TIN);
+    REQUIRE(tin.partCount() == 4);
+    CHECK(tin.points().size() == 12);
+    CHECK(tin.area() == Approx(5.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
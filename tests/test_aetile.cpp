@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aeexcept.hpp"
+#include "aeproj.hpp"
+#include "aetile.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Morton codes", "[aeTile]") {
+    REQUIRE(aeMortonEncode(0, 0) == 0);
+    REQUIRE(aeMortonEncode(1, 0) == 1);
+    REQUIRE(aeMortonEncode(0, 1) == 2);
+    REQUIRE(aeMortonEncode(3, 5) == 0x27);
+    REQUIRE(aeMortonEncode(0xffffffff, 0) == 0x5555555555555555ull);
+    REQUIRE(aeMortonEncode(0, 0xffffffff) == 0xaaaaaaaaaaaaaaaaull);
+
+    std::mt19937 rng(43);
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t x = rng(), y = rng(), dx, dy;
+        aeMortonDecode(aeMortonEncode(x, y), dx, dy);
+        REQUIRE(dx == x);
+        REQUIRE(dy == y);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Tiles", "[aeTile]") {
+    SECTION("quadkeys") {
+        aeTile t(3, 5, 3);
+        REQUIRE(t.quadkey() == "213");
+        REQUIRE(aeTile::fromQuadkey("213") == t);
+        REQUIRE(aeTile::fromQuadkey("") == aeTile());
+        REQUIRE(std::stoull(t.quadkey(), nullptr, 4) == t.morton());
+
+        REQUIRE_THROWS_AS(aeTile::fromQuadkey("0124"), aeArgumentError);
+        REQUIRE_THROWS_AS(aeTile::fromQuadkey(std::string(32, '0')), aeArgumentError);
+    }
+
+    SECTION("hierarchy") {
+        aeTile t(3, 5, 3);
+        REQUIRE(t.parent() == aeTile(1, 2, 2));
+        REQUIRE(t.child(2) == aeTile(6, 11, 4));
+        REQUIRE(t.child(2).quadkey() == "2132");
+        REQUIRE(aeTile().parent() == aeTile());
+    }
+
+    SECTION("points") {
+        REQUIRE(aeTile::at(0.0, 0.0, 0) == aeTile(0, 0, 0));
+        REQUIRE(aeTile::at(0.0, 0.0, 1) == aeTile(1, 1, 1));
+        REQUIRE(aeTile::at(-0.1276, 51.5072, 10) == aeTile(511, 340, 10));
+
+        // clamped to the edges of the square
+        REQUIRE(aeTile::at(180.0, -90.0, 4) == aeTile(15, 15, 4));
+        REQUIRE(aeTile::at(-200.0, 89.0, 4) == aeTile(0, 0, 4));
+
+        REQUIRE_THROWS_AS(aeTile::at(0.0, 0.0, 32), aeArgumentError);
+    }
+
+    SECTION("extents") {
+        const double edge = 20037508.342789244;
+
+        aeExtent e = aeTile().extent();
+        REQUIRE(e.min.x == Approx(-edge));
+        REQUIRE(e.max.y == Approx(edge));
+
+        e = aeTile(1, 0, 1).extent(aeWKID::WGS84);
+        REQUIRE(e.min.x == Approx(0.0));
+        REQUIRE(e.max.x == Approx(180.0));
+        REQUIRE(std::fabs(e.min.y) < 1e-12);
+        REQUIRE(e.max.y == Approx(85.0511287798066));
+
+        e = aeTile(3, 5, 3).extent(aeWKID::WebMercatorPixels);
+        REQUIRE(e.min.x == 96.0);
+        REQUIRE(e.max.y == 192.0);
+
+        // the tile's own centre is inside it
+        aeExtent g = aeTile(511, 340, 10).extent(aeWKID::WGS84);
+        REQUIRE(aeTile::at((g.min.x + g.max.x) * 0.5, (g.min.y + g.max.y) * 0.5, 10) ==
+                aeTile(511, 340, 10));
+
+        REQUIRE_THROWS_AS(aeTile().extent(aeUTM(31, true)), aeArgumentError);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Tile covers", "[aeTile]") {
+    SECTION("extents") {
+        std::vector<aeTile> tiles = aeTileCover(aeExtent(aePoint(-10.0, -10.0), aePoint(10.0, 10.0)), 2);
+        REQUIRE(tiles.size() == 4);
+        REQUIRE(tiles[0] == aeTile(1, 1, 2));
+        REQUIRE(tiles[3] == aeTile(2, 2, 2));
+
+        REQUIRE(aeTileCover(aeExtent(), 5).empty());
+        REQUIRE(aeTileCover(aeExtent(aePoint(-180.0, -90.0), aePoint(180.0, 90.0)), 3).size() == 64);
+    }
+
+    SECTION("lines") {
+        aeGeometry line(aeGeometry::LineString);
+        line.points().push_back(aePoint(-170.0, 0.1));
+        line.points().push_back(aePoint(170.0, 0.1));
+
+        std::vector<aeTile> tiles = aeTileCover(line, 3);
+        REQUIRE(tiles.size() == 8);
+        for (const aeTile &t : tiles) {
+            REQUIRE(t.y == 3);
+        }
+
+        // a diagonal crosses one tile more than the steps in x and y
+        line.points()[0] = aePoint(-179.0, 84.0);
+        line.points()[1] = aePoint(179.0, -84.0);
+        REQUIRE(aeTileCover(line, 4).size() >= 16);
+        REQUIRE(aeTileCover(line, 4).size() <= 31);
+    }
+
+    SECTION("polygons") {
+        aeGeometry square(aeGeometry::Polygon);
+        square.points().push_back(aePoint(-50.0, -50.0));
+        square.points().push_back(aePoint(50.0, -50.0));
+        square.points().push_back(aePoint(50.0, 50.0));
+        square.points().push_back(aePoint(-50.0, 50.0));
+        square.points().push_back(aePoint(-50.0, -50.0));
+
+        std::vector<aeTile> byGeometry = aeTileCover(square, 5);
+        std::vector<aeTile> byExtent = aeTileCover(square.extent(), 5);
+        REQUIRE(byGeometry == byExtent);
+
+        // a ring with a hole leaves the hole's interior tiles out
+        square.parts().push_back(0);
+        square.parts().push_back(5);
+        square.points().push_back(aePoint(-30.0, -30.0));
+        square.points().push_back(aePoint(-30.0, 30.0));
+        square.points().push_back(aePoint(30.0, 30.0));
+        square.points().push_back(aePoint(30.0, -30.0));
+        square.points().push_back(aePoint(-30.0, -30.0));
+
+        std::vector<aeTile> holed = aeTileCover(square, 5);
+        REQUIRE(holed.size() < byExtent.size());
+        REQUIRE(std::find(holed.begin(), holed.end(), aeTile::at(0.0, 0.0, 5)) == holed.end());
+        REQUIRE(std::find(holed.begin(), holed.end(), aeTile::at(-40.0, 0.0, 5)) != holed.end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Batch tile assignment", "[aeTile]") {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> lon(-180.0, 180.0), lat(-85.0, 85.0);
+
+    std::vector<aePoint> points(1000);
+    std::vector<double> xs(points.size()), ys(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = aePoint(lon(rng), lat(rng));
+        xs[i] = points[i].x;
+        ys[i] = points[i].y;
+    }
+
+    for (uint32_t zoom : { 0u, 7u, 18u, 31u }) {
+        std::vector<uint64_t> ids = aeTileIDs(points, zoom);
+        std::vector<uint64_t> arrays(points.size());
+        aeTileIDs(xs.data(), ys.data(), xs.size(), zoom, arrays.data());
+
+        REQUIRE(ids == arrays);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            REQUIRE(aeTile::fromMorton(ids[i], zoom) == aeTile::at(points[i].x, points[i].y, zoom));
+        }
+    }
+
+    std::vector<aePointT<float> > floats(1, aePointT<float>(-0.1276f, 51.5072f));
+    REQUIRE(aeTileIDs(floats, 10)[0] == aeTile(511, 340, 10).morton());
+
+    REQUIRE_THROWS_AS(aeTileIDs(points, 40), aeArgumentError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "catch.hpp"
+#include "aetmerc.hpp"
+#include "aeexcept.hpp"
+#include "aeproj.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("transverse mercator", "[aeTransverseMercator]") {
+    double x, y, lon, lat;
+
+    SECTION("central meridian follows the meridian arc") {
+        aeTransverseMercator tm = aeTransverseMercator::utm(31, true);
+        tm.forward(3.0, 45.0, x, y);
+        REQUIRE(std::abs(x - 500000.0) < 1e-6);
+        REQUIRE(std::abs(y - 4982950.400227) < 1e-4);
+
+        aeTransverseMercator south = aeTransverseMercator::utm(56, false);
+        south.forward(153.0, -33.5, x, y);
+        REQUIRE(std::abs(x - 500000.0) < 1e-6);
+        REQUIRE(std::abs(y - (10000000.0 - 3706719.220504)) < 1e-4);
+    }
+
+    SECTION("Snyder's example on the Clarke 1866 ellipsoid") {
+        double f = 1.0 - std::sqrt(1.0 - 0.00676866);
+        aeTransverseMercator tm(6378206.4, f, -75.0, 0.0, 0.9996);
+        tm.forward(-73.5, 40.5, x, y);
+        REQUIRE(std::abs(x - 127106.5) < 0.1);
+        REQUIRE(std::abs(y - 4484124.4) < 0.1);
+    }
+
+    SECTION("round trip") {
+        aeTransverseMercator tm = aeTransverseMercator::utm(33, true);
+        for (double la = -80.0; la <= 84.0; la += 4.0) {
+            for (double lo = 11.0; lo <= 19.0; lo += 0.5) {
+                tm.forward(lo, la, x, y);
+                tm.inverse(x, y, lon, lat);
+                REQUIRE(std::abs(lon - lo) < 1e-9);
+                REQUIRE(std::abs(lat - la) < 1e-9);
+            }
+        }
+    }
+
+    SECTION("origin") {
+        aeTransverseMercator tm(
+            aeTransverseMercator::wgs84A, aeTransverseMercator::wgs84F,
+            -2.0, 49.0, 0.9996012717, 400000.0, -100000.0
+        );
+        tm.forward(-2.0, 49.0, x, y);
+        REQUIRE(std::abs(x - 400000.0) < 1e-6);
+        REQUIRE(std::abs(y + 100000.0) < 1e-6);
+    }
+
+    SECTION("zones") {
+        REQUIRE(aeTransverseMercator::utmZone(-180.0) == 1);
+        REQUIRE(aeTransverseMercator::utmZone(-0.1275) == 30);
+        REQUIRE(aeTransverseMercator::utmZone(3.0) == 31);
+        REQUIRE(aeTransverseMercator::utmZone(179.9) == 60);
+        REQUIRE(aeTransverseMercator::utmZone(180.0) == 1);
+        REQUIRE_THROWS_AS(aeTransverseMercator::utm(0, true), aeArgumentError);
+        REQUIRE_THROWS_AS(aeTransverseMercator::utm(61, false), aeArgumentError);
+    }
+
+    SECTION("projection") {
+        aeProjection utm(aeUTM(31, true));
+        REQUIRE(int32_t(utm.getWKID()) == 32631);
+
+        aeTransverseMercator tm = aeTransverseMercator::utm(31, true);
+        std::vector<aePoint> points;
+        for (int i = 0; i < 50; ++i) {
+            points.push_back(aePoint(0.5 + 0.1 * i, -40.0 + 2.0 * i));
+        }
+
+        std::vector<aePoint> out(points.size()), back(points.size());
+        utm.project(points.data(), out.data(), points.size());
+        utm.unproject(out.data(), back.data(), out.size());
+
+        for (unsigned int i = 0; i < points.size(); ++i) {
+            tm.forward(points[i].x, points[i].y, x, y);
+            REQUIRE(out[i].x == x);
+            REQUIRE(out[i].y == y);
+            REQUIRE(utm.project(points[i]) == out[i]);
+            REQUIRE(std::abs(back[i].x - points[i].x) < 1e-9);
+            REQUIRE(std::abs(back[i].y - points[i].y) < 1e-9);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//  EOF
+////////////////////////////////////////////////////////////////////////////////